@@ -11,9 +11,13 @@ set(SOURCE_FILES
 	src/content/pooled.hpp
 	src/core/app_info.cpp
 	src/core/app_info.hpp
+	src/core/Benchmark.cpp
+	src/core/Benchmark.hpp
 	src/core/Component.cpp
 	src/core/Component.hpp
 	src/core/ComponentModule.hpp
+	src/core/component_pool.cpp
+	src/core/component_pool.hpp
 	src/core/component_registry.cpp
 	src/core/component_registry.hpp
 	src/core/Engine.cpp
@@ -38,11 +42,19 @@ set(SOURCE_FILES
 	src/graphics/Camera.cpp
 	src/graphics/Camera.hpp
 	src/graphics/Drawable.hpp
+	src/graphics/DynamicResolution.cpp
+	src/graphics/DynamicResolution.hpp
 	src/graphics/Effect.cpp
 	src/graphics/Effect.hpp
 	src/graphics/FrameBuffer.cpp
 	src/graphics/FrameBuffer.hpp
+	src/graphics/gl_dispatch.cpp
+	src/graphics/gl_dispatch.hpp
+	src/graphics/gl_state.cpp
+	src/graphics/gl_state.hpp
 	src/graphics/gl_types.hpp
+	src/graphics/GpuTimer.cpp
+	src/graphics/GpuTimer.hpp
 	src/graphics/ImageEffect.cpp
 	src/graphics/ImageEffect.hpp
 	src/graphics/Light.cpp
@@ -53,15 +65,23 @@ set(SOURCE_FILES
 	src/graphics/Mesh.hpp
 	src/graphics/MeshRenderer.cpp
 	src/graphics/MeshRenderer.hpp
+	src/graphics/OcclusionCuller.cpp
+	src/graphics/OcclusionCuller.hpp
 	src/graphics/RenderBuffer.cpp
 	src/graphics/RenderBuffer.hpp
 	src/graphics/RenderEngine.cpp
 	src/graphics/RenderEngine.hpp
 	src/graphics/Renderer.cpp
 	src/graphics/Renderer.hpp
+	src/graphics/RenderGraph.cpp
+	src/graphics/RenderGraph.hpp
 	src/graphics/RenderState.cpp
 	src/graphics/RenderState.hpp
 	src/graphics/RenderTarget.hpp
+	src/graphics/ShadowAtlas.cpp
+	src/graphics/ShadowAtlas.hpp
+	src/graphics/ShadowMaps.cpp
+	src/graphics/ShadowMaps.hpp
 	src/graphics/SimpleImageEffect.cpp
 	src/graphics/SimpleImageEffect.hpp
 	src/graphics/shader/set_uniform.hpp
@@ -79,13 +99,19 @@ set(SOURCE_FILES
 	src/graphics/texture/pixel_types.hpp
 	src/graphics/texture/RenderTexture.cpp
 	src/graphics/texture/RenderTexture.hpp
+	src/graphics/texture/StreamingPolicy.cpp
+	src/graphics/texture/StreamingPolicy.hpp
 	src/graphics/texture/Texture.hpp
 	src/graphics/texture/Texture2D.cpp
 	src/graphics/texture/Texture2D.hpp
-	src/graphics/texture/texture_unit_manager.cpp
-	src/graphics/texture/texture_unit_manager.hpp
+	src/graphics/texture/texture_residency.cpp
+	src/graphics/texture/texture_residency.hpp
+	src/graphics/texture/texture_streaming.cpp
+	src/graphics/texture/texture_streaming.hpp
 	src/input/Input.cpp
 	src/input/Input.hpp
+	src/input/input_log.cpp
+	src/input/input_log.hpp
 	src/input/keys.cpp
 	src/input/keys.hpp
 	src/scripting/Behaviour.cpp
@@ -96,6 +122,12 @@ set(SOURCE_FILES
 	src/scripting/Environment.hpp
 	src/scripting/json_to_lua.cpp
 	src/scripting/json_to_lua.hpp
+	src/scripting/lua_allocator.cpp
+	src/scripting/lua_allocator.hpp
+	src/scripting/math_types.cpp
+	src/scripting/math_types.hpp
+	src/scripting/script_profiler.cpp
+	src/scripting/script_profiler.hpp
 	src/scripting/utility.cpp
 	src/scripting/utility.hpp
 	src/util/bounds.hpp
@@ -107,10 +139,17 @@ set(SOURCE_FILES
 	src/util/json_utils.cpp
 	src/util/json_utils.hpp
 	src/util/logging.hpp
+	src/util/parallel.hpp
+	src/util/profiler.cpp
+	src/util/profiler.hpp
+	src/util/projection.cpp
+	src/util/projection.hpp
 	src/util/property_interpreter.hpp
 	src/util/random.cpp
 	src/util/random.hpp
 	src/util/singleton.hpp
+	src/util/sort_depth.cpp
+	src/util/sort_depth.hpp
 )
 
 set(CMAKE_FILES
@@ -399,6 +438,8 @@ set(MODEL_FILES
 source_group("Model Files" FILES ${MODEL_FILES})
 
 set(SCRIPT_FILES
+	content/scripts/BehaviourBenchmark.lua
+	content/scripts/BehaviourDispatch.lua
 	content/scripts/BounceInBox.lua
 	content/scripts/DayNightController.lua
 	content/scripts/DebugControls.lua
@@ -410,9 +451,9 @@ set(SCRIPT_FILES
 	content/scripts/xmath/aabb.lua
 	content/scripts/xmath/color.lua
 	content/scripts/xmath/init.lua
+	content/scripts/xmath/mat4.lua
 	content/scripts/xmath/quat.lua
 	content/scripts/xmath/random.lua
-	content/scripts/xmath/struct.lua
 	content/scripts/xmath/vec2.lua
 	content/scripts/xmath/vec3.lua
 	content/scripts/xmath/vec4.lua
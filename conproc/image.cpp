@@ -3,6 +3,8 @@
 
 #include <set>
 #include <functional>
+#include <algorithm>
+#include <cmath>
 
 #include "tiffio.h"
 
@@ -21,6 +23,19 @@
 #include "rbt.hpp"
 #include "keyword_helper.hpp"
 
+template<typename T>
+T find_json_value(const nlohmann::json& json, const std::string& key, const T& def)
+{
+	auto it = json.find(key);
+	if (it != json.end()) {
+		try {
+			return it->get<T>();
+		} catch (std::domain_error&) { }
+	}
+
+	return def;
+}
+
 image_processor::image_processor(const conproc* parent) : processor(parent), m_width(0), m_height(0), m_compressed(false), m_comprFlags(0),
 	m_inputSuccess(false), m_convertSuccess(false), m_outputSuccess(false) { }
 
@@ -47,13 +62,15 @@ void image_processor::process_impl(const fs::path& file, const nlohmann::json& o
 		parseFormat(*fit, m_compressed, m_comprFlags);
 	}
 
+	bool mipmaps = find_json_value(options, "mipmaps", true);
+	bool linear = find_json_value(options, "linear", false);
+
 	if (m_compressed) {
 		debug_output() << "compressing image..." << std::endl;
-		convertCompressed(m_comprFlags);
 	} else {
 		debug_output() << "converting image to PNG..." << std::endl;
-		convertUncompressed();
 	}
+	convertLevels(mipmaps, linear);
 
 	if (!m_convertSuccess) {
 		debug_output() << "...failed!" << std::endl;
@@ -134,7 +151,83 @@ void image_processor::parseFormat(const std::string& fmtStr, bool& isCompressed,
 	isCompressed = comprFlags != 0;
 }
 
-void image_processor::convertCompressed(int flags)
+namespace
+{
+	float srgb_to_linear(unsigned char c)
+	{
+		float v = c / 255.0f;
+		return (v <= 0.04045f) ? (v / 12.92f) : std::pow((v + 0.055f) / 1.055f, 2.4f);
+	}
+
+	unsigned char linear_to_srgb(float v)
+	{
+		v = (v <= 0.0031308f) ? (v * 12.92f) : (1.055f * std::pow(v, 1.0f / 2.4f) - 0.055f);
+		return static_cast<unsigned char>(std::min(std::max(v, 0.0f), 1.0f) * 255.0f + 0.5f);
+	}
+
+	// halves an RGBA8 image with a box filter (odd edges repeat the last row/column)
+	// sRGB colors are averaged in linear space, alpha is always linear
+	std::vector<unsigned char> downsample(const std::vector<unsigned char>& src, unsigned int w, unsigned int h, bool linear)
+	{
+		unsigned int dw = std::max(w / 2, 1u), dh = std::max(h / 2, 1u);
+		std::vector<unsigned char> dst(std::size_t(dw) * dh * 4);
+
+		for (unsigned int y = 0; y < dh; ++y) {
+			unsigned int y0 = std::min(y * 2, h - 1), y1 = std::min(y * 2 + 1, h - 1);
+
+			for (unsigned int x = 0; x < dw; ++x) {
+				unsigned int x0 = std::min(x * 2, w - 1), x1 = std::min(x * 2 + 1, w - 1);
+
+				const unsigned char* texels[4] = {
+					&src[(std::size_t(y0) * w + x0) * 4], &src[(std::size_t(y0) * w + x1) * 4],
+					&src[(std::size_t(y1) * w + x0) * 4], &src[(std::size_t(y1) * w + x1) * 4]
+				};
+
+				unsigned char* out = &dst[(std::size_t(y) * dw + x) * 4];
+				for (unsigned int c = 0; c < 4; ++c) {
+					if (linear || c == 3) {
+						unsigned int sum = texels[0][c] + texels[1][c] + texels[2][c] + texels[3][c];
+						out[c] = static_cast<unsigned char>((sum + 2) / 4);
+					} else {
+						float sum = srgb_to_linear(texels[0][c]) + srgb_to_linear(texels[1][c]) + srgb_to_linear(texels[2][c]) + srgb_to_linear(texels[3][c]);
+						out[c] = linear_to_srgb(sum * 0.25f);
+					}
+				}
+			}
+		}
+
+		return dst;
+	}
+}
+
+void image_processor::convertLevels(bool mipmaps, bool linear)
+{
+	// the whole mip chain is stored, so the engine can load single levels (see texture streaming)
+	m_outputLevels.clear();
+	m_convertSuccess = true;
+
+	std::vector<unsigned char> pixels = m_inputData;
+	unsigned int w = m_width, h = m_height;
+
+	while (m_convertSuccess) {
+		m_outputLevels.emplace_back();
+
+		if (m_compressed) {
+			convertCompressed(pixels, w, h, m_comprFlags, m_outputLevels.back());
+		} else {
+			convertUncompressed(pixels, w, h, m_outputLevels.back());
+		}
+
+		if (!mipmaps || (w == 1 && h == 1))
+			break;
+
+		pixels = downsample(pixels, w, h, linear);
+		w = std::max(w / 2, 1u);
+		h = std::max(h / 2, 1u);
+	}
+}
+
+void image_processor::convertCompressed(const std::vector<unsigned char>& pixels, unsigned int w, unsigned int h, int flags, std::vector<unsigned char>& output)
 {
 #if defined(_DEBUG)
 	int comprFlags = flags | squish::kColourRangeFit;
@@ -142,21 +235,21 @@ void image_processor::convertCompressed(int flags)
 	int comprFlags = flags | squish::kColourClusterFit;
 #endif
 
-	int size = squish::GetStorageRequirements(m_width, m_height, flags);
-	m_outputData.resize(size);
-	squish::CompressImage(m_inputData.data(), m_width, m_height, m_outputData.data(), comprFlags);
-	m_convertSuccess = true;
+	int size = squish::GetStorageRequirements(w, h, flags);
+	output.resize(size);
+	squish::CompressImage(pixels.data(), w, h, output.data(), comprFlags);
 }
 
-void image_processor::convertUncompressed()
+void image_processor::convertUncompressed(const std::vector<unsigned char>& pixels, unsigned int w, unsigned int h, std::vector<unsigned char>& output)
 {
 	int len;
-	unsigned char *png = stbi_write_png_to_mem(m_inputData.data(), 0, m_width, m_height, 4, &len);
+	unsigned char *png = stbi_write_png_to_mem(pixels.data(), 0, w, h, 4, &len);
 	if (png) {
-		m_outputData.resize(len);
-		std::copy(png, png + len, m_outputData.begin());
+		output.resize(len);
+		std::copy(png, png + len, output.begin());
 		STBIW_FREE(png);
-		m_convertSuccess = true;
+	} else {
+		m_convertSuccess = false;
 	}
 }
 
@@ -177,19 +270,6 @@ namespace
 	};
 }
 
-template<typename T>
-T find_json_value(const nlohmann::json& json, const std::string& key, const T& def)
-{
-	auto it = json.find(key);
-	if (it != json.end()) {
-		try {
-			return it->get<T>();
-		} catch (std::domain_error&) { }
-	}
-
-	return def;
-}
-
 void image_processor::writeFile(const fs::path& file, const nlohmann::json& options)
 {
 	fs::ofstream output(file, std::ios::binary | std::ios::out | std::ios::trunc);
@@ -231,14 +311,24 @@ void image_processor::writeFile(const fs::path& file, const nlohmann::json& opti
 		header.params.wrap = wrap_repeat;
 		g_wraps.findKeyword(options, "wrap", header.params.wrap);
 
+		header.levels = unsigned int(m_outputLevels.size());
+
 		std::size_t headerSize = sizeof(header);
-		std::size_t dataSize = m_outputData.size();
+		std::size_t dataSize = 0;
+		for (const auto& level : m_outputLevels) {
+			dataSize += sizeof(std::size_t) + level.size();
+		}
 
 		output.write(reinterpret_cast<char*>(&headerSize), sizeof(headerSize));
 		output.write(reinterpret_cast<char*>(&dataSize), sizeof(dataSize));
 
 		output.write(reinterpret_cast<char*>(&header), headerSize);
-		output.write(reinterpret_cast<char*>(m_outputData.data()), dataSize);
+
+		for (const auto& level : m_outputLevels) {
+			std::size_t levelSize = level.size();
+			output.write(reinterpret_cast<char*>(&levelSize), sizeof(levelSize));
+			output.write(reinterpret_cast<const char*>(level.data()), levelSize);
+		}
 
 		m_outputSuccess = true;
 	}
@@ -12,7 +12,9 @@ protected:
 	virtual void process_impl(const fs::path& file, const nlohmann::json& options) override;
 
 private:
-	std::vector<unsigned char> m_inputData, m_outputData;
+	std::vector<unsigned char> m_inputData;
+	// one entry per mip level, finest first
+	std::vector<std::vector<unsigned char>> m_outputLevels;
 
 	unsigned int m_width, m_height;
 	bool m_compressed;
@@ -25,8 +27,9 @@ private:
 
 	void parseFormat(const std::string& fmtStr, bool& isCompressed, int& comprFlags);
 
-	void convertCompressed(int flags);
-	void convertUncompressed();
+	void convertLevels(bool mipmaps, bool linear);
+	void convertCompressed(const std::vector<unsigned char>& pixels, unsigned int w, unsigned int h, int flags, std::vector<unsigned char>& output);
+	void convertUncompressed(const std::vector<unsigned char>& pixels, unsigned int w, unsigned int h, std::vector<unsigned char>& output);
 
 	void writeFile(const fs::path& file, const nlohmann::json& options);
 };
@@ -1,5 +1,6 @@
 #include "mesh.hpp"
 #include "conproc.hpp"
+#include "uv_density.hpp"
 
 #include "boost/format.hpp"
 
@@ -175,12 +176,6 @@ void mesh_processor::process_mesh(const processed_mesh& mesh)
 				uvData = uvs.data();
 			}
 
-			unsigned char compMask = 0x00u;
-			if (vertexData) compMask |= 0x80u;
-			if (normalData) compMask |= 0x40u;
-			if (tangentData) compMask |= 0x20u;
-			if (uvData) compMask |= 0x10u;
-
 			std::vector<unsigned int> indices;
 			for (unsigned int f = 0; f < subMesh->mNumFaces; ++f) {
 				auto& face = subMesh->mFaces[f];
@@ -191,13 +186,28 @@ void mesh_processor::process_mesh(const processed_mesh& mesh)
 			unsigned int indexCount = unsigned int(indices.size());
 			auto indexData = indices.data();
 
-			debug_output() << "  submesh " << sm << ": " << vertexCount << " vertices, " << indexCount << " indices" << std::endl;
+			// used by the engine to estimate which mip levels of the textures are visible
+			float uvDensity = 0.0f;
+			if (vertexData && uvData) {
+				uvDensity = compute_uv_density(vertexData, uvData, indexData, indexCount);
+			}
+
+			unsigned char compMask = 0x00u;
+			if (vertexData) compMask |= 0x80u;
+			if (normalData) compMask |= 0x40u;
+			if (tangentData) compMask |= 0x20u;
+			if (uvData) compMask |= 0x10u;
+			if (uvDensity > 0.0f) compMask |= 0x08u;
+
+			debug_output() << "  submesh " << sm << ": " << vertexCount << " vertices, " << indexCount << " indices, uv density " << uvDensity << std::endl;
 
 			output.write(reinterpret_cast<char*>(&vertexCount), sizeof(vertexCount));
 			output.write(reinterpret_cast<char*>(&indexCount), sizeof(indexCount));
 
 			output.write(reinterpret_cast<char*>(&compMask), sizeof(compMask));
 
+			if (uvDensity > 0.0f) output.write(reinterpret_cast<char*>(&uvDensity), sizeof(uvDensity));
+
 			if (vertexData) output.write(reinterpret_cast<char*>(vertexData), sizeof(vertexData[0]) * vertexCount);
 			if (normalData) output.write(reinterpret_cast<char*>(normalData), sizeof(normalData[0]) * vertexCount);
 			if (tangentData) output.write(reinterpret_cast<char*>(tangentData), sizeof(tangentData[0]) * vertexCount);
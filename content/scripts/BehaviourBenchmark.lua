@@ -0,0 +1,51 @@
+-- Measures the per-frame overhead of many trivial behaviours.
+-- Attach to any entity, then press F3 to spawn behaviourCount entities
+-- (each with an instance of this script doing next to nothing) and measure.
+
+BehaviourBenchmark = Behaviour:new{
+    behaviourCount = 10000,
+    testDuration = 5,
+    spawner = true
+}
+
+function BehaviourBenchmark:init()
+    self.ticks = 0
+    self.testing = false
+    self.entities = { }
+end
+
+function BehaviourBenchmark:update()
+    if not self.spawner then
+        self.ticks = self.ticks + 1
+        return
+    end
+
+    if self.testing then
+        self.accFrameTime = self.accFrameTime + Engine.frameTime()
+        self.testSamples = self.testSamples + 1
+
+        if Engine.time() >= self.testTimer then
+            local avgFrameTime = self.accFrameTime / self.testSamples
+            print(string.format("%u behaviours: %f ms", #self.entities, avgFrameTime * 1000))
+            self.testing = false
+        end
+    end
+
+    if Input.getKeyPressed("f3") then
+        self:startTest()
+    end
+end
+
+function BehaviourBenchmark:startTest()
+    for i = #self.entities + 1, self.behaviourCount do
+        local entity = Entity.create("behaviour_benchmark")
+        local b = entity:addBehaviour("BehaviourBenchmark")
+        b.spawner = false
+        table.insert(self.entities, entity)
+    end
+
+    self.testing = true
+    self.testTimer = Engine.time() + self.testDuration
+    self.testSamples = 0
+    self.accFrameTime = 0
+end
@@ -0,0 +1,100 @@
+-- Calls the update methods of all behaviours in a single loop,
+-- so the engine only has to call into lua once per frame.
+
+BehaviourDispatch = { }
+
+local objects = { }   -- behaviour objects (false if removed)
+local updates = { }   -- cached update functions
+local scripts = { }   -- script names (used for profiling)
+local active = { }    -- whether the behaviour is active and enabled
+local slots = { }     -- behaviour object -> array index
+local count = 0
+local dirty = false
+
+local function compact()
+    local n = 0
+    for i = 1, count do
+        local obj = objects[i]
+        if obj then
+            n = n + 1
+            objects[n] = obj
+            updates[n] = updates[i]
+            scripts[n] = scripts[i]
+            active[n] = active[i]
+            slots[obj] = n
+        end
+    end
+
+    for i = n + 1, count do
+        objects[i] = nil
+        updates[i] = nil
+        scripts[i] = nil
+        active[i] = nil
+    end
+
+    count = n
+    dirty = false
+end
+
+function BehaviourDispatch.add(obj, update, script)
+    if slots[obj] then return end
+
+    count = count + 1
+    objects[count] = obj
+    updates[count] = update
+    scripts[count] = script
+    active[count] = false
+    slots[obj] = count
+end
+
+function BehaviourDispatch.remove(obj)
+    local i = slots[obj]
+    if i then
+        -- only mark as removed, since this might happen while updates are being dispatched
+        slots[obj] = nil
+        objects[i] = false
+        active[i] = false
+        dirty = true
+    end
+end
+
+function BehaviourDispatch.setActive(obj, val)
+    local i = slots[obj]
+    if i then
+        active[i] = val
+    end
+end
+
+function BehaviourDispatch.count()
+    return count
+end
+
+-- clock and record are only passed in while the script profiler is enabled
+function BehaviourDispatch.update(handler, clock, record)
+    if dirty then
+        compact()
+    end
+
+    if clock then
+        for i = 1, count do
+            if active[i] then
+                local t = clock()
+                local ok, err = xpcall(updates[i], handler, objects[i])
+                record(scripts[i], "update", clock() - t)
+                if not ok then
+                    print("ERROR: "..tostring(err))
+                end
+            end
+        end
+        return
+    end
+
+    for i = 1, count do
+        if active[i] then
+            local ok, err = xpcall(updates[i], handler, objects[i])
+            if not ok then
+                print("ERROR: "..tostring(err))
+            end
+        end
+    end
+end
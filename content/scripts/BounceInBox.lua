@@ -8,12 +8,14 @@ BounceInBox = Behaviour:new{
 
 function BounceInBox:init()
     self.transform = self:entity():transform()
+    self.position = vec3.zero()
 end
 
 function BounceInBox:update()
-    local pos = self.transform:position()
+    -- reuse the same vector every frame instead of creating new ones
+    local pos = self.transform:position(self.position)
 
-    pos = pos + (self.velocity * Engine.frameTime())
+    pos:addScaled(self.velocity, Engine.frameTime())
 
     for i = 1, 3 do
         if (pos[i] < self.area.min[i]) or (pos[i] > self.area.max[i]) then
@@ -16,6 +16,32 @@ function DebugControls:update()
 
     if Input.getKeyPressed("t") then
         print("Triangle count: "..Graphics.triangleCount())
+        print(string.format("Draw calls: %d (depth pre-pass: %d)", Graphics.drawCount(), Graphics.prepassDrawCount()))
+        print(string.format("GL state calls: %d issued, %d skipped", Graphics.stateCallsIssued(), Graphics.stateCallsSkipped()))
+        print(string.format("Texture binds: %d, handle updates: %d, resident textures: %d",
+            Graphics.textureBinds(), Graphics.textureHandleUpdates(), Graphics.residentTextures()))
+        print(string.format("Texture streaming: %d textures, %.1f / %.1f MB (requested %.1f MB), %d loads pending",
+            Graphics.streamedTextures(), Graphics.streamedTextureMemory() / 1048576, Graphics.textureStreamingBudget() / 1048576,
+            Graphics.requestedTextureMemory() / 1048576, Graphics.pendingTextureLoads()))
+        print("Light pixels saved by scissor: "..Graphics.lightPixelsSaved())
+        print(string.format("Occlusion culling: %d occluders, %d objects culled, %.3f ms",
+            Graphics.occluderCount(), Graphics.occlusionCulledCount(), Graphics.occlusionCullingTime()))
+        print(string.format("Shadow views: %d, re-rendered: %d", Graphics.shadowViewCount(), Graphics.shadowViewsRendered()))
+        print(string.format("Render targets: %.1f MB peak, %.1f MB pooled, %d passes culled",
+            Graphics.renderTargetMemory() / 1048576, Graphics.renderTargetPoolMemory() / 1048576, Graphics.culledPassCount()))
+        print(string.format("Resolution: %dx%d (scale %.2f), CPU %.2f ms, GPU %.2f ms",
+            Graphics.renderWidth(), Graphics.renderHeight(), Graphics.resolutionScale(), Graphics.cpuFrameTime(), Graphics.gpuFrameTime()))
+        print(string.format("Forward lights per object: %.2f, passes saved: %d", Graphics.avgLightsPerObj(), Graphics.fwdLightPassesSaved()))
+    end
+
+    if Input.getKeyPressed("k") then
+        print(string.format("Lua memory: %.1f KB (peak %.1f KB), %d allocations / %d frees last frame, GC %.3f ms",
+            Scripting.memoryUsage() / 1024, Scripting.peakMemoryUsage() / 1024,
+            Scripting.frameAllocations(), Scripting.frameFrees(), Scripting.gcTime()))
+    end
+
+    if Input.getKeyPressed("j") then
+        Profiler.printStats()
     end
 
     if Input.getKeyPressed("p") then
@@ -24,12 +50,42 @@ function DebugControls:update()
         print("Rendering path: "..(d and "Deferred" or "Forward"))
     end
 
+    if Input.getKeyPressed("y") then
+        local tl = not Graphics.isTiledLightingEnabled()
+        Graphics.setTiledLightingEnabled(tl)
+        print("Tiled deferred lighting "..getEnabledStatus(tl))
+    end
+
+    if Input.getKeyPressed("u") then
+        local li = not Graphics.isLightInstancingEnabled()
+        Graphics.setLightInstancingEnabled(li)
+        print("Light instancing "..getEnabledStatus(li))
+    end
+
     if Input.getKeyPressed("o") then
         local vfc = not Graphics.isVFCEnabled()
         Graphics.setVFCEnabled(vfc)
         print("View frustum culling "..getEnabledStatus(vfc))
     end
 
+    if Input.getKeyPressed("z") then
+        local dp = not Graphics.isDepthPrepassEnabled()
+        Graphics.setDepthPrepassEnabled(dp)
+        print("Forward depth pre-pass "..getEnabledStatus(dp))
+    end
+
+    if Input.getKeyPressed("x") then
+        local dr = not Graphics.isDynamicResolutionEnabled()
+        Graphics.setDynamicResolutionEnabled(dr)
+        print("Dynamic resolution "..getEnabledStatus(dr))
+    end
+
+    if Input.getKeyPressed("c") then
+        local oc = not Graphics.isOcclusionCullingEnabled()
+        Graphics.setOcclusionCullingEnabled(oc)
+        print("Occlusion culling "..getEnabledStatus(oc))
+    end
+
     if Input.getKeyPressed("g") then
         local om = Graphics.outputMode()
         -- TODO: expose enums to lua
@@ -15,6 +15,8 @@ function FlyCamera:init()
     self.angleX = math.rad(self.angleX)
     self.angleY = math.rad(self.angleY)
 
+    self.position = vec3.zero()
+
     self:updateRotation()
 end
 
@@ -48,8 +50,8 @@ function FlyCamera:update()
         local speed = Input.getKey("leftShift") and self.fastSpeed or self.normalSpeed
         local dir = quat.rotate(rot, vec3.new(x, 0, z))
 
-        local pos = self.transform:position()
-        pos = pos + dir * speed * Engine.frameTime()
+        local pos = self.transform:position(self.position)
+        pos:addScaled(dir, speed * Engine.frameTime())
         self.transform:setPosition(pos)
     end
 end
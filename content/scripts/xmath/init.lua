@@ -1,7 +1,8 @@
 local xmath = {
     aabb = require("xmath.aabb"),
     color = require("xmath.color"),
-    quat = require("xmath.quat")
+    mat4 = require("xmath.mat4"),
+    quat = require("xmath.quat"),
     random = require("xmath.random"),
     vec2 = require("xmath.vec2"),
     vec3 = require("xmath.vec3"),
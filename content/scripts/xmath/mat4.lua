@@ -0,0 +1,2 @@
+-- mat4 is implemented natively over glm (see src/scripting/math_types.cpp)
+return require("xmath.native").mat4
\ No newline at end of file
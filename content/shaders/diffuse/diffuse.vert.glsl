@@ -8,6 +8,9 @@
 
 out vertex_output v_output;
 
+// see common/vertex_transform.glh
+invariant gl_Position;
+
 void main()
 {
 	vec4 pos = vec4(v_input.position, 1.0);
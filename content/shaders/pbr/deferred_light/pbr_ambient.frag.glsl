@@ -4,11 +4,7 @@
 #include "common/lighting.glh"
 #include "pbr/pbr_brdf.glh"
 #include "pbr_ambient_common.glh"
-
-uniform sampler2D gbuf_diffuse;
-uniform sampler2D gbuf_specSmooth;
-uniform sampler2D gbuf_normal;
-uniform sampler2D gbuf_depth;
+#include "pbr/pbr_gbuf_read.glh"
 
 uniform mat4 cm_mat_ivp;
 uniform vec3 cm_cam_pos;
@@ -20,10 +16,8 @@ layout(location = 0) out vec4 f_output;
 void main()
 {
 	// read from G-Buffer
-	vec3 diffCol = texture(gbuf_diffuse, v_output.uv).rgb;
-	//vec4 specSmooth = texture(gbuf_specSmooth, v_output.uv);
-	//vec3 normal = texture(gbuf_normal, v_output.uv).rgb * 2.0 - 1.0;
-	float depth = texture(gbuf_depth, v_output.uv).r;
+	vec3 diffCol = pbr_get_gbuffer_diffuse(v_output.uv);
+	float depth = pbr_get_gbuffer_depth(v_output.uv);
 
 	// calculate fragment world position with inverse view+projection matrix
 	//vec4 wp = cm_mat_ivp * vec4(v_output.pos, depth * 2.0 - 1.0, 1.0);
@@ -4,6 +4,7 @@
 #include "common/lighting.glh"
 #include "pbr/pbr_brdf.glh"
 #include "pbr_ambient_common.glh"
+#include "pbr/pbr_gbuf_read.glh"
 
 #define MODE_DIFFUSE 1
 #define MODE_SPECULAR 2
@@ -11,10 +12,6 @@
 #define MODE_NORMAL 4
 #define MODE_DEPTH 5
 
-uniform sampler2D gbuf_diffuse;
-uniform sampler2D gbuf_specSmooth;
-uniform sampler2D gbuf_normal;
-uniform sampler2D gbuf_depth;
 
 uniform int mode;
 uniform float nearPlane;
@@ -33,16 +30,21 @@ void main()
 {
 	vec3 color = vec3(1, 0, 1);
 
+	// decoded the same way as in the light passes, whatever the layout
+	vec3 diffCol, specCol, normal;
+	float smoothness;
+	pbr_get_gbuffer(v_output.uv, diffCol, specCol, smoothness, normal);
+
 	if (mode == MODE_DIFFUSE) {
-		color = texture(gbuf_diffuse, v_output.uv).rgb;
+		color = diffCol;
 	} else if (mode == MODE_SPECULAR) {
-		color = texture(gbuf_specSmooth, v_output.uv).rgb;
+		color = specCol;
 	} else if (mode == MODE_SMOOTHNESS) {
-		color = texture(gbuf_specSmooth, v_output.uv).aaa;
+		color = vec3(smoothness);
 	} else if (mode == MODE_NORMAL) {
-		color = texture(gbuf_normal, v_output.uv).rgb;
+		color = normal * 0.5 + 0.5;
 	} else if (mode == MODE_DEPTH) {
-		float d = linearize_depth(texture(gbuf_depth, v_output.uv).r);
+		float d = linearize_depth(pbr_get_gbuffer_depth(v_output.uv));
 		color = vec3(d);
 	}
 
@@ -2,13 +2,10 @@
 #pragma type fragment
 
 #include "common/lighting.glh"
+#include "common/shadow.glh"
 #include "pbr/pbr_brdf.glh"
 #include "pbr_light_common.glh"
-
-uniform sampler2D gbuf_diffuse;
-uniform sampler2D gbuf_specSmooth;
-uniform sampler2D gbuf_normal;
-uniform sampler2D gbuf_depth;
+#include "pbr/pbr_gbuf_read.glh"
 
 uniform mat4 cm_mat_ivp;
 uniform vec3 cm_cam_pos;
@@ -20,10 +17,10 @@ layout(location = 0) out vec4 f_output;
 void main()
 {
 	// read from G-Buffer
-	vec3 diffCol = texture(gbuf_diffuse, v_output.uv).rgb;
-	vec4 specSmooth = texture(gbuf_specSmooth, v_output.uv);
-	vec3 normal = texture(gbuf_normal, v_output.uv).rgb * 2.0 - 1.0;
-	float depth = texture(gbuf_depth, v_output.uv).r;
+	vec3 diffCol, specCol, normal;
+	float smoothness;
+	pbr_get_gbuffer(v_output.uv, diffCol, specCol, smoothness, normal);
+	float depth = pbr_get_gbuffer_depth(v_output.uv);
 
 	// calculate fragment world position with inverse view+projection matrix
 	vec4 wp = cm_mat_ivp * vec4(v_output.pos, depth * 2.0 - 1.0, 1.0);
@@ -34,10 +31,10 @@ void main()
 	vec3 l = normalize(lightVec);
 	vec3 v = normalize(cm_cam_pos - worldPos);
 
-	vec3 lightColor = light_color_auto(lightVec);
+	vec3 lightColor = light_color_auto(lightVec) * shadow_attenuation(worldPos, cm_cam_pos);
 
 	// apply BRDF
-	vec3 color = pbr_brdf(diffCol, specSmooth.rgb, lightColor, specSmooth.a, normal, v, l);
+	vec3 color = pbr_brdf(diffCol, specCol, lightColor, smoothness, normal, v, l);
 
 	f_output = vec4(color, 1.0);
 }
\ No newline at end of file
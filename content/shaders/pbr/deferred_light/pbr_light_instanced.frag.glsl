@@ -0,0 +1,40 @@
+#version 330
+#pragma type fragment
+
+#include "common/light_data.glh"
+#include "pbr/pbr_brdf.glh"
+#include "pbr_light_common.glh"
+#include "pbr/pbr_gbuf_read.glh"
+
+uniform mat4 cm_mat_ivp;
+uniform vec3 cm_cam_pos;
+
+in vertex_output v_output;
+flat in light_data v_light;
+
+layout(location = 0) out vec4 f_output;
+
+void main()
+{
+	// read from G-Buffer
+	vec3 diffCol, specCol, normal;
+	float smoothness;
+	pbr_get_gbuffer(v_output.uv, diffCol, specCol, smoothness, normal);
+	float depth = pbr_get_gbuffer_depth(v_output.uv);
+
+	// calculate fragment world position with inverse view+projection matrix
+	vec4 wp = cm_mat_ivp * vec4(v_output.pos, depth * 2.0 - 1.0, 1.0);
+	vec3 worldPos = wp.xyz / wp.w;
+
+	// get light and view vectors
+	vec3 lightVec = light_vec(v_light, worldPos);
+	vec3 l = normalize(lightVec);
+	vec3 v = normalize(cm_cam_pos - worldPos);
+
+	vec3 lightColor = light_color(v_light, lightVec);
+
+	// apply BRDF
+	vec3 color = pbr_brdf(diffCol, specCol, lightColor, smoothness, normal, v, l);
+
+	f_output = vec4(color, 1.0);
+}
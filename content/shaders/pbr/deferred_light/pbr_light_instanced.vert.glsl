@@ -0,0 +1,30 @@
+#version 330
+#pragma type vertex
+
+#include "pbr_light_common.glh"
+#include "common/light_data.glh"
+
+layout(location = 0) in vec3 inPos;
+
+// per instance (see RenderEngine::light_instance)
+layout(location = 1) in mat4 inTransform;
+layout(location = 5) in vec4 inLightColor;
+layout(location = 6) in vec4 inLightDir;
+layout(location = 7) in vec4 inLightSpot;
+layout(location = 8) in vec4 inLightAtten;
+
+out vertex_output v_output;
+flat out light_data v_light;
+
+void main()
+{
+	vec4 pos = inTransform * vec4(inPos, 1.0);
+	pos /= pos.w;
+
+	v_output.pos = pos.xy;
+	v_output.uv = (v_output.pos + 1.0) * 0.5;
+
+	v_light = light_data(inLightColor, inLightDir, inLightSpot, inLightAtten);
+
+	gl_Position = pos;
+}
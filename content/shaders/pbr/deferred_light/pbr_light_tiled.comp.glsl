@@ -0,0 +1,118 @@
+#version 430
+#pragma type compute
+
+#include "common/light_buffer.glh"
+#include "pbr/pbr_brdf.glh"
+#include "pbr/pbr_gbuf_read.glh"
+
+// LIGHT_TILE_SIZE is defined by the engine
+#ifndef LIGHT_TILE_SIZE
+#define LIGHT_TILE_SIZE 16
+#endif
+
+#define MAX_TILE_LIGHTS 256
+
+layout(local_size_x = LIGHT_TILE_SIZE, local_size_y = LIGHT_TILE_SIZE) in;
+
+// contains the ambient light, the lights are added to it
+layout(binding = 0, rgba16f) uniform image2D accBuffer;
+
+uniform mat4 cm_mat_ivp;
+uniform vec3 cm_cam_pos;
+
+// part of the accumulation buffer the scene covers (dynamic resolution)
+uniform ivec2 renderSize;
+
+shared uint tileMinDepth;
+shared uint tileMaxDepth;
+shared uint tileLightCount;
+shared uint tileLights[MAX_TILE_LIGHTS];
+
+vec3 world_pos(vec2 ndc, float depth)
+{
+	vec4 wp = cm_mat_ivp * vec4(ndc, depth * 2.0 - 1.0, 1.0);
+	return wp.xyz / wp.w;
+}
+
+void main()
+{
+	ivec2 size = renderSize;
+	ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+	bool inside = all(lessThan(pixel, size));
+
+	vec2 uv = (vec2(pixel) + 0.5) / vec2(size);
+	float depth = inside ? pbr_get_gbuffer_depth(uv) : 1.0;
+	bool background = depth >= 1.0;
+
+	if (gl_LocalInvocationIndex == 0u) {
+		tileMinDepth = 0xFFFFFFFFu;
+		tileMaxDepth = 0u;
+		tileLightCount = 0u;
+	}
+
+	barrier();
+
+	// depth bounds of the tile (depth is never negative, so the bit patterns sort like the values)
+	if (!background) {
+		atomicMin(tileMinDepth, floatBitsToUint(depth));
+		atomicMax(tileMaxDepth, floatBitsToUint(depth));
+	}
+
+	barrier();
+
+	// nothing but background (same for the whole work group)
+	if (tileMinDepth > tileMaxDepth)
+		return;
+
+	float minDepth = uintBitsToFloat(tileMinDepth);
+	float maxDepth = uintBitsToFloat(tileMaxDepth);
+
+	// world space box around the part of the tile frustum between the depth bounds
+	vec2 tileMin = vec2(gl_WorkGroupID.xy * uint(LIGHT_TILE_SIZE)) / vec2(size) * 2.0 - 1.0;
+	vec2 tileMax = vec2((gl_WorkGroupID.xy + 1u) * uint(LIGHT_TILE_SIZE)) / vec2(size) * 2.0 - 1.0;
+
+	vec3 boundsMin = vec3(1e30);
+	vec3 boundsMax = vec3(-1e30);
+	for (int i = 0; i < 8; ++i) {
+		vec2 ndc = vec2(((i & 1) != 0) ? tileMax.x : tileMin.x, ((i & 2) != 0) ? tileMax.y : tileMin.y);
+		vec3 corner = world_pos(ndc, ((i & 4) != 0) ? maxDepth : minDepth);
+		boundsMin = min(boundsMin, corner);
+		boundsMax = max(boundsMax, corner);
+	}
+
+	// build the light list of the tile, every invocation tests a share of the lights
+	for (uint i = gl_LocalInvocationIndex; i < lightCount; i += uint(LIGHT_TILE_SIZE * LIGHT_TILE_SIZE)) {
+		if (light_in_bounds(lights[i], boundsMin, boundsMax)) {
+			uint index = atomicAdd(tileLightCount, 1u);
+			if (index < uint(MAX_TILE_LIGHTS))
+				tileLights[index] = i;
+		}
+	}
+
+	barrier();
+
+	if (!inside || background)
+		return;
+
+	// read from G-Buffer
+	vec3 diffCol, specCol, normal;
+	float smoothness;
+	pbr_get_gbuffer(uv, diffCol, specCol, smoothness, normal);
+
+	vec3 worldPos = world_pos(uv * 2.0 - 1.0, depth);
+	vec3 v = normalize(cm_cam_pos - worldPos);
+
+	vec3 color = vec3(0.0);
+
+	uint count = min(tileLightCount, uint(MAX_TILE_LIGHTS));
+	for (uint i = 0u; i < count; ++i) {
+		light_data light = lights[tileLights[i]];
+
+		vec3 lightVec = light_vec(light, worldPos);
+		vec3 l = normalize(lightVec);
+
+		color += pbr_brdf(diffCol, specCol, light_color(light, lightVec), smoothness, normal, v, l);
+	}
+
+	imageStore(accBuffer, pixel, imageLoad(accBuffer, pixel) + vec4(color, 0.0));
+}
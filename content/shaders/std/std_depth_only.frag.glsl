@@ -0,0 +1,7 @@
+#version 330
+#pragma type fragment
+
+// depth only, the color attachments are masked
+void main()
+{
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+#version 330
+#pragma type fragment
+
+// depth only
+void main()
+{
+}
\ No newline at end of file
@@ -0,0 +1,10 @@
+#version 330
+#pragma type vertex
+
+#include "common/uniforms.glh"
+#include "common/vertex_input.glh"
+
+void main()
+{
+	gl_Position = cm_mat_wvp * vec4(v_input.position, 1.0);
+}
\ No newline at end of file
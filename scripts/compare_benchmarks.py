@@ -0,0 +1,72 @@
+#! python3
+
+# compare_benchmarks.py
+# --------------------------------
+# Compares two benchmark reports (written by running the engine with --benchmark)
+# and flags every metric that got worse by more than the given threshold.
+# Exits with 1 if there are regressions, so it can be used in automated runs.
+#
+# usage: compare_benchmarks.py baseline.json current.json [--threshold 0.05]
+
+import argparse
+import json
+import sys
+
+# statistics that are compared for every metric
+STATS = ["avg", "p50", "p95", "p99"]
+
+# metrics that are compared in addition to the profiler scopes
+METRICS = ["frameTime", "drawCalls", "triangles", "glCalls", "stateCallsIssued", "textureBinds"]
+
+
+def load(filename):
+    with open(filename) as f:
+        return json.load(f)
+
+
+def compare(name, old, new, threshold, results):
+    for stat in STATS:
+        if stat not in old or stat not in new:
+            continue
+
+        a, b = old[stat], new[stat]
+        change = (b - a) / a if a > 0 else 0.0
+        results.append((name, stat, a, b, change, change > threshold))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare two benchmark reports.")
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=0.05,
+                        help="relative increase that counts as a regression (default: 0.05)")
+    parser.add_argument("--all", action="store_true", help="also list metrics that did not regress")
+    args = parser.parse_args()
+
+    old, new = load(args.baseline), load(args.current)
+
+    if old.get("name") != new.get("name"):
+        print("WARNING: comparing different benchmarks (%s, %s)" % (old.get("name"), new.get("name")))
+
+    results = []
+
+    for metric in METRICS:
+        compare(metric, old.get(metric, {}), new.get(metric, {}), args.threshold, results)
+
+    old_scopes, new_scopes = old.get("scopes", {}), new.get("scopes", {})
+    for scope in sorted(set(old_scopes) & set(new_scopes)):
+        compare(scope, old_scopes[scope], new_scopes[scope], args.threshold, results)
+
+    regressions = [r for r in results if r[5]]
+
+    print("%-40s %-4s %12s %12s %9s" % ("metric", "stat", "baseline", "current", "change"))
+    for name, stat, a, b, change, regressed in results:
+        if regressed or args.all:
+            print("%-40s %-4s %12.3f %12.3f %+8.1f%%%s" % (name, stat, a, b, change * 100, "  REGRESSION" if regressed else ""))
+
+    print("\n%d regression(s) above %.1f%%" % (len(regressions), args.threshold * 100))
+    return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
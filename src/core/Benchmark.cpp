@@ -0,0 +1,263 @@
+#include "Benchmark.hpp"
+#include "Entity.hpp"
+#include "Transform.hpp"
+#include "graphics/Camera.hpp"
+#include "graphics/RenderEngine.hpp"
+#include "graphics/gl_dispatch.hpp"
+#include "graphics/gl_state.hpp"
+#include "graphics/texture/texture_residency.hpp"
+#include "graphics/texture/texture_streaming.hpp"
+#include "util/json_utils.hpp"
+#include "util/profiler.hpp"
+
+#include "boost/filesystem/fstream.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+	// nearest rank percentile of sorted values
+	double percentile(const std::vector<double>& sorted, double p)
+	{
+		std::size_t rank = std::size_t(std::ceil(p * sorted.size()));
+		return sorted[std::min(std::max<std::size_t>(rank, 1), sorted.size()) - 1];
+	}
+
+	nlohmann::json summarize(std::vector<double> values)
+	{
+		nlohmann::json result = nlohmann::json::object();
+		if (values.empty())
+			return result;
+
+		std::sort(values.begin(), values.end());
+
+		double sum = 0.0;
+		for (double v : values) {
+			sum += v;
+		}
+
+		result["min"] = values.front();
+		result["avg"] = sum / values.size();
+		result["p50"] = percentile(values, 0.5);
+		result["p95"] = percentile(values, 0.95);
+		result["p99"] = percentile(values, 0.99);
+		result["max"] = values.back();
+		return result;
+	}
+}
+
+Benchmark::Benchmark(const path& definition) : m_good(false), m_timeStep(1.0 / 60.0),
+	m_warmupFrames(60), m_frames(600), m_frame(0), m_loop(false), m_lastGlCallCount(0)
+{
+	boost::filesystem::ifstream file(definition);
+	if (!file) {
+		std::cout << "ERROR: could not open benchmark definition " << definition << std::endl;
+		return;
+	}
+
+	nlohmann::json json;
+	try {
+		json << file;
+	} catch (std::invalid_argument& e) {
+		std::cout << "ERROR: could not parse benchmark definition: \"" << e.what() << "\"" << std::endl;
+		return;
+	}
+
+	m_name = get_value<std::string>(json, "name", definition.stem().string());
+	m_scene = get_value<std::string>(json, "scene", "");
+	m_timeStep = get_value(json, "timeStep", m_timeStep);
+	m_warmupFrames = get_value<unsigned int>(json, "warmupFrames", unsigned(m_warmupFrames));
+	m_frames = get_value<unsigned int>(json, "frames", unsigned(m_frames));
+	m_loop = get_value(json, "loop", m_loop);
+
+	// relative paths are relative to the definition file
+	m_inputLog = get_value<std::string>(json, "inputLog", "");
+	if (!m_inputLog.empty() && m_inputLog.is_relative()) {
+		m_inputLog = definition.parent_path() / m_inputLog;
+	}
+
+	auto it = json.find("cameraPath");
+	if (it != json.end() && it->is_array()) {
+		for (auto& key : *it) {
+			// angles: rotation around the x and y axis in degrees (same as FlyCamera)
+			glm::vec2 angles = glm::radians(get_value(key, "angles", glm::vec2(0.f)));
+
+			m_cameraPath.push_back({
+				get_value(key, "time", 0.0),
+				get_value(key, "position", glm::vec3(0.f)),
+				glm::angleAxis(angles.y, glm::vec3(0.f, 1.f, 0.f)) * glm::angleAxis(angles.x, glm::vec3(1.f, 0.f, 0.f))
+			});
+		}
+
+		std::sort(m_cameraPath.begin(), m_cameraPath.end(), [](const camera_key& a, const camera_key& b) {
+			return a.time < b.time;
+		});
+	}
+
+	m_good = !m_scene.empty() && m_timeStep > 0.0;
+	if (!m_good) {
+		std::cout << "ERROR: benchmark \"" << m_name << "\" needs a scene and a positive time step!" << std::endl;
+	}
+
+	m_frameTimes.reserve(m_frames);
+}
+
+void Benchmark::update(double time)
+{
+	applyCameraPath(time);
+}
+
+void Benchmark::applyCameraPath(double time)
+{
+	Camera* camera = Camera::main();
+	if (m_cameraPath.empty() || !camera)
+		return;
+
+	Transform* transform = camera->entity()->transform();
+
+	const camera_key& firstKey = m_cameraPath.front();
+	const camera_key& lastKey = m_cameraPath.back();
+
+	if (m_loop && lastKey.time > firstKey.time) {
+		time = firstKey.time + std::fmod(time - firstKey.time, lastKey.time - firstKey.time);
+	}
+
+	if (time <= firstKey.time || m_cameraPath.size() == 1) {
+		transform->setPosition(firstKey.position);
+		transform->setRotation(firstKey.rotation);
+		return;
+	}
+
+	if (time >= lastKey.time) {
+		transform->setPosition(lastKey.position);
+		transform->setRotation(lastKey.rotation);
+		return;
+	}
+
+	auto next = std::upper_bound(m_cameraPath.begin(), m_cameraPath.end(), time, [](double t, const camera_key& k) {
+		return t < k.time;
+	});
+
+	std::size_t i1 = std::size_t(next - m_cameraPath.begin());
+	std::size_t i0 = i1 - 1;
+
+	const camera_key& k0 = m_cameraPath[i0];
+	const camera_key& k1 = m_cameraPath[i1];
+	const camera_key& kPrev = m_cameraPath[i0 > 0 ? i0 - 1 : i0];
+	const camera_key& kNext = m_cameraPath[std::min(i1 + 1, m_cameraPath.size() - 1)];
+
+	float s = float((time - k0.time) / (k1.time - k0.time));
+
+	transform->setPosition(glm::catmullRom(kPrev.position, k0.position, k1.position, kNext.position, s));
+	transform->setRotation(glm::slerp(k0.rotation, k1.rotation, s));
+}
+
+void Benchmark::endFrame(double frameTime)
+{
+	std::size_t glCallCount = gl_dispatch::total_call_count();
+	std::size_t glCalls = glCallCount - m_lastGlCallCount;
+	m_lastGlCallCount = glCallCount;
+
+	if (m_frame++ < m_warmupFrames)
+		return;
+
+	m_frameTimes.push_back(frameTime);
+
+	auto renderer = RenderEngine::instance();
+	if (renderer) {
+		m_drawCounts.push_back(double(renderer->drawCount()));
+		m_triangleCounts.push_back(double(renderer->triangleCount()));
+		m_prepassDrawCounts.push_back(double(renderer->prepassDrawCount()));
+		m_lightPixelsSaved.push_back(double(renderer->lightPixelsSaved()));
+		m_fwdLightPassesSaved.push_back(double(renderer->fwdLightPassesSaved()));
+		m_shadowViewsRendered.push_back(double(renderer->shadowViewsRendered()));
+		m_occlusionCulled.push_back(double(renderer->occlusionCulledCount()));
+		m_occlusionTimes.push_back(renderer->occlusionCullingTime());
+		m_renderTargetMemory.push_back(double(renderer->renderTargetMemory()) / (1024.0 * 1024.0));
+		m_resolutionScales.push_back(renderer->resolutionScale());
+
+		// not measured with the null backend, or while the GPU is too far behind
+		double gpuTime = renderer->gpuFrameTime();
+		if (gpuTime >= 0.0) m_gpuFrameTimes.push_back(gpuTime);
+	}
+
+	const auto& stateCalls = gl_state::last_frame();
+	m_stateCallsIssued.push_back(double(stateCalls.totalIssued()));
+	m_stateCallsSkipped.push_back(double(stateCalls.totalSkipped()));
+	m_textureBinds.push_back(double(texture_residency::lastFrame().unitBinds));
+
+	if (texture_streaming::isEnabled()) {
+		m_streamedTextureMemory.push_back(double(texture_streaming::residentBytes()) / (1024.0 * 1024.0));
+	}
+
+	if (gl_dispatch::current_backend() != gl_dispatch::backend::native) {
+		m_glCallCounts.push_back(double(glCalls));
+	}
+
+	for (auto& st : profiler::last_frame()) {
+		m_scopeTimes[st.name].push_back(st.time);
+	}
+}
+
+bool Benchmark::writeReport(const path& p) const
+{
+	nlohmann::json report;
+	report["name"] = m_name;
+	report["scene"] = m_scene;
+	report["timeStep"] = m_timeStep;
+	report["warmupFrames"] = m_warmupFrames;
+	report["frames"] = m_frameTimes.size();
+
+	report["frameTime"] = summarize(m_frameTimes);
+	report["drawCalls"] = summarize(m_drawCounts);
+	report["prepassDrawCalls"] = summarize(m_prepassDrawCounts);
+	report["triangles"] = summarize(m_triangleCounts);
+	report["stateCallsIssued"] = summarize(m_stateCallsIssued);
+	report["stateCallsSkipped"] = summarize(m_stateCallsSkipped);
+	report["textureBinds"] = summarize(m_textureBinds);
+	report["lightPixelsSaved"] = summarize(m_lightPixelsSaved);
+	report["fwdLightPassesSaved"] = summarize(m_fwdLightPassesSaved);
+	report["shadowViewsRendered"] = summarize(m_shadowViewsRendered);
+	report["occlusionCulled"] = summarize(m_occlusionCulled);
+	report["occlusionTime"] = summarize(m_occlusionTimes);
+	report["renderTargetMemoryMB"] = summarize(m_renderTargetMemory);
+	report["resolutionScale"] = summarize(m_resolutionScales);
+
+	if (!m_gpuFrameTimes.empty()) {
+		report["gpuFrameTime"] = summarize(m_gpuFrameTimes);
+	}
+
+	if (!m_streamedTextureMemory.empty()) {
+		report["streamedTextureMemoryMB"] = summarize(m_streamedTextureMemory);
+	}
+
+	if (!m_glCallCounts.empty()) {
+		report["glCalls"] = summarize(m_glCallCounts);
+	}
+
+	nlohmann::json scopes = nlohmann::json::object();
+	for (auto& st : m_scopeTimes) {
+		scopes[st.first] = summarize(st.second);
+	}
+	report["scopes"] = scopes;
+
+	report["frameTimes"] = m_frameTimes;
+
+	boost::filesystem::ofstream file(p);
+	if (!file) {
+		std::cout << "ERROR: could not write benchmark report to " << p << std::endl;
+		return false;
+	}
+
+	file << report.dump(2) << std::endl;
+
+	auto& ft = report["frameTime"];
+	if (!ft.empty()) {
+		std::cout << "benchmark \"" << m_name << "\": " << m_frameTimes.size() << " frames, p50 " << ft["p50"].get<double>()
+			<< " ms, p95 " << ft["p95"].get<double>() << " ms, p99 " << ft["p99"].get<double>() << " ms" << std::endl;
+	}
+	std::cout << "benchmark report written to " << p << std::endl;
+	return true;
+}
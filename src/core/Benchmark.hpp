@@ -0,0 +1,73 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include "path.hpp"
+#include "glm.hpp"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+// Deterministic benchmark run, loaded from a definition file (see the benchmarks folder).
+// The engine runs the benchmark's scene on a fixed time step for a fixed number of frames, while the main camera
+// follows the recorded path (or the input is replayed from a recorded log). After the warmup frames, frame times, per-scope CPU times (taken from the profiler),
+// draw calls and triangle counts are collected and written to a json report. GL calls per frame are included
+// when running on a counting GL backend (see gl_dispatch.hpp).
+class Benchmark
+{
+public:
+	explicit Benchmark(const path& definition);
+
+	bool isGood() const { return m_good; }
+
+	const std::string& name() const { return m_name; }
+	const std::string& scene() const { return m_scene; }
+
+	// input log to replay during the run (see Input::startReplay), may be empty
+	const path& inputLog() const { return m_inputLog; }
+
+	double timeStep() const { return m_timeStep; }
+
+	// including warmup frames
+	std::size_t frameCount() const { return m_warmupFrames + m_frames; }
+
+	// moves the main camera along the path (called after the scripts have been updated)
+	void update(double time);
+
+	// frameTime: wall time of the whole frame in milliseconds
+	void endFrame(double frameTime);
+
+	bool writeReport(const path& p) const;
+
+private:
+	struct camera_key
+	{
+		double time;
+		glm::vec3 position;
+		glm::quat rotation;
+	};
+
+	bool m_good;
+	std::string m_name, m_scene;
+	path m_inputLog;
+	double m_timeStep;
+	std::size_t m_warmupFrames, m_frames, m_frame;
+	bool m_loop;
+
+	std::vector<camera_key> m_cameraPath;
+
+	std::vector<double> m_frameTimes, m_drawCounts, m_triangleCounts, m_glCallCounts;
+	std::vector<double> m_stateCallsIssued, m_stateCallsSkipped, m_textureBinds;
+	std::vector<double> m_lightPixelsSaved, m_fwdLightPassesSaved, m_shadowViewsRendered;
+	std::vector<double> m_occlusionCulled, m_occlusionTimes;
+	std::vector<double> m_prepassDrawCounts;
+	std::vector<double> m_renderTargetMemory;
+	std::vector<double> m_resolutionScales, m_gpuFrameTimes;
+	std::vector<double> m_streamedTextureMemory;
+	std::size_t m_lastGlCallCount;
+	std::unordered_map<std::string, std::vector<double>> m_scopeTimes;
+
+	void applyCameraPath(double time);
+};
+
+#endif // BENCHMARK_HPP
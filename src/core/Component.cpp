@@ -1,5 +1,6 @@
 #include "Component.hpp"
 #include "Entity.hpp"
+#include "component_registry.hpp"
 #include "scripting/Environment.hpp"
 #include "scripting/class_registry.hpp"
 
@@ -7,7 +8,7 @@ json_interpreter<Component> Component::s_properties({
 	{ "enabled", &Component::setEnabled }
 });
 
-Component::Component(Entity* parent) : m_parent(parent), m_enabled(true) { }
+Component::Component(Entity* parent) : m_parent(parent), m_enabled(true), m_typeIndex(component_registry::npos) { }
 Component::~Component() { }
 
 bool Component::isActiveAndEnabled() const
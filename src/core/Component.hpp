@@ -2,6 +2,7 @@
 #define COMPONENT_HPP
 
 #include <string>
+#include <vector>
 
 #include "boost/mpl/bool.hpp"
 #include "Object.hpp"
@@ -31,6 +32,9 @@ public:
 
 	bool isActiveAndEnabled() const;
 
+	// index of this component's concrete type in the component_registry
+	std::size_t typeIndex() const { return m_typeIndex; }
+
 	COMPONENT_ALLOW_MULTIPLE;
 
 protected:
@@ -42,7 +46,13 @@ private:
 	Entity* m_parent;
 	bool m_enabled;
 
+	std::size_t m_typeIndex;
+	std::vector<std::size_t> m_poolSlots;
+
 	static json_interpreter<Component> s_properties;
+
+	friend class component_pool;
+	friend class component_registry;
 };
 
 void destroy_component(Component* cmpt);
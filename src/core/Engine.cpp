@@ -2,23 +2,36 @@
 
 #include "Scene.hpp"
 #include "Entity.hpp"
+#include "Benchmark.hpp"
 
 #include "ObjectRegistry.hpp"
 #include "graphics/RenderEngine.hpp"
 #include "content/Content.hpp"
 #include "input/Input.hpp"
+#include "component_registry.hpp"
+#include "ComponentModule.hpp"
 #include "scripting/Environment.hpp"
+#include "scripting/Behaviour.hpp"
 #include "scripting/class_registry.hpp"
 
 #include "app_info.hpp"
+#include "util/profiler.hpp"
 
-#include "GL/glew.h"
+#include "graphics/gl_dispatch.hpp"
+#include "graphics/gl_state.hpp"
+#include "graphics/texture/texture_residency.hpp"
+#include "graphics/texture/texture_streaming.hpp"
 #include "GLFW/glfw3.h"
 
 #include <iostream>
 
-Engine::Engine() : m_error(0), m_running(true), m_time(0), m_frameTime(0), m_loadingScene(false)
+Engine::Engine() : m_error(0), m_running(true), m_headless(app_info::get("headless", false)),
+	m_maxFrames(app_info::get<unsigned int>("maxFrames", 0)), m_frameCount(0), m_time(0), m_frameTime(0),
+	m_fixedTimeStep(app_info::get<time_type>("fixedTimeStep", 0)), m_loadingScene(false)
 {
+	profiler::set_thread_name("main");
+	profiler::set_enabled(app_info::get("cpuProfiling", false));
+
 	glfwSetErrorCallback([](int err, const char* msg) {
 		std::cout << msg << std::endl;
 	});
@@ -37,7 +50,31 @@ Engine::Engine() : m_error(0), m_running(true), m_time(0), m_frameTime(0), m_loa
 
 	GLFWmonitor* monitor = nullptr;
 
-	if (fullscreen) {
+	auto glBackend = gl_dispatch::backend::native;
+	auto glBackendName = app_info::get<std::string>("glBackend", "native");
+	if (!gl_dispatch::parse_backend(glBackendName, glBackend)) {
+		std::cout << "WARNING: unknown GL backend \"" << glBackendName << "\", using native instead." << std::endl;
+	}
+
+	// the null backend has no context to present anything
+	bool nullBackend = glBackend == gl_dispatch::backend::null;
+	if (nullBackend) {
+		m_headless = true;
+	}
+
+	if (m_headless) {
+		// the window is only hidden, GLFW 3.2 still needs a display (a desktop session) to create it and its context
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+		auto contextApi = app_info::get<std::string>("headlessContext", "native");
+		if (nullBackend) {
+			glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+		} else if (contextApi == "egl") {
+			glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+		} else if (contextApi != "native") {
+			std::cout << "WARNING: unsupported context creation API \"" << contextApi << "\", using native instead." << std::endl;
+		}
+	} else if (fullscreen) {
 		monitor = glfwGetPrimaryMonitor();
 
 		if (windowedFullscreen) {
@@ -63,27 +100,16 @@ Engine::Engine() : m_error(0), m_running(true), m_time(0), m_frameTime(0), m_loa
 		return;
 	}
 
-	glfwMakeContextCurrent(m_window);
-
-	setVSync(app_info::get("vSync", false));
-	
 	glfwSetFramebufferSizeCallback(m_window, resizeCallback);
 
-	// initialize GLEW
-	GLenum err = glewInit();
-	if (err != GLEW_OK) {
-		m_error = -3;
-		std::cout << "ERROR: Failed to initialize GLEW!" << std::endl;
+	if (nullBackend) {
+		m_vSync = false;
+		std::cout << "Using the null GL backend" << std::endl;
+	} else if (!initContext()) {
 		return;
 	}
 
-	std::cout << "Using OpenGL version: " << glGetString(GL_VERSION) << std::endl;
-
-	if (!GLEW_VERSION_3_3) {
-		m_error = -4;
-		std::cout << "ERROR: OpenGL version 3.3 or higher is required!" << std::endl;
-		return;
-	}
+	gl_dispatch::set_backend(glBackend);
 
 	m_content = std::make_unique<Content>();
 	m_scriptEnv = std::make_unique<scripting::Environment>();
@@ -91,28 +117,72 @@ Engine::Engine() : m_error(0), m_running(true), m_time(0), m_frameTime(0), m_loa
 	m_renderer = std::make_unique<RenderEngine>(this);
 	m_input = std::make_unique<Input>(m_window);
 
-	m_cmptModules.push_back(m_scriptEnv.get());
-	m_cmptModules.push_back(m_renderer.get());
+	subscribe(m_scriptEnv.get(), component_registry::indexOf<scripting::Behaviour>());
 
 	swapBuffers();
 
+	auto benchmarkPath = app_info::get<path>("benchmark");
+	if (!benchmarkPath.empty()) {
+		m_benchmark = std::make_unique<Benchmark>(benchmarkPath);
+		if (m_benchmark->isGood()) {
+			std::cout << "Running benchmark \"" << m_benchmark->name() << "\"..." << std::endl;
+
+			// phase timings come from the profiler
+			profiler::set_enabled(true);
+
+			m_fixedTimeStep = m_benchmark->timeStep();
+			m_maxFrames = m_benchmark->frameCount();
+			loadScene(m_benchmark->scene());
+
+			if (!m_benchmark->inputLog().empty()) {
+				m_input->startReplay(m_benchmark->inputLog());
+			}
+			return;
+		}
+
+		m_benchmark.reset();
+	}
+
 	loadFirstScene();
 }
 
 int Engine::run()
 {
 	auto start = clock::now();
-	duration_type accumulator{ 0 };
 
 	while (isRunning()) {
 		auto now = clock::now();
-		auto newTime = now - start;
 
-		m_frameTime = newTime - m_time;
-		m_time = newTime;
+		if (m_fixedTimeStep > 0) {
+			m_frameTime = duration_type(m_fixedTimeStep);
+			m_time += m_frameTime;
+		} else {
+			auto newTime = now - start;
+
+			m_frameTime = newTime - m_time;
+			m_time = newTime;
+		}
+
+		{
+			PROFILE_SCOPE("frame");
+			update();
+			render();
+		}
+
+		++m_frameCount;
+
+		profiler::end_frame();
+		gl_state::end_frame();
+		texture_residency::endFrame();
+		texture_streaming::endFrame();
 
-		update();
-		render();
+		if (m_benchmark) {
+			m_benchmark->endFrame(std::chrono::duration<double, std::milli>(clock::now() - now).count());
+		}
+	}
+
+	if (m_benchmark) {
+		m_benchmark->writeReport(app_info::get<path>("benchmarkOutput", "benchmark.json"));
 	}
 
 	return m_error;
@@ -120,6 +190,8 @@ int Engine::run()
 
 Engine::~Engine()
 {
+	texture_streaming::shutdown();
+
 	m_scene.reset();
 	m_input.reset();
 	m_renderer.reset();
@@ -127,12 +199,47 @@ Engine::~Engine()
 	m_scriptEnv.reset();
 	m_content.reset();
 
+	if (profiler::enabled()) {
+		profiler::write_chrome_trace(app_info::get<path>("cpuTraceOutput", "cpu_trace.json"));
+	}
+
+	if (gl_dispatch::current_backend() != gl_dispatch::backend::native) {
+		std::cout << "GL calls:" << std::endl;
+		gl_dispatch::write_call_counts(std::cout);
+	}
+
 	glfwTerminate();
 }
 
+bool Engine::initContext()
+{
+	glfwMakeContextCurrent(m_window);
+
+	// there is nothing to synchronize with in headless mode
+	setVSync(!m_headless && app_info::get("vSync", false));
+
+	// initialize GLEW
+	GLenum err = glewInit();
+	if (err != GLEW_OK) {
+		m_error = -3;
+		std::cout << "ERROR: Failed to initialize GLEW!" << std::endl;
+		return false;
+	}
+
+	std::cout << "Using OpenGL version: " << glGetString(GL_VERSION) << std::endl;
+
+	if (!GLEW_VERSION_3_3) {
+		m_error = -4;
+		std::cout << "ERROR: OpenGL version 3.3 or higher is required!" << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
 bool Engine::isRunning() const
 {
-	return m_running && !(glfwWindowShouldClose(m_window) || m_error);
+	return m_running && !(glfwWindowShouldClose(m_window) || m_error || (m_maxFrames && m_frameCount >= m_maxFrames));
 }
 
 void Engine::stop()
@@ -177,6 +284,8 @@ void Engine::setVSync(bool val)
 
 void Engine::loadSceneInternal(const std::string& sceneName)
 {
+	PROFILE_FUNCTION();
+
 	if (m_scene) {
 		std::cout << "Unloading scene \"" << m_scene->name() << "\"..." << std::endl;
 		m_scene.reset();
@@ -207,18 +316,43 @@ void Engine::loadFirstScene()
 
 void Engine::addComponent(Component* cmpt)
 {
-	for (auto cm : m_cmptModules) {
-		cm->addComponent(cmpt);
+	if (cmpt->typeIndex() == component_registry::npos)
+		return;
+
+	for (std::size_t i : component_registry::lineage(cmpt->typeIndex())) {
+		if (i < m_cmptSubscribers.size()) {
+			for (auto cm : m_cmptSubscribers[i]) {
+				cm->addComponent(cmpt);
+			}
+		}
 	}
 }
 
 void Engine::removeComponent(Component* cmpt)
 {
-	for (auto cm : m_cmptModules) {
-		cm->removeComponent(cmpt);
+	if (cmpt->typeIndex() == component_registry::npos)
+		return;
+
+	for (std::size_t i : component_registry::lineage(cmpt->typeIndex())) {
+		if (i < m_cmptSubscribers.size()) {
+			for (auto cm : m_cmptSubscribers[i]) {
+				cm->removeComponent(cmpt);
+			}
+		}
 	}
 }
 
+void Engine::subscribe(ComponentModule* module, std::size_t typeIndex)
+{
+	if (typeIndex == component_registry::npos)
+		return;
+
+	if (m_cmptSubscribers.size() <= typeIndex)
+		m_cmptSubscribers.resize(typeIndex + 1);
+
+	m_cmptSubscribers[typeIndex].push_back(module);
+}
+
 void Engine::onResize(int width, int height)
 {
 	m_renderer->onResize(width, height);
@@ -226,16 +360,24 @@ void Engine::onResize(int width, int height)
 
 void Engine::update()
 {
+	PROFILE_FUNCTION();
+
 	if (m_loadingScene) {
 		loadSceneInternal(m_loadingSceneName);
 	}
 
 	m_input->update();
 	m_scriptEnv->update();
+
+	if (m_benchmark) {
+		m_benchmark->update(time());
+	}
 }
 
 void Engine::render()
 {
+	PROFILE_FUNCTION();
+
 	if (m_renderer) {
 		m_renderer->render();
 	}
@@ -245,7 +387,14 @@ void Engine::render()
 
 void Engine::swapBuffers()
 {
-	glfwSwapBuffers(m_window);
+	PROFILE_FUNCTION();
+
+	if (m_headless) {
+		// nothing gets presented, but frames should still take as long as the GPU needs to render them
+		glFinish();
+	} else {
+		glfwSwapBuffers(m_window);
+	}
 }
 
 SCRIPTING_REGISTER_STATIC_CLASS(Engine)
@@ -257,7 +406,61 @@ SCRIPTING_AUTO_MODULE_METHOD(Engine, screenWidth)
 SCRIPTING_AUTO_MODULE_METHOD(Engine, screenHeight)
 SCRIPTING_AUTO_MODULE_METHOD(Engine, vSync)
 SCRIPTING_AUTO_MODULE_METHOD(Engine, setVSync)
+SCRIPTING_AUTO_MODULE_METHOD(Engine, isHeadless)
+SCRIPTING_AUTO_MODULE_METHOD(Engine, frameCount)
+SCRIPTING_AUTO_MODULE_METHOD(Engine, fixedTimeStep)
+SCRIPTING_AUTO_MODULE_METHOD(Engine, isBenchmarkRunning)
 SCRIPTING_AUTO_MODULE_METHOD(Engine, stop)
 SCRIPTING_AUTO_MODULE_METHOD(Engine, scene)
 SCRIPTING_AUTO_MODULE_METHOD(Engine, loadScene)
 SCRIPTING_AUTO_MODULE_METHOD(Engine, loadFirstScene)
+
+SCRIPTING_REGISTER_STATIC_CLASS(Profiler)
+
+SCRIPTING_DEFINE_METHOD(Profiler, isEnabled)
+{
+	scripting::push_value(L, profiler::enabled());
+	return 1;
+}
+
+SCRIPTING_DEFINE_METHOD(Profiler, setEnabled)
+{
+	profiler::set_enabled(scripting::check_arg<bool>(L, 1));
+	return 0;
+}
+
+SCRIPTING_DEFINE_METHOD(Profiler, beginScope)
+{
+	profiler::begin_script_scope(profiler::intern(scripting::check_arg<std::string>(L, 1)));
+	return 0;
+}
+
+SCRIPTING_DEFINE_METHOD(Profiler, endScope)
+{
+	profiler::end_script_scope();
+	return 0;
+}
+
+// returns min, avg, max and last time per frame (in milliseconds), or nothing if the scope was never recorded
+SCRIPTING_DEFINE_METHOD(Profiler, scopeTime)
+{
+	profiler::scope_stats st;
+	if (!profiler::find_stats(scripting::check_arg<std::string>(L, 1), st))
+		return 0;
+
+	scripting::push_values(L, st.min, st.avg, st.max, st.last);
+	return 4;
+}
+
+SCRIPTING_DEFINE_METHOD(Profiler, printStats)
+{
+	profiler::write_stats(std::cout);
+	return 0;
+}
+
+SCRIPTING_DEFINE_METHOD(Profiler, writeTrace)
+{
+	path p = lua_isnoneornil(L, 1) ? app_info::get<path>("cpuTraceOutput", "cpu_trace.json") : path(scripting::check_arg<std::string>(L, 1));
+	scripting::push_value(L, profiler::write_chrome_trace(p));
+	return 1;
+}
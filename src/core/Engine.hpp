@@ -4,6 +4,7 @@
 #include <chrono>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "util/singleton.hpp"
 #include "object_pointers.hpp"
@@ -21,6 +22,7 @@ class Content;
 class RenderEngine;
 class Scene;
 class Entity;
+class Benchmark;
 class Component;
 
 namespace scripting
@@ -48,6 +50,18 @@ public:
 	bool vSync() const { return m_vSync; }
 	void setVSync(bool val);
 
+	// in headless mode the window stays hidden, frames are rendered into an offscreen buffer and never presented
+	// (the hidden window still needs a display)
+	bool isHeadless() const { return m_headless; }
+
+	// number of frames rendered so far
+	std::size_t frameCount() const { return m_frameCount; }
+
+	// if non-zero, every frame advances the time by this amount instead of the measured frame time
+	time_type fixedTimeStep() const { return m_fixedTimeStep; }
+
+	bool isBenchmarkRunning() const { return bool(m_benchmark); }
+
 	int run();
 
 	void stop();
@@ -61,6 +75,9 @@ public:
 	void addComponent(Component* cmpt);
 	void removeComponent(Component* cmpt);
 
+	// notify a module about added/removed components of the given type (and its subtypes)
+	void subscribe(ComponentModule* module, std::size_t typeIndex);
+
 private:
 	using clock = std::chrono::high_resolution_clock;
 
@@ -69,16 +86,23 @@ private:
 	bool m_running;
 
 	bool m_vSync;
+	bool m_headless;
+
+	// the engine stops after this many frames (0 for no limit)
+	std::size_t m_maxFrames, m_frameCount;
 
 	duration_type m_time, m_frameTime;
+	time_type m_fixedTimeStep;
 
 	std::unique_ptr<Input> m_input;
 	std::unique_ptr<ObjectRegistry> m_objReg;
 	std::unique_ptr<Content> m_content;
 	std::unique_ptr<RenderEngine> m_renderer;
 	std::unique_ptr<scripting::Environment> m_scriptEnv;
+	std::unique_ptr<Benchmark> m_benchmark;
 
-	std::vector<ComponentModule*> m_cmptModules;
+	// component modules, indexed by the component type index they are subscribed to
+	std::vector<std::vector<ComponentModule*>> m_cmptSubscribers;
 
 	unique_obj_ptr<Scene> m_scene;
 
@@ -93,6 +117,8 @@ private:
 
 	bool isRunning() const;
 
+	bool initContext();
+
 	void update();
 
 	void render();
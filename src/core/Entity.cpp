@@ -40,8 +40,11 @@ Entity::~Entity()
 
 void Entity::initComponent(std::type_index id, Component* cmpt)
 {
+	const component_type& type = component_registry::findById(id);
+	component_registry::addToPools(cmpt, type.index);
+	addToLookup(cmpt);
+
 	if (id != typeid(scripting::Behaviour)) {
-		const component_type& type = component_registry::findById(id);
 		instance<scripting::Environment>()->createObject(type.name, cmpt);
 	} else {
 		m_behaviours.push_back(static_cast<scripting::Behaviour*>(cmpt));
@@ -54,15 +57,54 @@ void Entity::removeComponent(Component* cmpt)
 {
 	instance<Engine>()->removeComponent(cmpt);
 
-	if (typeid(*cmpt) != typeid(scripting::Behaviour)) {
+	if (cmpt->typeIndex() != component_registry::indexOf<scripting::Behaviour>()) {
 		scripting::Environment::instance()->invalidateObject(cmpt);
+	} else {
+		m_behaviours.erase(std::remove(m_behaviours.begin(), m_behaviours.end(), cmpt), m_behaviours.end());
 	}
 
+	component_registry::removeFromPools(cmpt);
+	removeFromLookup(cmpt);
+
+	// erasing destroys the component, so this comes last
 	m_components.erase(std::remove_if(m_components.begin(), m_components.end(), [cmpt](const cmpt_ptr& c) {
 		return cmpt == c.get();
 	}), m_components.end());
 }
 
+void Entity::addToLookup(Component* cmpt)
+{
+	if (cmpt->typeIndex() == component_registry::npos)
+		return;
+
+	if (m_cmptLookup.size() < component_registry::typeCount())
+		m_cmptLookup.resize(component_registry::typeCount(), nullptr);
+
+	for (std::size_t i : component_registry::lineage(cmpt->typeIndex())) {
+		if (!m_cmptLookup[i]) m_cmptLookup[i] = cmpt;
+	}
+}
+
+void Entity::removeFromLookup(Component* cmpt)
+{
+	if (cmpt->typeIndex() == component_registry::npos)
+		return;
+
+	for (std::size_t i : component_registry::lineage(cmpt->typeIndex())) {
+		if (m_cmptLookup[i] != cmpt)
+			continue;
+
+		// cmpt was the first component of this type, find the next one (if any)
+		m_cmptLookup[i] = nullptr;
+		for (auto& c : m_components) {
+			if (c.get() != cmpt && component_registry::isA(c->typeIndex(), i)) {
+				m_cmptLookup[i] = c.get();
+				break;
+			}
+		}
+	}
+}
+
 void Entity::apply_json_impl(const nlohmann::json& json)
 {
 	s_properties.interpret_all(this, json);
@@ -8,6 +8,7 @@
 
 #include "NamedObject.hpp"
 #include "Component.hpp"
+#include "component_registry.hpp"
 #include "util/import.hpp"
 #include "util/json_interpreter.hpp"
 #include "util/json_initializable.hpp"
@@ -118,6 +119,8 @@ private:
 
 	std::vector<cmpt_ptr> m_components;
 	std::vector<scripting::Behaviour*> m_behaviours;
+	// first component of every registered type (or subtype), indexed by component type index
+	std::vector<Component*> m_cmptLookup;
 	// every entity must have a transform, so cache it here for fast access
 	Transform* m_transform;
 
@@ -127,12 +130,21 @@ private:
 
 	void initComponent(std::type_index id, Component* cmpt);
 
+	void addToLookup(Component* cmpt);
+	void removeFromLookup(Component* cmpt);
+
 
 	template<typename T>
 	T* getComponentInternal() const
 	{
 		static_assert(std::is_base_of<Component, T>::value, "Only subclasses of Component are allowed!");
 
+		std::size_t index = component_registry::indexOf<T>();
+		if (index != component_registry::npos) {
+			return (index < m_cmptLookup.size()) ? static_cast<T*>(m_cmptLookup[index]) : nullptr;
+		}
+
+		// unregistered type, fall back to a linear search
 		for (auto& component : m_components) {
 			T* c = dynamic_cast<T*>(component.get());
 			if (c) return c;
@@ -148,9 +160,17 @@ private:
 
 		std::vector<T*> result;
 
-		for (auto& component : m_components) {
-			T* c = dynamic_cast<T*>(component.get());
-			if (c) result.push_back(c);
+		std::size_t index = component_registry::indexOf<T>();
+		if (index != component_registry::npos) {
+			for (auto& component : m_components) {
+				if (component_registry::isA(component->typeIndex(), index))
+					result.push_back(static_cast<T*>(component.get()));
+			}
+		} else {
+			for (auto& component : m_components) {
+				T* c = dynamic_cast<T*>(component.get());
+				if (c) result.push_back(c);
+			}
 		}
 
 		return result;
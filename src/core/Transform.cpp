@@ -12,7 +12,7 @@ json_interpreter<Transform> Transform::s_properties({
 	{ "scale", &Transform::setScale }
 });
 
-Transform::Transform(Entity* parent) : Component(parent), m_scale(1.0f), m_dirty(true) { }
+Transform::Transform(Entity* parent) : Component(parent), m_scale(1.0f), m_dirty(true), m_version(0) { }
 
 const glm::mat4& Transform::getMatrix() const
 {
@@ -49,9 +49,31 @@ void Transform::apply_json_impl(const nlohmann::json& json)
 
 SCRIPTING_REGISTER_DERIVED_CLASS(Transform, Component)
 
-SCRIPTING_AUTO_METHOD(Transform, position)
-SCRIPTING_AUTO_METHOD(Transform, rotation)
-SCRIPTING_AUTO_METHOD(Transform, scale)
+// getters take an optional xmath value as second argument, which is overwritten (and returned) instead of creating a new one
+SCRIPTING_DEFINE_METHOD(Transform, position)
+{
+	scripting::push_math(L, scripting::check_self<Transform>(L)->position(), 2);
+	return 1;
+}
+
+SCRIPTING_DEFINE_METHOD(Transform, rotation)
+{
+	scripting::push_math(L, scripting::check_self<Transform>(L)->rotation(), 2);
+	return 1;
+}
+
+SCRIPTING_DEFINE_METHOD(Transform, scale)
+{
+	scripting::push_math(L, scripting::check_self<Transform>(L)->scale(), 2);
+	return 1;
+}
+
+SCRIPTING_DEFINE_METHOD(Transform, matrix)
+{
+	scripting::push_math(L, scripting::check_self<Transform>(L)->getMatrix(), 2);
+	return 1;
+}
+
 SCRIPTING_AUTO_METHOD(Transform, setPosition)
 SCRIPTING_AUTO_METHOD(Transform, setRotation)
 SCRIPTING_AUTO_METHOD(Transform, setScale)
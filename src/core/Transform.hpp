@@ -14,9 +14,12 @@ public:
 	const glm::quat& rotation() const { return m_rotation; }
 	const glm::vec3& scale() const { return m_scale; }
 
-	void setPosition(const glm::vec3& position) { m_position = position; m_dirty = true; }
-	void setRotation(const glm::quat& rotation) { m_rotation = rotation; m_dirty = true; }
-	void setScale(const glm::vec3& scale) { m_scale = scale; m_dirty = true; }
+	void setPosition(const glm::vec3& position) { m_position = position; m_dirty = true; ++m_version; }
+	void setRotation(const glm::quat& rotation) { m_rotation = rotation; m_dirty = true; ++m_version; }
+	void setScale(const glm::vec3& scale) { m_scale = scale; m_dirty = true; ++m_version; }
+
+	// incremented on every change, unlike the dirty flag it is not reset when the matrix is rebuilt
+	std::size_t version() const { return m_version; }
 
 	const glm::mat4& getMatrix() const;
 	glm::mat4 getInverseMatrix() const;
@@ -35,6 +38,7 @@ private:
 
 	mutable glm::mat4 m_cachedMatrix;
 	mutable bool m_dirty;
+	std::size_t m_version;
 
 	static json_interpreter<Transform> s_properties;
 };
@@ -44,6 +44,13 @@ struct app_info
 		return get<T>(propName, {});
 	}
 
+	// overrides a property (e.g. with a command line option)
+	template<typename T>
+	static void set(const std::string& propName, T&& value)
+	{
+		s_properties[propName] = std::forward<T>(value);
+	}
+
 	static void load(const path& p);
 
 private:
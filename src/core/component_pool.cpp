@@ -0,0 +1,25 @@
+#include "component_pool.hpp"
+#include "Component.hpp"
+
+void component_pool::insert(Component* cmpt, std::size_t depth)
+{
+	cmpt->m_poolSlots[depth] = m_components.size();
+	m_components.push_back(cmpt);
+	m_depths.push_back(depth);
+}
+
+void component_pool::erase(Component* cmpt, std::size_t depth)
+{
+	std::size_t slot = cmpt->m_poolSlots[depth];
+
+	// move the last element into the freed slot (swap and pop)
+	Component* last = m_components.back();
+	std::size_t lastDepth = m_depths.back();
+
+	m_components[slot] = last;
+	m_depths[slot] = lastDepth;
+	last->m_poolSlots[lastDepth] = slot;
+
+	m_components.pop_back();
+	m_depths.pop_back();
+}
@@ -0,0 +1,64 @@
+#ifndef COMPONENT_POOL_HPP
+#define COMPONENT_POOL_HPP
+
+#include <vector>
+#include <cstddef>
+
+#include "boost/iterator/transform_iterator.hpp"
+#include "boost/range/iterator_range.hpp"
+
+class Component;
+
+// Dense array of all live components of one registered type (including derived types).
+// Every component remembers its slot in each pool it is part of, so insertion and removal are O(1).
+class component_pool
+{
+public:
+	using container = std::vector<Component*>;
+	using const_iterator = container::const_iterator;
+
+	std::size_t size() const { return m_components.size(); }
+	bool empty() const { return m_components.empty(); }
+
+	const_iterator begin() const { return m_components.cbegin(); }
+	const_iterator end() const { return m_components.cend(); }
+
+	Component* operator[] (std::size_t i) const { return m_components[i]; }
+
+	// depth: position of this pool's type in the lineage of the component's concrete type
+	void insert(Component* cmpt, std::size_t depth);
+	void erase(Component* cmpt, std::size_t depth);
+
+private:
+	container m_components;
+	std::vector<std::size_t> m_depths;
+};
+
+namespace detail
+{
+	template<typename T>
+	struct component_caster
+	{
+		T* operator() (Component* cmpt) const
+		{
+			return static_cast<T*>(cmpt);
+		}
+	};
+}
+
+template<typename T>
+using component_iterator = boost::transform_iterator<detail::component_caster<T>, component_pool::const_iterator>;
+
+template<typename T>
+using component_range = boost::iterator_range<component_iterator<T>>;
+
+template<typename T>
+component_range<T> make_component_range(const component_pool& pool)
+{
+	return {
+		component_iterator<T>(pool.begin(), detail::component_caster<T>()),
+		component_iterator<T>(pool.end(), detail::component_caster<T>())
+	};
+}
+
+#endif // COMPONENT_POOL_HPP
@@ -2,6 +2,7 @@
 #include "component_registry.hpp"
 
 #include <new>
+#include <algorithm>
 
 using type_container = component_registry::type_container;
 
@@ -16,9 +17,9 @@ struct null_component_factory : public component_factory
 	virtual Component* add(Entity* entity) const { return nullptr; }
 };
 
-component_type::component_type() : id(typeid(void)), name("unknown"), factory(std::make_shared<null_component_factory>()) { }
-component_type::component_type(std::type_index id, const std::string& name, std::shared_ptr<component_factory> factory)
-	: id(id), name(name), factory(factory) { }
+component_type::component_type() : id(typeid(void)), baseId(typeid(void)), index(component_registry::npos), name("unknown"), factory(std::make_shared<null_component_factory>()) { }
+component_type::component_type(std::type_index id, std::type_index baseId, const std::string& name, std::shared_ptr<component_factory> factory)
+	: id(id), baseId(baseId), index(component_registry::npos), name(name), factory(factory) { }
 
 component_type::operator bool() const
 {
@@ -26,8 +27,11 @@ component_type::operator bool() const
 }
 
 
+constexpr std::size_t component_registry::npos;
+
 void component_registry::registerComponentType(component_type type)
 {
+	type.index = s_types.size();
 	s_types.insert(type);
 
 	std::cout << "component registered: " << type.name << std::endl;
@@ -53,6 +57,93 @@ const component_type& component_registry::findById(std::type_index id)
 	return s_empty_type;
 }
 
+const component_type& component_registry::findByIndex(std::size_t index)
+{
+	auto& idx = s_types.get<by_index>();
+	if (index < idx.size()) {
+		return idx[index];
+	}
+	return s_empty_type;
+}
+
+std::size_t component_registry::typeCount()
+{
+	return s_types.size();
+}
+
+const component_registry::lineage_type& component_registry::lineage(std::size_t index)
+{
+	static std::vector<lineage_type> lineages;
+
+	// all types are registered during static initialization, so the lineages can be built once on first use
+	if (lineages.empty()) {
+		auto& idx = s_types.get<by_index>();
+		lineages.resize(idx.size());
+
+		for (std::size_t i = 0; i < idx.size(); i++) {
+			const component_type* type = &idx[i];
+			while (*type) {
+				lineages[i].push_back(type->index);
+				type = &findById(type->baseId);
+			}
+		}
+	}
+
+	return lineages[index];
+}
+
+bool component_registry::isA(std::size_t index, std::size_t baseIndex)
+{
+	if (index == npos || baseIndex == npos)
+		return false;
+
+	const auto& l = lineage(index);
+	return std::find(l.begin(), l.end(), baseIndex) != l.end();
+}
+
+std::vector<component_pool>& component_registry::pools()
+{
+	static std::vector<component_pool> p;
+	if (p.size() < s_types.size())
+		p.resize(s_types.size());
+	return p;
+}
+
+const component_pool& component_registry::pool(std::size_t index)
+{
+	return pools()[index];
+}
+
+void component_registry::addToPools(Component* cmpt, std::size_t index)
+{
+	cmpt->m_typeIndex = index;
+	if (index == npos)
+		return;
+
+	const auto& l = lineage(index);
+	auto& p = pools();
+
+	cmpt->m_poolSlots.resize(l.size());
+	for (std::size_t depth = 0; depth < l.size(); depth++) {
+		p[l[depth]].insert(cmpt, depth);
+	}
+}
+
+void component_registry::removeFromPools(Component* cmpt)
+{
+	if (cmpt->m_typeIndex == npos)
+		return;
+
+	const auto& l = lineage(cmpt->m_typeIndex);
+	auto& p = pools();
+
+	for (std::size_t depth = 0; depth < l.size(); depth++) {
+		p[l[depth]].erase(cmpt, depth);
+	}
+
+	cmpt->m_poolSlots.clear();
+}
+
 
 static std::aligned_storage_t<sizeof(type_container), alignof(type_container)> g_factories_buf;
 type_container& component_registry::s_types = reinterpret_cast<type_container&>(g_factories_buf);
@@ -5,11 +5,15 @@
 #include <functional>
 #include <typeindex>
 #include <memory>
+#include <type_traits>
 
 #include "boost/multi_index_container.hpp"
 #include "boost/multi_index/hashed_index.hpp"
+#include "boost/multi_index/random_access_index.hpp"
 #include "boost/multi_index/member.hpp"
 
+#include "component_pool.hpp"
+
 namespace mi = boost::multi_index;
 
 class Entity;
@@ -27,11 +31,13 @@ struct component_factory
 struct component_type
 {
 	std::type_index id;
+	std::type_index baseId;
+	std::size_t index;
 	std::string name;
 	std::shared_ptr<component_factory> factory;
 
 	component_type();
-	component_type(std::type_index id, const std::string& name, std::shared_ptr<component_factory> factory);
+	component_type(std::type_index id, std::type_index baseId, const std::string& name, std::shared_ptr<component_factory> factory);
 
 	operator bool() const;
 };
@@ -39,17 +45,50 @@ struct component_type
 class component_registry
 {
 public:
+	using lineage_type = std::vector<std::size_t>;
+
+	static constexpr std::size_t npos = std::size_t(-1);
+
 	static void registerComponentType(component_type type);
 
+	static std::size_t typeCount();
+
 	static const component_type& findByName(const std::string& name);
 	static const component_type& findById(std::type_index id);
+	static const component_type& findByIndex(std::size_t index);
+
+	// returns the index of the registered type T (or npos if T is not registered)
+	template<typename T>
+	static std::size_t indexOf()
+	{
+		static const std::size_t index = findById(typeid(std::remove_const_t<T>)).index;
+		return index;
+	}
+
+	// indices of a type and all of its registered base types, starting with the type itself
+	static const lineage_type& lineage(std::size_t index);
+	static bool isA(std::size_t index, std::size_t baseIndex);
+
+	// dense pool of all live components that are instances of the given type
+	static const component_pool& pool(std::size_t index);
+
+	template<typename T>
+	static component_range<T> components()
+	{
+		return make_component_range<T>(pool(indexOf<T>()));
+	}
+
+	static void addToPools(Component* cmpt, std::size_t index);
+	static void removeFromPools(Component* cmpt);
 
 	struct by_name { };
 	struct by_id { };
+	struct by_index { };
 
 	struct type_container_indices : public mi::indexed_by<
 		mi::hashed_unique<mi::tag<by_name>, mi::member<component_type, std::string, &component_type::name>>,
-		mi::hashed_unique<mi::tag<by_id>, mi::member<component_type, std::type_index, &component_type::id>>
+		mi::hashed_unique<mi::tag<by_id>, mi::member<component_type, std::type_index, &component_type::id>>,
+		mi::random_access<mi::tag<by_index>>
 	> { };
 
 	using type_container = mi::multi_index_container<
@@ -61,6 +100,8 @@ private:
 	static type_container& s_types;
 	static component_type s_empty_type;
 
+	static std::vector<component_pool>& pools();
+
 	friend struct component_registry_initializer;
 };
 
@@ -106,37 +147,44 @@ namespace detail
 		}
 	};
 
-	template<typename T>
+	template<typename T, typename Base>
 	struct abstract_component_registerer
 	{
+		static_assert(std::is_base_of<Component, Base>::value && std::is_base_of<Base, T>::value, "Component types must derive from their registered base type!");
+
 		explicit abstract_component_registerer(const std::string& name)
 		{
-			component_registry::registerComponentType(component_type(typeid(T), name, std::make_shared<abstract_cmpt_factory<T>>()));
+			component_registry::registerComponentType(component_type(typeid(T), typeid(Base), name, std::make_shared<abstract_cmpt_factory<T>>()));
 		}
 	};
 
-	template<typename T>
+	template<typename T, typename Base>
 	struct component_registerer
 	{
+		static_assert(std::is_base_of<Component, Base>::value && std::is_base_of<Base, T>::value, "Component types must derive from their registered base type!");
+
 		explicit component_registerer(const std::string& name)
 		{
-			component_registry::registerComponentType(component_type(typeid(T), name, std::make_shared<component_factory_t<T>>()));
+			component_registry::registerComponentType(component_type(typeid(T), typeid(Base), name, std::make_shared<component_factory_t<T>>()));
 		}
 	};
 }
 
-#define REGISTER_ABSTRACT_COMPONENT_CLASS(c)								\
-namespace																	\
-{																			\
-	::detail::abstract_component_registerer<c> register_component_##c (#c);	\
+#define REGISTER_ABSTRACT_DERIVED_COMPONENT_CLASS(c, b)							\
+namespace																		\
+{																				\
+	::detail::abstract_component_registerer<c, b> register_component_##c (#c);	\
 }
 
-#define REGISTER_COMPONENT_CLASS(c)								\
-namespace														\
-{																\
-	::detail::component_registerer<c> register_component_##c (#c);\
+#define REGISTER_DERIVED_COMPONENT_CLASS(c, b)							\
+namespace																\
+{																		\
+	::detail::component_registerer<c, b> register_component_##c (#c);	\
 }
 
+#define REGISTER_ABSTRACT_COMPONENT_CLASS(c) REGISTER_ABSTRACT_DERIVED_COMPONENT_CLASS(c, Component)
+#define REGISTER_COMPONENT_CLASS(c) REGISTER_DERIVED_COMPONENT_CLASS(c, Component)
+
 
 static struct component_registry_initializer
 {
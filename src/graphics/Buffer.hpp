@@ -1,7 +1,7 @@
 #ifndef BUFFER_HPP
 #define BUFFER_HPP
 
-#include "GL\glew.h"
+#include "gl_state.hpp"
 
 template<typename ElementType, GLenum t>
 class Buffer
@@ -18,8 +18,10 @@ public:
 
 	~Buffer()
 	{
-		if (m_glObj)
+		if (m_glObj) {
+			gl_state::forget_buffer(m_glObj);
 			glDeleteBuffers(1, &m_glObj);
+		}
 	}
 
 	Buffer(const Buffer& other) : Buffer(other.m_usage)
@@ -67,12 +69,12 @@ public:
 
 	void bind()
 	{
-		glBindBuffer(target, m_glObj);
+		gl_state::bind_buffer(target, m_glObj);
 	}
 
 	void unbind()
 	{
-		glBindBuffer(target, 0);
+		gl_state::bind_buffer(target, 0);
 	}
 
 	void setData(size_type count, const element_type* data, GLenum usage = 0)
@@ -89,13 +91,13 @@ public:
 	{
 		setData(other->m_count, nullptr);
 
-		glBindBuffer(GL_COPY_READ_BUFFER, other->m_glObj);
-		glBindBuffer(GL_COPY_WRITE_BUFFER, m_glObj);
+		gl_state::bind_buffer(GL_COPY_READ_BUFFER, other->m_glObj);
+		gl_state::bind_buffer(GL_COPY_WRITE_BUFFER, m_glObj);
 
 		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, count * sizeof(element_type));
 
-		glBindBuffer(GL_COPY_READ_BUFFER, 0);
-		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		gl_state::bind_buffer(GL_COPY_READ_BUFFER, 0);
+		gl_state::bind_buffer(GL_COPY_WRITE_BUFFER, 0);
 	}
 
 	element_type* map(bool writeOnly = false)
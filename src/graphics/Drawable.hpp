@@ -14,6 +14,9 @@ public:
 
 	virtual aabb bounds() const = 0;
 	virtual std::size_t triangles() const = 0;
+
+	// UV units per unit of object space (see uv_density.hpp), 0 if unknown
+	virtual float uvDensity() const { return 0.0f; }
 };
 
 #endif // RENDERABLE_HPP
\ No newline at end of file
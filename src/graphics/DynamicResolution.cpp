@@ -0,0 +1,75 @@
+#include "DynamicResolution.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// weight of the newest measurement
+	const double g_smoothing = 0.2;
+
+	// largest increase of the scale per change
+	const float g_maxStepUp = 0.05f;
+
+	// smaller changes are ignored
+	const float g_minChange = 0.01f;
+
+	double smooth(double current, double measured)
+	{
+		if (measured < 0.0) return current;
+		if (current < 0.0) return measured;
+		return current + (measured - current) * g_smoothing;
+	}
+}
+
+DynamicResolution::DynamicResolution(double targetTime, float minScale, float maxScale, float hysteresis)
+	: m_target(targetTime), m_minScale(1.0f), m_maxScale(1.0f), m_hysteresis(hysteresis), m_scale(1.0f),
+	m_cpuTime(-1.0), m_gpuTime(-1.0), m_framesSinceChange(0)
+{
+	setScaleBounds(minScale, maxScale);
+	m_scale = m_maxScale;
+}
+
+void DynamicResolution::update(double cpuTime, double gpuTime)
+{
+	m_cpuTime = smooth(m_cpuTime, cpuTime);
+	m_gpuTime = smooth(m_gpuTime, gpuTime);
+
+	if (++m_framesSinceChange < settle_frames) return;
+
+	double time = (m_gpuTime >= 0.0) ? m_gpuTime : m_cpuTime;
+	if (time <= 0.0 || m_target <= 0.0) return;
+
+	// the time grows with the pixel count, i.e. with the square of the scale
+	// aim for the middle of the band between the target and the hysteresis
+	double goal = m_target * (1.0 - 0.5 * m_hysteresis);
+	float ideal = m_scale * float(std::sqrt(goal / time));
+
+	float next = m_scale;
+	if (time > m_target) {
+		next = ideal;
+	} else if (time < m_target * (1.0 - m_hysteresis)) {
+		next = std::min(ideal, m_scale + g_maxStepUp);
+	}
+
+	next = std::min(std::max(next, m_minScale), m_maxScale);
+
+	if (std::abs(next - m_scale) >= g_minChange) {
+		m_scale = next;
+		m_framesSinceChange = 0;
+	}
+}
+
+void DynamicResolution::setScale(float val)
+{
+	m_scale = std::min(std::max(val, m_minScale), m_maxScale);
+	m_framesSinceChange = 0;
+}
+
+void DynamicResolution::setScaleBounds(float minScale, float maxScale)
+{
+	// never above the screen resolution, the render targets are only that large
+	m_maxScale = std::min(std::max(maxScale, 0.05f), 1.0f);
+	m_minScale = std::min(std::max(minScale, 0.05f), m_maxScale);
+	m_scale = std::min(std::max(m_scale, m_minScale), m_maxScale);
+}
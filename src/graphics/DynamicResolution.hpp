@@ -0,0 +1,47 @@
+#ifndef DYNAMICRESOLUTION_HPP
+#define DYNAMICRESOLUTION_HPP
+
+#include <cstddef>
+
+// picks the fraction of the screen resolution the scene is rendered at, so frames stay within a time budget
+// the GPU time decides when it is known (that's the part the resolution changes), the CPU time is the fallback.
+// the scale drops as soon as frames are too slow, but only grows again once they are faster than the target
+// by more than the hysteresis, and then in small steps.
+class DynamicResolution
+{
+public:
+	// frames to wait after a change before the next one, the measurements lag behind by a few frames
+	static const std::size_t settle_frames = 8;
+
+	// times in milliseconds, hysteresis as a fraction of the target time
+	DynamicResolution(double targetTime, float minScale, float maxScale, float hysteresis);
+
+	// times of the last frame in milliseconds, negative if not measured
+	void update(double cpuTime, double gpuTime);
+
+	float scale() const { return m_scale; }
+	void setScale(float val);
+
+	double targetTime() const { return m_target; }
+	void setTargetTime(double val) { m_target = val; }
+
+	float minScale() const { return m_minScale; }
+	float maxScale() const { return m_maxScale; }
+	void setScaleBounds(float minScale, float maxScale);
+
+	float hysteresis() const { return m_hysteresis; }
+	void setHysteresis(float val) { m_hysteresis = val; }
+
+	// smoothed times the decisions are based on (negative if never measured)
+	double cpuTime() const { return m_cpuTime; }
+	double gpuTime() const { return m_gpuTime; }
+
+private:
+	double m_target;
+	float m_minScale, m_maxScale, m_hysteresis;
+	float m_scale;
+	double m_cpuTime, m_gpuTime;
+	std::size_t m_framesSinceChange;
+};
+
+#endif // DYNAMICRESOLUTION_HPP
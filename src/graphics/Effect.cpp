@@ -1,4 +1,5 @@
 #include "Effect.hpp"
+#include "shader/Shader.hpp"
 #include "shader/ShaderProgram.hpp"
 #include "Material.hpp"
 #include "core/type_registry.hpp"
@@ -25,7 +26,8 @@ namespace
 		{ "forwardBase",		light_forward_base },
 		{ "forwardAdd",			light_forward_add },
 		{ "deferred",			light_deferred },
-		{ "shadowCast",			light_shadow_cast }
+		{ "shadowCast",			light_shadow_cast },
+		{ "depthOnly",			light_depth_only }
 	});
 }
 
@@ -35,7 +37,8 @@ json_interpreter<Effect> Effect::s_properties({
 	{ "renderQueue",	&Effect::extractRenderQueue },
 	{ "renderType",		{&Effect::setRenderType, &g_renderTypes} },
 	{ "properties",		&Effect::extractProperties },
-	{ "passes",			&Effect::extractPasses }
+	{ "passes",			&Effect::extractPasses },
+	{ "depthPrepass",	&Effect::m_depthPrepass }
 });
 
 json_interpreter<Pass> Pass::s_properties({
@@ -46,7 +49,7 @@ json_interpreter<Pass> Pass::s_properties({
 });
 
 
-Effect::Effect() : m_renderType(type_opaque), m_queuePriority(queue_geometry) { }
+Effect::Effect() : m_renderType(type_opaque), m_queuePriority(queue_geometry), m_depthPrepass(false) { }
 
 Pass::Pass() : mode(light_forward_base), program(nullptr) { }
 
@@ -101,6 +104,9 @@ void Pass::apply_json_impl(const nlohmann::json& json)
 void Effect::apply_json_impl(const nlohmann::json& json)
 {
 	s_properties.interpret_all(this, json);
+
+	if (m_depthPrepass && (m_renderType == type_opaque) && !getPass(light_depth_only))
+		addDepthPass();
 }
 
 void Effect::extractRenderQueue(const nlohmann::json& json)
@@ -166,6 +172,42 @@ void Effect::addPass(const nlohmann::json& json)
 	}
 }
 
+void Effect::addDepthPass()
+{
+	const Pass* base = getPass(light_forward_base);
+	if (!(base && base->program))
+		return;
+
+	// same vertex shader as the base pass, so both produce exactly the same depth
+	const Shader* vert = nullptr;
+	for (const Shader* s : base->program->shaders()) {
+		if (s->type() == Shader::type_vertex) vert = s;
+	}
+
+	if (!vert) return;
+
+	Pass depthPass;
+	depthPass.name = "depthPrepass";
+	depthPass.mode = light_depth_only;
+	depthPass.state = base->state;
+	depthPass.state.depthWriteEnable = true;
+	depthPass.state.colorWriteEnable = false;
+	depthPass.state.blendEnable = false;
+
+	// shared by all effects with the same vertex shader
+	nlohmann::json programJson = {
+		{ "name", vert->name() + "_depthOnly" },
+		{ "shaders", nlohmann::json::array({ vert->name(), "std_depth_only.frag" }) }
+	};
+	depthPass.program = content::get_pooled_json<ShaderProgram>(programJson);
+
+	if (depthPass.program && depthPass.program->isGood()) {
+		m_passes.push_back(std::move(depthPass));
+	} else {
+		std::cout << "WARNING: could not generate depth pass for effect " << name() << std::endl;
+	}
+}
+
 void Pass::extractState(const nlohmann::json& json)
 {
 	state.apply_json(json);
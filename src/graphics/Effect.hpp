@@ -22,7 +22,8 @@ enum light_mode
 	light_forward_base,
 	light_forward_add,
 	light_deferred,
-	light_shadow_cast
+	light_shadow_cast,
+	light_depth_only
 };
 
 enum render_queue
@@ -76,6 +77,10 @@ public:
 	int queuePriority() const { return m_queuePriority; }
 	void setQueuePriority(int val) { m_queuePriority = val; }
 
+	// whether the forward path may draw this effect into a depth pre-pass (if enabled globally),
+	// opaque effects without a "depthOnly" pass get one generated from the vertex shader of their base pass
+	bool hasDepthPrepass() const { return m_depthPrepass; }
+
 	std::size_t passCount() const;
 
 	const Pass* getPass(std::size_t index) const;
@@ -104,6 +109,7 @@ private:
 
 	render_type m_renderType;
 	int m_queuePriority;
+	bool m_depthPrepass;
 
 	shader_property_map m_properties;
 	pass_container m_passes;
@@ -123,6 +129,7 @@ private:
 
 	void addProperty(const nlohmann::json& json);
 	void addPass(const nlohmann::json& json);
+	void addDepthPass();
 
 	friend struct json_initializable<Effect>;
 
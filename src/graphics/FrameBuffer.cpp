@@ -10,6 +10,7 @@ FrameBuffer::FrameBuffer() : m_glObj(0), m_clearDepth(1.0f), m_clearStencil(0)
 
 FrameBuffer::~FrameBuffer()
 {
+	gl_state::forget_framebuffer(m_glObj);
 	glDeleteFramebuffers(1, &m_glObj);
 }
 
@@ -25,12 +26,12 @@ void FrameBuffer::unbind()
 
 void FrameBuffer::bind(GLenum t) const
 {
-	glBindFramebuffer(t, m_glObj);
+	gl_state::bind_framebuffer(t, m_glObj);
 }
 
 void FrameBuffer::unbind(GLenum t)
 {
-	glBindFramebuffer(t, 0);
+	gl_state::bind_framebuffer(t, 0);
 }
 
 void FrameBuffer::clear() const
@@ -41,11 +42,11 @@ void FrameBuffer::clear() const
 	}
 
 	if (m_depthStencilTarget) {
-		glDepthMask(GL_TRUE);
+		gl_state::depth_mask(true);
 		glClearBufferfi(GL_DEPTH_STENCIL, 0, m_clearDepth, m_clearStencil);
 	} else {
 		if (m_depthTarget) {
-			glDepthMask(GL_TRUE);
+			gl_state::depth_mask(true);
 			glClearBufferfv(GL_DEPTH, 0, &m_clearDepth);
 		}
 		if (m_stencilTarget) {
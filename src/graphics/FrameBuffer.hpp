@@ -1,7 +1,7 @@
 #ifndef FRAMEBUFFER_HPP
 #define FRAMEBUFFER_HPP
 
-#include "GL/glew.h"
+#include "gl_state.hpp"
 #include "glm.hpp"
 
 #include <utility>
@@ -0,0 +1,51 @@
+#include "GpuTimer.hpp"
+
+GpuTimer::GpuTimer() : m_pending(), m_current(0), m_lastTime(-1.0), m_running(false)
+{
+	glGenQueries(GLsizei(query_count), m_queries.data());
+}
+
+GpuTimer::~GpuTimer()
+{
+	glDeleteQueries(GLsizei(query_count), m_queries.data());
+}
+
+void GpuTimer::begin()
+{
+	collect();
+
+	// the GPU is more than query_count frames behind, this frame goes unmeasured
+	std::size_t next = (m_current + 1) % query_count;
+	if (m_pending[next]) return;
+
+	m_current = next;
+	glBeginQuery(GL_TIME_ELAPSED, m_queries[m_current]);
+	m_running = true;
+}
+
+void GpuTimer::end()
+{
+	if (!m_running) return;
+
+	glEndQuery(GL_TIME_ELAPSED);
+	m_pending[m_current] = true;
+	m_running = false;
+}
+
+void GpuTimer::collect()
+{
+	// oldest first, so the newest finished result ends up in m_lastTime
+	for (std::size_t i = 1; i <= query_count; ++i) {
+		std::size_t q = (m_current + i) % query_count;
+		if (!m_pending[q]) continue;
+
+		GLint available = 0;
+		glGetQueryObjectiv(m_queries[q], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available) continue;
+
+		GLuint64 ns = 0;
+		glGetQueryObjectui64v(m_queries[q], GL_QUERY_RESULT, &ns);
+		m_lastTime = double(ns) * 1e-6;
+		m_pending[q] = false;
+	}
+}
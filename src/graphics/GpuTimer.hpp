@@ -0,0 +1,37 @@
+#ifndef GPUTIMER_HPP
+#define GPUTIMER_HPP
+
+#include "gl_dispatch.hpp"
+
+#include <array>
+
+// GPU time between begin() and end(), measured with timer queries
+// results are picked up a few frames later, so reading them never waits for the GPU
+class GpuTimer
+{
+public:
+	static const std::size_t query_count = 4;
+
+	GpuTimer();
+	~GpuTimer();
+
+	GpuTimer(const GpuTimer& other) = delete;
+	GpuTimer& operator=(const GpuTimer& other) = delete;
+
+	void begin();
+	void end();
+
+	// milliseconds, negative until the first result has arrived
+	double lastTime() const { return m_lastTime; }
+
+private:
+	std::array<GLuint, query_count> m_queries;
+	std::array<bool, query_count> m_pending;
+	std::size_t m_current;
+	double m_lastTime;
+	bool m_running;
+
+	void collect();
+};
+
+#endif // GPUTIMER_HPP
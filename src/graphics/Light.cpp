@@ -23,11 +23,12 @@ namespace
 		{ "range",			&Light::setRange },
 		{ "spotAngle",		&Light::setSpotAngle },
 		{ "spotFalloff",	&Light::setSpotFalloff },
-		{ "priority",		&Light::setPriority }
+		{ "priority",		&Light::setPriority },
+		{ "castShadows",	&Light::setCastShadows }
 	});
 }
 
-Light::Light(Entity* parent) : Component(parent), m_type(type_directional), m_color(1.f), m_intensity(1.f), m_range(10.f), m_spotAngle(15.f), m_spotFalloff(0.5f), m_priority(0) { }
+Light::Light(Entity* parent) : Component(parent), m_type(type_directional), m_color(1.f), m_intensity(1.f), m_range(10.f), m_spotAngle(15.f), m_spotFalloff(0.5f), m_priority(0), m_castShadows(false) { }
 
 bool Light::isVisible() const
 {
@@ -75,6 +76,7 @@ SCRIPTING_AUTO_METHOD(Light, range)
 SCRIPTING_AUTO_METHOD(Light, spotAngle)
 SCRIPTING_AUTO_METHOD(Light, spotFalloff)
 SCRIPTING_AUTO_METHOD(Light, priority)
+SCRIPTING_AUTO_METHOD(Light, castShadows)
 
 SCRIPTING_AUTO_METHOD(Light, setColor)
 SCRIPTING_AUTO_METHOD(Light, setIntensity)
@@ -82,6 +84,7 @@ SCRIPTING_AUTO_METHOD(Light, setRange)
 SCRIPTING_AUTO_METHOD(Light, setSpotAngle)
 SCRIPTING_AUTO_METHOD(Light, setSpotFalloff)
 SCRIPTING_AUTO_METHOD(Light, setPriority)
+SCRIPTING_AUTO_METHOD(Light, setCastShadows)
 
 SCRIPTING_AUTO_METHOD(Light, isVisible)
 
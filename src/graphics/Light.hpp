@@ -27,6 +27,7 @@ public:
 	float spotAngle() const { return m_spotAngle; }
 	float spotFalloff() const { return m_spotFalloff; }
 	int priority() const { return m_priority; }
+	bool castShadows() const { return m_castShadows; }
 
 	void setType(light_type val) { m_type = val; }
 	void setColor(const glm::vec4& val) { m_color = val; }
@@ -35,6 +36,7 @@ public:
 	void setSpotAngle(float val) { m_spotAngle = val; }
 	void setSpotFalloff(float val) { m_spotFalloff = val; }
 	void setPriority(int val) { m_priority = val; }
+	void setCastShadows(bool val) { m_castShadows = val; }
 
 	bool isVisible() const;
 
@@ -51,6 +53,7 @@ private:
 	float m_spotAngle;
 	float m_spotFalloff;
 	int m_priority;
+	bool m_castShadows;
 };
 
 #endif // LIGHT_HPP
\ No newline at end of file
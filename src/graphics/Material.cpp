@@ -3,6 +3,9 @@
 #include "core/type_registry.hpp"
 #include "content/pooled.hpp"
 #include "scripting/class_registry.hpp"
+#include "graphics/texture/Texture2D.hpp"
+
+#include "boost/type_erasure/any_cast.hpp"
 
 REGISTER_OBJECT_TYPE_NO_EXT(Material);
 
@@ -24,6 +27,8 @@ void Material::setEffect(Effect* effect)
 			}
 		}
 	}
+
+	updateTextures();
 }
 
 const shader_property* Material::getProperty(uniform_id id) const
@@ -35,6 +40,16 @@ const shader_property* Material::getProperty(uniform_id id) const
 	return nullptr;
 }
 
+void Material::updateTextures()
+{
+	m_textures.clear();
+	for (const shader_property& prop : m_properties) {
+		Texture2D* const* texture = boost::type_erasure::any_cast<Texture2D* const*>(&prop.value);
+		if (texture && *texture)
+			m_textures.push_back(*texture);
+	}
+}
+
 void Material::apply(const ShaderProgram* p) const
 {
 	m_effect->applyProperties(p, this);
@@ -54,6 +69,8 @@ void Material::apply_json_impl(const nlohmann::json& json)
 		for (auto it = pj.begin(); it != pj.end(); ++it) {
 			setPropFromJson(it.key(), it.value());
 		}
+
+		updateTextures();
 	}
 }
 
@@ -6,8 +6,11 @@
 #include "util/json_initializable.hpp"
 #include "graphics/shader/shader_property.hpp"
 
+#include <vector>
+
 class Effect;
 class ShaderProgram;
+class Texture2D;
 
 class Material : public NamedObject, public json_initializable<Material>
 {
@@ -47,14 +50,21 @@ public:
 			m_properties.modify(it, [&json](shader_property& prop) {
 				prop.set(newValue);
 			});
+			updateTextures();
 		}
 	}
 
+	// the 2D textures among the property values (e.g. to request their mip levels, see texture_streaming)
+	const std::vector<const Texture2D*>& textures() const { return m_textures; }
+
 	void apply(const ShaderProgram* p) const;
 
 private:
 	Effect* m_effect;
 	shader_property_map m_properties;
+	std::vector<const Texture2D*> m_textures;
+
+	void updateTextures();
 
 	// cppcheck-suppress unusedPrivateFunction
 	void apply_json_impl(const nlohmann::json& json);
@@ -1,13 +1,16 @@
 #include "Mesh.hpp"
 #include "gl_types.hpp"
+#include "gl_state.hpp"
 #include "core/type_registry.hpp"
 #include "scripting/class_registry.hpp"
 
+#include "uv_density.hpp"
+
 #include <numeric>
 
 REGISTER_OBJECT_TYPE(Mesh, ".rbm");
 
-SubMesh::SubMesh() : m_vao(0) { }
+SubMesh::SubMesh() : m_vao(0), m_uvDensity(0.0f) { }
 
 SubMesh::SubMesh(SubMesh&& other)
 	: m_vao(other.m_vao),
@@ -15,7 +18,8 @@ SubMesh::SubMesh(SubMesh&& other)
 	m_normals(std::move(other.m_normals)),
 	m_tangents(std::move(other.m_tangents)),
 	m_uvs(std::move(other.m_uvs)),
-	m_indices(std::move(other.m_indices))
+	m_indices(std::move(other.m_indices)),
+	m_uvDensity(other.m_uvDensity)
 {
 	other.m_vao = 0;
 }
@@ -29,6 +33,7 @@ SubMesh& SubMesh::operator=(SubMesh&& other)
 		m_tangents = std::move(other.m_tangents);
 		m_uvs = std::move(other.m_uvs);
 		m_indices = std::move(other.m_indices);
+		m_uvDensity = other.m_uvDensity;
 		other.m_vao = 0;
 	}
 
@@ -37,17 +42,20 @@ SubMesh& SubMesh::operator=(SubMesh&& other)
 
 SubMesh::~SubMesh()
 {
-	if (m_vao) glDeleteVertexArrays(1, &m_vao);
+	if (m_vao) {
+		gl_state::forget_vertex_array(m_vao);
+		glDeleteVertexArrays(1, &m_vao);
+	}
 }
 
 void SubMesh::bindVAO() const
 {
-	glBindVertexArray(m_vao);
+	gl_state::bind_vertex_array(m_vao);
 }
 
 void SubMesh::unbindVAO() const
 {
-	glBindVertexArray(0);
+	gl_state::bind_vertex_array(0);
 }
 
 void SubMesh::bindIndices() const
@@ -113,6 +121,27 @@ std::size_t SubMesh::triangles() const
 	return m_indices->count() / 3;
 }
 
+void SubMesh::readGeometry(std::vector<position_type>& positions, std::vector<index_type>& indices) const
+{
+	positions.clear();
+	indices.clear();
+
+	if (!(m_positions && m_indices))
+		return;
+
+	const position_type* vertices = m_positions->mapReadOnly();
+	if (vertices) {
+		positions.assign(vertices, vertices + m_positions->count());
+	}
+	m_positions->unmap();
+
+	const index_type* idx = m_indices->mapReadOnly();
+	if (idx && vertices) {
+		indices.assign(idx, idx + m_indices->count());
+	}
+	m_indices->unmap();
+}
+
 aabb SubMesh::computeBounds() const
 {
 	glm::vec3 min(std::numeric_limits<float>::max()), max(std::numeric_limits<float>::lowest());
@@ -170,6 +199,11 @@ std::unique_ptr<Mesh> import_object(const path& filename)
 
 			file.read(reinterpret_cast<char*>(&compMask), sizeof(compMask));
 
+			float uvDensity = 0.0f;
+			if ((compMask & 0x08u) == 0x08u) {
+				file.read(reinterpret_cast<char*>(&uvDensity), sizeof(uvDensity));
+			}
+
 			bool hasVertices = (compMask & 0x80u) == 0x80u;
 			bool hasNormals = (compMask & 0x40u) == 0x40u;
 			bool hasTangents = (compMask & 0x20u) == 0x20u;
@@ -205,9 +239,15 @@ std::unique_ptr<Mesh> import_object(const path& filename)
 			std::vector<SubMesh::index_type> indices(indexCount);
 			file.read(reinterpret_cast<char*>(indices.data()), sizeof(SubMesh::index_type) * indexCount);
 
+			// meshes processed before conproc stored the density
+			if (uvDensity <= 0.0f && hasVertices && hasUvs) {
+				uvDensity = compute_uv_density(vertices.data(), uvs.data(), indices.data(), indexCount);
+			}
+
 			auto subMesh = std::make_unique<SubMesh>();
 			subMesh->setVertices(vertexCount, vertexData, normalData, tangentData, uvData);
 			subMesh->setIndices(indexCount, indices.data());
+			subMesh->setUvDensity(uvDensity);
 			newMesh->addSubMesh(std::move(subMesh));
 		}
 
@@ -221,6 +261,7 @@ SCRIPTING_REGISTER_DERIVED_CLASS(SubMesh, Object)
 
 SCRIPTING_AUTO_METHOD(SubMesh, bounds)
 SCRIPTING_AUTO_METHOD(SubMesh, triangles)
+SCRIPTING_AUTO_METHOD(SubMesh, uvDensity)
 
 SCRIPTING_REGISTER_DERIVED_CLASS(Mesh, NamedObject)
 
@@ -60,6 +60,12 @@ public:
 	virtual aabb bounds() const final { return m_bounds; }
 	virtual std::size_t triangles() const final;
 
+	virtual float uvDensity() const final { return m_uvDensity; }
+	void setUvDensity(float val) { m_uvDensity = val; }
+
+	// copies positions and indices back from the GPU (for CPU side processing, like occlusion culling)
+	void readGeometry(std::vector<position_type>& positions, std::vector<index_type>& indices) const;
+
 private:
 	GLuint m_vao;
 
@@ -71,6 +77,7 @@ private:
 	std::unique_ptr<index_buffer_type>		m_indices;
 
 	aabb m_bounds;
+	float m_uvDensity;
 
 	aabb computeBounds() const;
 	void updateBounds();
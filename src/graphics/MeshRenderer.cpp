@@ -5,13 +5,14 @@
 #include "core/Entity.hpp"
 #include "content/pooled.hpp"
 
-REGISTER_COMPONENT_CLASS(MeshRenderer);
+REGISTER_DERIVED_COMPONENT_CLASS(MeshRenderer, Renderer);
 
 json_interpreter<MeshRenderer> MeshRenderer::s_properties({
-	{ "mesh", &MeshRenderer::extractMesh }
+	{ "mesh", &MeshRenderer::extractMesh },
+	{ "occluder", &MeshRenderer::extractOccluder }
 });
 
-MeshRenderer::MeshRenderer(Entity* parent) : Renderer(parent), m_mesh(nullptr) { }
+MeshRenderer::MeshRenderer(Entity* parent) : Renderer(parent), m_mesh(nullptr), m_occluderProxy(nullptr), m_occluder(false) { }
 
 bool MeshRenderer::hasGeometry() const
 {
@@ -37,7 +38,22 @@ void MeshRenderer::extractMesh(const nlohmann::json& json)
 	setMesh(content::get_pooled<Mesh>(json));
 }
 
+void MeshRenderer::extractOccluder(const nlohmann::json& json)
+{
+	// either true/false or the name of a proxy mesh
+	if (json.is_boolean()) {
+		setOccluder(json.get<bool>());
+	} else if (json.is_string()) {
+		setOccluderProxy(content::get_pooled<Mesh>(json));
+		setOccluder(m_occluderProxy != nullptr);
+	}
+}
+
 SCRIPTING_REGISTER_DERIVED_CLASS(MeshRenderer, Renderer)
 
 SCRIPTING_AUTO_METHOD(MeshRenderer, mesh)
 SCRIPTING_AUTO_METHOD(MeshRenderer, setMesh)
+SCRIPTING_AUTO_METHOD(MeshRenderer, isOccluder)
+SCRIPTING_AUTO_METHOD(MeshRenderer, setOccluder)
+SCRIPTING_AUTO_METHOD(MeshRenderer, occluderProxy)
+SCRIPTING_AUTO_METHOD(MeshRenderer, setOccluderProxy)
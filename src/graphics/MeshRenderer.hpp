@@ -17,6 +17,16 @@ public:
 
 	void setMesh(Mesh* mesh) { m_mesh = mesh; }
 
+	// occluders are rasterized by the software occlusion culling, either with their own mesh or with a (simpler) proxy mesh
+	bool isOccluder() const { return m_occluder; }
+	void setOccluder(bool val) { m_occluder = val; }
+
+	Mesh* occluderProxy() { return m_occluderProxy; }
+	void setOccluderProxy(Mesh* mesh) { m_occluderProxy = mesh; }
+
+	// nullptr if this is not an occluder
+	const Mesh* occluderMesh() const { return m_occluder ? (m_occluderProxy ? m_occluderProxy : m_mesh) : nullptr; }
+
 protected:
 	virtual const Drawable* getDrawable_impl(std::size_t index) const override;
 	virtual bool hasGeometry() const override;
@@ -24,11 +34,15 @@ protected:
 
 private:
 	Mesh* m_mesh;
+	Mesh* m_occluderProxy;
+	bool m_occluder;
 
 	static json_interpreter<MeshRenderer> s_properties;
 
 	// cppcheck-suppress unusedPrivateFunction
 	void extractMesh(const nlohmann::json& json);
+	// cppcheck-suppress unusedPrivateFunction
+	void extractOccluder(const nlohmann::json& json);
 };
 
 #endif // MESHRENDERER_HPP
\ No newline at end of file
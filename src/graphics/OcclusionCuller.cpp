@@ -0,0 +1,280 @@
+#include "OcclusionCuller.hpp"
+#include "util/parallel.hpp"
+#include "util/profiler.hpp"
+
+#include <xmmintrin.h>
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace
+{
+	// triangles closer than this (in clip space w) are not rasterized
+	const float g_minW = 1e-4f;
+
+	unsigned int round_up(unsigned int value, unsigned int multiple)
+	{
+		return ((std::max(value, 1u) + multiple - 1) / multiple) * multiple;
+	}
+
+	// false if the vertex is behind the near plane, the triangle or box it belongs to has to be skipped
+	bool project(const glm::mat4& m, const glm::vec3& p, float width, float height, glm::vec3& result)
+	{
+		glm::vec4 cp = m * glm::vec4(p, 1.0f);
+		if (cp.w <= g_minW || cp.z < -cp.w) return false;
+
+		glm::vec3 ndc = glm::vec3(cp) / cp.w;
+		result = {
+			(ndc.x * 0.5f + 0.5f) * width,
+			(ndc.y * 0.5f + 0.5f) * height,
+			ndc.z * 0.5f + 0.5f
+		};
+		return true;
+	}
+}
+
+OcclusionCuller::OcclusionCuller(unsigned int width, unsigned int height)
+	: m_width(round_up(width, block_size)), m_height(round_up(height, block_size)),
+	m_occluders(nullptr), m_triangleCount(0), m_renderTime(0.0)
+{
+	m_blocksX = m_width / block_size;
+	m_blocksY = m_height / block_size;
+
+	m_depth.resize(m_width * m_height, 1.0f);
+	m_blockMax.resize(m_blocksX * m_blocksY, 1.0f);
+}
+
+void OcclusionCuller::render(const std::vector<occluder>& occluders, const glm::mat4& viewProj)
+{
+	PROFILE_FUNCTION();
+
+	using clock = std::chrono::high_resolution_clock;
+	using ms = std::chrono::duration<double, std::milli>;
+
+	auto start = clock::now();
+
+	m_viewProj = viewProj;
+	m_occluders = &occluders;
+
+	m_occluderMatrices.clear();
+	m_triangleOffsets.clear();
+
+	std::size_t triangles = 0;
+	for (const occluder& o : occluders) {
+		m_occluderMatrices.push_back(viewProj * o.model);
+		m_triangleOffsets.push_back(triangles);
+
+		triangles += o.indices->size() / 3;
+	}
+
+	m_triangles.resize(triangles);
+	m_triangleCount = triangles;
+
+	parallel_for(occluders.size(), 8, [this](std::size_t begin, std::size_t end) {
+		for (std::size_t i = begin; i < end; ++i) {
+			setupTriangles(i);
+		}
+	});
+
+	// every band covers whole block rows, so the block depths can be updated right after
+	parallel_for(m_blocksY, 2, [this](std::size_t begin, std::size_t end) {
+		rasterizeBand(static_cast<unsigned int>(begin) * block_size, static_cast<unsigned int>(end) * block_size);
+		updateBlocks(static_cast<unsigned int>(begin), static_cast<unsigned int>(end));
+	});
+
+	m_occluders = nullptr;
+	m_renderTime = ms(clock::now() - start).count();
+}
+
+bool OcclusionCuller::isVisible(const obb& bounds) const
+{
+	float w = float(m_width), h = float(m_height);
+
+	glm::vec2 rmin(std::numeric_limits<float>::max()), rmax(std::numeric_limits<float>::lowest());
+	float minDepth = 1.0f;
+
+	for (unsigned int i = 0; i < 8; ++i) {
+		glm::vec3 corner = bounds.center + bounds.axis * (glm::vec3(
+			(i & 1) ? 1.0f : -1.0f,
+			(i & 2) ? 1.0f : -1.0f,
+			(i & 4) ? 1.0f : -1.0f) * bounds.extents);
+
+		// crosses the near plane, the camera may be inside
+		glm::vec3 sp;
+		if (!project(m_viewProj, corner, w, h, sp)) return true;
+
+		rmin = glm::min(rmin, glm::vec2(sp.x, sp.y));
+		rmax = glm::max(rmax, glm::vec2(sp.x, sp.y));
+		minDepth = glm::min(minDepth, sp.z);
+	}
+
+	if (rmax.x < 0.0f || rmax.y < 0.0f || rmin.x >= w || rmin.y >= h)
+		return true;
+
+	unsigned int minX = static_cast<unsigned int>(glm::max(rmin.x, 0.0f));
+	unsigned int minY = static_cast<unsigned int>(glm::max(rmin.y, 0.0f));
+	unsigned int maxX = glm::min(static_cast<unsigned int>(rmax.x), m_width - 1);
+	unsigned int maxY = glm::min(static_cast<unsigned int>(rmax.y), m_height - 1);
+
+	for (unsigned int by = minY / block_size; by <= maxY / block_size; ++by) {
+		for (unsigned int bx = minX / block_size; bx <= maxX / block_size; ++bx) {
+			// the whole block is in front of the object
+			if (minDepth > m_blockMax[by * m_blocksX + bx])
+				continue;
+
+			unsigned int x0 = glm::max(minX, bx * block_size), x1 = glm::min(maxX, (bx + 1) * block_size - 1);
+			unsigned int y0 = glm::max(minY, by * block_size), y1 = glm::min(maxY, (by + 1) * block_size - 1);
+
+			for (unsigned int y = y0; y <= y1; ++y) {
+				const float* row = &m_depth[y * m_width];
+				for (unsigned int x = x0; x <= x1; ++x) {
+					if (minDepth <= row[x]) return true;
+				}
+			}
+		}
+	}
+
+	return false;
+}
+
+void OcclusionCuller::setupTriangles(std::size_t occluder)
+{
+	thread_local std::vector<glm::vec3> screenPos;
+	thread_local std::vector<bool> valid;
+
+	const std::vector<glm::vec3>& positions = *(*m_occluders)[occluder].positions;
+	const std::vector<std::uint32_t>& indices = *(*m_occluders)[occluder].indices;
+	const glm::mat4& m = m_occluderMatrices[occluder];
+	float w = float(m_width), h = float(m_height);
+
+	screenPos.resize(positions.size());
+	valid.resize(positions.size());
+	for (std::size_t i = 0; i < positions.size(); ++i) {
+		valid[i] = project(m, positions[i], w, h, screenPos[i]);
+	}
+
+	triangle* tris = m_triangles.data() + m_triangleOffsets[occluder];
+	std::size_t count = indices.size() / 3;
+
+	for (std::size_t i = 0; i < count; ++i) {
+		triangle& t = tris[i];
+
+		// marks the triangle as skipped
+		t.minX = 1;
+		t.maxX = 0;
+
+		std::uint32_t i0 = indices[i * 3], i1 = indices[i * 3 + 1], i2 = indices[i * 3 + 2];
+
+		// clipping would be more accurate, but leaving the triangle out never hides anything by mistake
+		if (!(valid[i0] && valid[i1] && valid[i2]))
+			continue;
+
+		const glm::vec3& v0 = screenPos[i0];
+		const glm::vec3& v1 = screenPos[i1];
+		const glm::vec3& v2 = screenPos[i2];
+
+		glm::vec3 vmin = glm::min(glm::min(v0, v1), v2);
+		glm::vec3 vmax = glm::max(glm::max(v0, v1), v2);
+
+		if (vmin.z > 1.0f)
+			continue;
+
+		// pixels whose center is inside the bounding rectangle
+		t.minX = glm::max(int(glm::ceil(vmin.x - 0.5f)), 0);
+		t.minY = glm::max(int(glm::ceil(vmin.y - 0.5f)), 0);
+		t.maxX = glm::min(int(glm::floor(vmax.x - 0.5f)), int(m_width) - 1);
+		t.maxY = glm::min(int(glm::floor(vmax.y - 0.5f)), int(m_height) - 1);
+
+		float area = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+		if (glm::abs(area) < 1e-8f || t.minY > t.maxY) {
+			t.minX = 1;
+			t.maxX = 0;
+			continue;
+		}
+
+		// both windings are drawn, occluders do not have to be closed
+		float s = (area > 0.0f) ? 1.0f : -1.0f;
+		const glm::vec3* v[3] = { &v0, &v1, &v2 };
+		for (unsigned int e = 0; e < 3; ++e) {
+			const glm::vec3& a = *v[(e + 1) % 3];
+			const glm::vec3& b = *v[(e + 2) % 3];
+			t.edge[e] = s * glm::vec3(a.y - b.y, b.x - a.x, a.x * b.y - a.y * b.x);
+		}
+
+		float dzdx = ((v1.z - v0.z) * (v2.y - v0.y) - (v2.z - v0.z) * (v1.y - v0.y)) / area;
+		float dzdy = ((v2.z - v0.z) * (v1.x - v0.x) - (v1.z - v0.z) * (v2.x - v0.x)) / area;
+		t.depth = { dzdx, dzdy, v0.z - dzdx * v0.x - dzdy * v0.y };
+	}
+}
+
+void OcclusionCuller::rasterizeBand(unsigned int minY, unsigned int maxY)
+{
+	std::fill(m_depth.begin() + minY * m_width, m_depth.begin() + maxY * m_width, 1.0f);
+
+	const __m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+	const __m128 zero = _mm_setzero_ps();
+
+	for (const triangle& t : m_triangles) {
+		if (t.minX > t.maxX || t.maxY < int(minY) || t.minY >= int(maxY))
+			continue;
+
+		int y0 = glm::max(t.minY, int(minY));
+		int y1 = glm::min(t.maxY, int(maxY) - 1);
+
+		// the width is a multiple of the block size, so groups of four pixels never leave the row
+		int x0 = t.minX & ~3;
+		__m128 px = _mm_add_ps(_mm_set1_ps(float(x0)), offsets);
+
+		__m128 a0 = _mm_set1_ps(t.edge[0].x), a1 = _mm_set1_ps(t.edge[1].x), a2 = _mm_set1_ps(t.edge[2].x), az = _mm_set1_ps(t.depth.x);
+		__m128 step0 = _mm_set1_ps(t.edge[0].x * 4.0f), step1 = _mm_set1_ps(t.edge[1].x * 4.0f), step2 = _mm_set1_ps(t.edge[2].x * 4.0f);
+		__m128 stepZ = _mm_set1_ps(t.depth.x * 4.0f);
+
+		// depth of the plane is clamped to [0, 1], pixels at the border of the triangle can be slightly outside of it
+		const __m128 zMax = _mm_set1_ps(1.0f);
+
+		for (int y = y0; y <= y1; ++y) {
+			float fy = float(y) + 0.5f;
+
+			__m128 e0 = _mm_add_ps(_mm_mul_ps(a0, px), _mm_set1_ps(t.edge[0].y * fy + t.edge[0].z));
+			__m128 e1 = _mm_add_ps(_mm_mul_ps(a1, px), _mm_set1_ps(t.edge[1].y * fy + t.edge[1].z));
+			__m128 e2 = _mm_add_ps(_mm_mul_ps(a2, px), _mm_set1_ps(t.edge[2].y * fy + t.edge[2].z));
+			__m128 z = _mm_add_ps(_mm_mul_ps(az, px), _mm_set1_ps(t.depth.y * fy + t.depth.z));
+
+			float* row = &m_depth[y * m_width];
+
+			for (int x = x0; x <= t.maxX; x += 4) {
+				__m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+
+				if (_mm_movemask_ps(inside)) {
+					__m128 old = _mm_loadu_ps(row + x);
+					__m128 nz = _mm_min_ps(old, _mm_min_ps(_mm_max_ps(z, zero), zMax));
+					_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nz), _mm_andnot_ps(inside, old)));
+				}
+
+				e0 = _mm_add_ps(e0, step0);
+				e1 = _mm_add_ps(e1, step1);
+				e2 = _mm_add_ps(e2, step2);
+				z = _mm_add_ps(z, stepZ);
+			}
+		}
+	}
+}
+
+void OcclusionCuller::updateBlocks(unsigned int minBlockY, unsigned int maxBlockY)
+{
+	for (unsigned int by = minBlockY; by < maxBlockY; ++by) {
+		for (unsigned int bx = 0; bx < m_blocksX; ++bx) {
+			float farthest = 0.0f;
+
+			for (unsigned int y = by * block_size; y < (by + 1) * block_size; ++y) {
+				const float* row = &m_depth[y * m_width + bx * block_size];
+				for (unsigned int x = 0; x < block_size; ++x) {
+					farthest = glm::max(farthest, row[x]);
+				}
+			}
+
+			m_blockMax[by * m_blocksX + bx] = farthest;
+		}
+	}
+}
@@ -0,0 +1,74 @@
+#ifndef OCCLUSIONCULLER_HPP
+#define OCCLUSIONCULLER_HPP
+
+#include "util/bounds.hpp"
+
+#include "glm.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// software occlusion culling
+// occluder triangles are rasterized into a small depth buffer on the CPU (in parallel horizontal bands, four pixels at a time),
+// then the screen rectangle and nearest depth of an object's bounds are tested against it.
+// every 8x8 block also stores its farthest depth, so most tests never look at single pixels.
+// the culler works on plain triangle lists and does not touch GL (RenderEngine reads the occluder meshes back).
+class OcclusionCuller
+{
+public:
+	static const unsigned int block_size = 8;
+
+	// model space triangles, the geometry has to stay valid until render() returns
+	struct occluder
+	{
+		glm::mat4 model;
+		const std::vector<glm::vec3>* positions;
+		const std::vector<std::uint32_t>* indices;
+	};
+
+	// the size is rounded up to a multiple of the block size
+	OcclusionCuller(unsigned int width, unsigned int height);
+
+	// clears the depth buffer and rasterizes the occluders
+	void render(const std::vector<occluder>& occluders, const glm::mat4& viewProj);
+
+	// false if the bounds are completely hidden behind the occluders rendered last
+	bool isVisible(const obb& bounds) const;
+
+	unsigned int width() const { return m_width; }
+	unsigned int height() const { return m_height; }
+
+	// window space depth, 1 where no occluder was drawn
+	float depth(unsigned int x, unsigned int y) const { return m_depth[y * m_width + x]; }
+
+	// triangles rasterized and time spent in render() (milliseconds) during the last frame
+	std::size_t triangleCount() const { return m_triangleCount; }
+	double renderTime() const { return m_renderTime; }
+
+private:
+	// screen space triangle, edge functions are positive inside
+	struct triangle
+	{
+		glm::vec3 edge[3]; // a * x + b * y + c
+		glm::vec3 depth; // z = a * x + b * y + c
+		int minX, minY, maxX, maxY;
+	};
+
+	unsigned int m_width, m_height, m_blocksX, m_blocksY;
+	std::vector<float> m_depth, m_blockMax;
+	glm::mat4 m_viewProj;
+
+	const std::vector<occluder>* m_occluders; // during render()
+	std::vector<glm::mat4> m_occluderMatrices;
+	std::vector<std::size_t> m_triangleOffsets;
+	std::vector<triangle> m_triangles;
+
+	std::size_t m_triangleCount;
+	double m_renderTime;
+
+	void setupTriangles(std::size_t occluder);
+	void rasterizeBand(unsigned int minY, unsigned int maxY);
+	void updateBlocks(unsigned int minBlockY, unsigned int maxBlockY);
+};
+
+#endif // OCCLUSIONCULLER_HPP
@@ -1,7 +1,7 @@
 #ifndef RENDERBUFFER_HPP
 #define RENDERBUFFER_HPP
 
-#include "GL/glew.h"
+#include "gl_dispatch.hpp"
 #include "texture/pixel_types.hpp"
 #include "RenderTarget.hpp"
 
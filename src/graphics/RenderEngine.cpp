@@ -4,26 +4,39 @@
 #include "core/Scene.hpp"
 #include "core/Entity.hpp"
 #include "core/Transform.hpp"
+#include "core/component_registry.hpp"
 #include "core/ObjectRegistry.hpp"
 #include "core/app_info.hpp"
 #include "Material.hpp"
 #include "Effect.hpp"
 #include "shader/Shader.hpp"
 #include "shader/ShaderProgram.hpp"
+#include "shader/shader_preprocessor.hpp"
 #include "Renderer.hpp"
+#include "MeshRenderer.hpp"
+#include "Mesh.hpp"
 #include "Camera.hpp"
 #include "Light.hpp"
 #include "texture/Texture2D.hpp"
 #include "texture/RenderTexture.hpp"
+#include "texture/texture_residency.hpp"
+#include "texture/texture_streaming.hpp"
 #include "FrameBuffer.hpp"
 #include "ImageEffect.hpp"
 #include "util/intersection_tests.hpp"
+#include "util/parallel.hpp"
+#include "util/projection.hpp"
+#include "util/profiler.hpp"
+#include "util/sort_depth.hpp"
 #include "scripting/class_registry.hpp"
 
 #include "boost/format.hpp"
-#include "GL/glew.h"
+#include "gl_state.hpp"
 
-#define NUM_AUX_BUFFERS 2
+#include <chrono>
+#include <cmath>
+
+#define LIGHT_TILE_SIZE 16
 
 #define DEF_UNIFORM_ID(name) const uniform_id g_##name##_id = uniform_name_to_id(#name)
 
@@ -54,6 +67,17 @@ DEF_UNIFORM_ID(gbuf_diffuse);
 DEF_UNIFORM_ID(gbuf_specSmooth);
 DEF_UNIFORM_ID(gbuf_normal);
 DEF_UNIFORM_ID(gbuf_depth);
+DEF_UNIFORM_ID(gbuf_uv_scale);
+DEF_UNIFORM_ID(lightCount);
+DEF_UNIFORM_ID(renderSize);
+
+// shadows
+DEF_UNIFORM_ID(cm_shadow_atlas);
+DEF_UNIFORM_ID(cm_shadow_count);
+DEF_UNIFORM_ID(cm_shadow_mat);
+DEF_UNIFORM_ID(cm_shadow_rect);
+DEF_UNIFORM_ID(cm_shadow_splits);
+DEF_UNIFORM_ID(cm_shadow_cam_dir);
 
 // Deferred Debugger parameters
 DEF_UNIFORM_ID(mode);
@@ -63,13 +87,29 @@ DEF_UNIFORM_ID(farPlane);
 // Image Effect parameters
 DEF_UNIFORM_ID(img_source);
 DEF_UNIFORM_ID(img_resolution);
+DEF_UNIFORM_ID(img_uv_scale);
+
 
+keyword_helper<RenderEngine::gbuffer_layout> RenderEngine::s_gBufLayouts({
+	{ "standard",	gbuf_standard },
+	{ "octahedral",	gbuf_octahedral },
+	{ "packed",		gbuf_packed },
+	{ "thin",		gbuf_thin }
+});
 
 RenderEngine::RenderEngine(Engine* parent)
-	: m_parent(parent), m_camera(nullptr), m_lightMeshVAO(0), m_fsQuadVAO(0), m_currentSourceBuf(nullptr),
-	m_deferredAmbientPass(nullptr), m_deferredLightPass(nullptr),
-	m_enableDeferred(true), m_enableViewFrustumCulling(true),
-	m_outputMode(output_default), m_avgLightsPerObj(0.0f), m_triangleCount(0)
+	: m_parent(parent), m_camera(nullptr), m_lightMeshVAO(0), m_lightInstanceVAO(0), m_fsQuadVAO(0),
+	m_gBufDiff(RenderGraph::invalid_resource), m_gBufSpec(RenderGraph::invalid_resource), m_gBufNorm(RenderGraph::invalid_resource), m_gBufDepth(RenderGraph::invalid_resource),
+	m_accBuffer(RenderGraph::invalid_resource), m_gFrameBufferTargets(), m_gFrameBufferVersion(0),
+	m_deferredAmbientPass(nullptr), m_deferredLightPass(nullptr), m_deferredTiledPass(nullptr), m_deferredInstancedPass(nullptr),
+	m_dynamicResolution(
+		app_info::get<double>("dynamicResolutionTarget", 16.6),
+		app_info::get<float>("dynamicResolutionMin", 0.5f),
+		app_info::get<float>("dynamicResolutionMax", 1.0f),
+		app_info::get<float>("dynamicResolutionHysteresis", 0.1f)),
+	m_renderWidth(0), m_renderHeight(0), m_cpuFrameTime(0.0),
+	m_enableDeferred(true), m_enableTiledLighting(false), m_enableLightInstancing(true), m_enableLightScissor(true), m_depthBoundsSupported(false), m_enableViewFrustumCulling(true), m_enableOcclusionCulling(true), m_enableDepthPrepass(false), m_enableDynamicResolution(false),
+	m_outputMode(output_default), m_gBufLayout(gbuf_standard), m_avgLightsPerObj(0.0f), m_triangleCount(0), m_drawCount(0), m_prepassDrawCount(0), m_lightPixelsSaved(0), m_fwdLightPassesSaved(0), m_occlusionCulledCount(0)
 {
 #ifdef _DEBUG
 	glEnable(GL_DEBUG_OUTPUT);
@@ -78,8 +118,33 @@ RenderEngine::RenderEngine(Engine* parent)
 	glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, GL_FALSE);
 #endif
 
+	gl_state::set_enabled(app_info::get<bool>("glStateCache", true));
+
 	int mfl = app_info::get<int>("maxForwardLights", 8);
 	m_maxFwdLights = (mfl < 0) ? std::numeric_limits<unsigned int>::max() : mfl;
+	m_fwdLightThreshold = app_info::get<float>("forwardLightThreshold", 0.01f);
+	setDepthSortBuckets(app_info::get<unsigned int>("depthSortBuckets", 8));
+
+	auto gBufLayoutName = app_info::get<std::string>("gBufferLayout", "standard");
+	if (!s_gBufLayouts.get(gBufLayoutName, m_gBufLayout)) {
+		std::cout << "WARNING: unknown G-buffer layout \"" << gBufLayoutName << "\", using standard layout" << std::endl;
+	}
+
+	// the shaders encode and decode the G-buffer accordingly
+	shader_preprocessor::setGlobalDefine("GBUF_LAYOUT", std::to_string(int(m_gBufLayout)));
+	shader_preprocessor::setGlobalDefine("LIGHT_TILE_SIZE", std::to_string(LIGHT_TILE_SIZE));
+
+	m_enableTiledLighting = app_info::get<bool>("tiledLighting", false);
+	m_enableLightInstancing = app_info::get<bool>("instancedLights", true);
+	m_enableLightScissor = app_info::get<bool>("lightScissor", true);
+	m_depthBoundsSupported = GLEW_EXT_depth_bounds_test != GL_FALSE;
+
+	m_enableOcclusionCulling = app_info::get<bool>("occlusionCulling", true);
+	m_enableDepthPrepass = app_info::get<bool>("forwardDepthPrepass", false);
+	m_enableDynamicResolution = app_info::get<bool>("dynamicResolution", false);
+	m_occlusionCuller = std::make_unique<OcclusionCuller>(
+		app_info::get<unsigned int>("occlusionBufferWidth", 256),
+		app_info::get<unsigned int>("occlusionBufferHeight", 128));
 
 	setupDeferredPath();
 	createDefaultResources();
@@ -89,38 +154,27 @@ RenderEngine::RenderEngine(Engine* parent)
 
 void RenderEngine::setupDeferredPath()
 {
-	m_gBufDiff = std::make_unique<Texture2D>();
-	m_gBufDiff->setParams(false, filter_point, wrap_clampToEdge);
-
-	m_gBufSpec = std::make_unique<Texture2D>();
-	m_gBufSpec->setParams(false, filter_point, wrap_clampToEdge);
-
-	m_gBufNorm = std::make_unique<Texture2D>();
-	m_gBufNorm->setParams(false, filter_point, wrap_clampToEdge);
-
-	m_gBufDepth = std::make_unique<Texture2D>();
-	m_gBufDepth->setParams(false, filter_point, wrap_clampToEdge);
-
-	m_accBuffer = std::make_unique<RenderTexture>();
-	m_accBuffer->setParams(false, filter_bilinear, wrap_clampToEdge);
+	// the G-buffer textures come from the render graph, they are attached before the geometry pass
+	m_gFrameBuffer = std::make_unique<FrameBuffer>();
 
-	for (unsigned int i = 0; i < NUM_AUX_BUFFERS; ++i) {
-		m_auxBuffers.push_back(std::make_unique<RenderTexture>());
-		m_auxBuffers[i]->setParams(false, filter_bilinear, wrap_clampToEdge);
+	if (m_parent->isHeadless()) {
+		m_screenBuffer = std::make_unique<RenderTexture>();
+		m_screenBuffer->setParams(false, filter_point, wrap_clampToEdge);
 	}
 
 	onResize(m_parent->screenWidth(), m_parent->screenHeight());
 
-	FrameBuffer::target_array gTargets;
-	gTargets.push_back(make_tex2D_tgt(m_gBufDiff.get()));
-	gTargets.push_back(make_tex2D_tgt(m_gBufSpec.get()));
-	gTargets.push_back(make_tex2D_tgt(m_gBufNorm.get()));
-
-	m_gFrameBuffer = std::make_unique<FrameBuffer>();
-	m_gFrameBuffer->setTargetsDepth(make_tex2D_tgt(m_gBufDepth.get()), std::move(gTargets));
-
 	createCombinedLightMesh();
 
+	if (app_info::get<bool>("shadows", true)) {
+		m_shadowMaps = std::make_unique<ShadowMaps>(
+			app_info::get<unsigned int>("shadowAtlasSize", 4096),
+			app_info::get<unsigned int>("shadowMapSize", 1024),
+			app_info::get<unsigned int>("shadowCascades", 4),
+			app_info::get<float>("shadowDistance", 100.0f),
+			app_info::get<float>("shadowCasterDistance", 100.0f));
+	}
+
 	auto lightEffectName = app_info::get<std::string>("deferredLightEffect", "deferred_light");
 	m_deferredLightEffect = Content::instance()->getFromDisk<Effect>(lightEffectName);
 
@@ -128,6 +182,8 @@ void RenderEngine::setupDeferredPath()
 		m_deferredAmbientPass = m_deferredLightEffect->getPass("ambient");
 		m_deferredLightPass = m_deferredLightEffect->getPass("light");
 		m_deferredDebugPass = m_deferredLightEffect->getPass("debug");
+		m_deferredTiledPass = m_deferredLightEffect->getPass("tiled");
+		m_deferredInstancedPass = m_deferredLightEffect->getPass("instanced");
 
 		if (!m_deferredAmbientPass) {
 			std::cout << "WARNING: could not initialize deferred ambient pass!" << std::endl;
@@ -136,6 +192,17 @@ void RenderEngine::setupDeferredPath()
 		if (!m_deferredLightPass) {
 			std::cout << "WARNING: could not initialize deferred light pass!" << std::endl;
 		}
+
+		// requires compute shaders (GL 4.3), the light volumes are used otherwise
+		if (!(m_deferredTiledPass && m_deferredTiledPass->program && m_deferredTiledPass->program->isGood())) {
+			std::cout << "WARNING: tiled deferred lighting is not available!" << std::endl;
+			m_deferredTiledPass = nullptr;
+		}
+
+		if (!(m_deferredInstancedPass && m_deferredInstancedPass->program && m_deferredInstancedPass->program->isGood())) {
+			std::cout << "WARNING: could not initialize instanced deferred light pass!" << std::endl;
+			m_deferredInstancedPass = nullptr;
+		}
 	} else {
 		std::cout << "WARNING: could not initialize deferred light effect!" << std::endl;
 	}
@@ -162,8 +229,8 @@ void RenderEngine::createCombinedLightMesh()
 		b+0, b+1, b+2,
 		b+2, b+1, b+3
 	});
-	m_quadOffset = sizeof(unsigned int) * baseIndex;
-	m_quadCount = indices.size() - baseIndex;
+	m_lightVolumeOffset[volume_quad] = sizeof(unsigned int) * baseIndex;
+	m_lightVolumeCount[volume_quad] = indices.size() - baseIndex;
 
 
 	// generate sphere
@@ -223,18 +290,58 @@ void RenderEngine::createCombinedLightMesh()
 		});
 	}
 
-	m_sphereOffset = sizeof(unsigned int) * baseIndex;
-	m_sphereCount = indices.size() - baseIndex;
+	m_lightVolumeOffset[volume_sphere] = sizeof(unsigned int) * baseIndex;
+	m_lightVolumeCount[volume_sphere] = indices.size() - baseIndex;
+
+
+	// generate cone (tip at the origin, base with radius 1 at z = -1)
+	baseIndex = indices.size();
+	b = unsigned int(vertices.size());
+
+	const unsigned int coneSectors = 16;
+	// adjust radius so the base polygon encompasses the circle
+	const float cr = 1.0f / cosf(glm::pi<float>() / coneSectors);
+	m_coneMeshRadius = cr;
+
+	vertices.push_back({ 0.f, 0.f, 0.f });
+	vertices.push_back({ 0.f, 0.f, -1.f });
+	rb = b + 2;
+	for (unsigned int si = 0; si < coneSectors; ++si) {
+		float phi = (glm::two_pi<float>() * si) / coneSectors;
+		vertices.push_back({ cr * cosf(phi), cr * sinf(phi), -1.f });
+
+		unsigned int sn = (si < (coneSectors - 1)) ? (si + 1) : 0;
+		indices.insert(indices.end(), {
+			b, rb + si, rb + sn,
+			b + 1, rb + sn, rb + si
+		});
+	}
+
+	m_lightVolumeOffset[volume_cone] = sizeof(unsigned int) * baseIndex;
+	m_lightVolumeCount[volume_cone] = indices.size() - baseIndex;
 
 	m_lightMeshVbuf.setData(vertices.size(), vertices.data());
 	m_lightMeshIbuf.setData(indices.size(), indices.data());
 
 	glGenVertexArrays(1, &m_lightMeshVAO);
-	glBindVertexArray(m_lightMeshVAO);
+	gl_state::bind_vertex_array(m_lightMeshVAO);
+	glEnableVertexAttribArray(0);
+	m_lightMeshVbuf.bind();
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
+
+	// same mesh, with the light data as per instance attributes (pointers are set per batch)
+	glGenVertexArrays(1, &m_lightInstanceVAO);
+	gl_state::bind_vertex_array(m_lightInstanceVAO);
 	glEnableVertexAttribArray(0);
 	m_lightMeshVbuf.bind();
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
-	glBindVertexArray(0);
+
+	for (GLuint i = 1; i <= 8; ++i) {
+		glEnableVertexAttribArray(i);
+		glVertexAttribDivisor(i, 1);
+	}
+
+	gl_state::bind_vertex_array(0);
 }
 
 void RenderEngine::createPPResources()
@@ -251,14 +358,18 @@ void main()
 }
 )vs";
 
+	// img_uv_scale selects the rendered part of a larger texture (see RenderEngine::renderScale()),
+	// clamped half a texel inside so bilinear filtering does not pick up the unused part
 	std::string fs = R"fs(
 #version 330
 uniform sampler2D img_source;
+uniform vec4 img_resolution;
+uniform vec2 img_uv_scale;
 in vec2 uv;
 layout(location = 0) out vec4 f_output;
 void main()
 {
-	f_output = texture(img_source, uv);
+	f_output = texture(img_source, min(uv * img_uv_scale, img_uv_scale - 0.5 * img_resolution.zw));
 }
 )fs";
 
@@ -301,13 +412,13 @@ void main()
 	m_fsQuadVbuf.setData(fsQuadVertices.size(), fsQuadVertices.data());
 
 	glGenVertexArrays(1, &m_fsQuadVAO);
-	glBindVertexArray(m_fsQuadVAO);
+	gl_state::bind_vertex_array(m_fsQuadVAO);
 	m_fsQuadVbuf.bind();
 	glEnableVertexAttribArray(0);
 	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 24, 0);
 	glEnableVertexAttribArray(1);
 	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 24, (const void*)16);
-	glBindVertexArray(0);
+	gl_state::bind_vertex_array(0);
 }
 
 void RenderEngine::createDefaultResources()
@@ -319,6 +430,7 @@ void RenderEngine::createDefaultResources()
 	texWhite->setParams(false, filter_point, wrap_repeat);
 	texWhite->setData(&pw, 1, 1);
 	texWhite->setName("white");
+	texWhite->makeImmutable();
 	objReg->add(std::move(texWhite));
 
 	pixel::srgb pb{ 0U, 0U, 0U };
@@ -326,19 +438,116 @@ void RenderEngine::createDefaultResources()
 	texBlack->setParams(false, filter_point, wrap_repeat);
 	texBlack->setData(&pb, 1, 1);
 	texBlack->setName("black");
+	texBlack->makeImmutable();
 	objReg->add(std::move(texBlack));
 }
 
 RenderEngine::~RenderEngine()
 {
 	if (m_lightMeshVAO) {
+		gl_state::forget_vertex_array(m_lightMeshVAO);
 		glDeleteVertexArrays(1, &m_lightMeshVAO);
 	}
+	if (m_lightInstanceVAO) {
+		gl_state::forget_vertex_array(m_lightInstanceVAO);
+		glDeleteVertexArrays(1, &m_lightInstanceVAO);
+	}
 	if (m_fsQuadVAO) {
+		gl_state::forget_vertex_array(m_fsQuadVAO);
 		glDeleteVertexArrays(1, &m_fsQuadVAO);
 	}
 }
 
+void RenderEngine::createGBuffer()
+{
+	using desc = RenderGraph::texture_desc;
+
+	switch (m_gBufLayout) {
+	case gbuf_standard:
+		m_gBufDiff = m_renderGraph.createTexture("gBufDiffuse", desc::make<pixel::rgb8>(m_width, m_height, filter_point, false));
+		m_gBufSpec = m_renderGraph.createTexture("gBufSpecular", desc::make<pixel::rgba8>(m_width, m_height, filter_point, false));
+		m_gBufNorm = m_renderGraph.createTexture("gBufNormal", desc::make<pixel::rgb10a2>(m_width, m_height, filter_point, false));
+		break;
+
+	case gbuf_octahedral:
+		m_gBufDiff = m_renderGraph.createTexture("gBufDiffuse", desc::make<pixel::rgb8>(m_width, m_height, filter_point, false));
+		m_gBufSpec = m_renderGraph.createTexture("gBufSpecular", desc::make<pixel::rgba8>(m_width, m_height, filter_point, false));
+		m_gBufNorm = m_renderGraph.createTexture("gBufNormal", desc::make<pixel::rg16>(m_width, m_height, filter_point, false));
+		break;
+
+	// the packed layouts keep the specular color with the diffuse color
+	case gbuf_packed:
+		m_gBufDiff = m_renderGraph.createTexture("gBufDiffuse", desc::make<pixel::rgba8>(m_width, m_height, filter_point, false));
+		m_gBufNorm = m_renderGraph.createTexture("gBufNormal", desc::make<pixel::rgba16>(m_width, m_height, filter_point, false));
+		break;
+
+	case gbuf_thin:
+		m_gBufDiff = m_renderGraph.createTexture("gBufDiffuse", desc::make<pixel::rgba8>(m_width, m_height, filter_point, false));
+		m_gBufNorm = m_renderGraph.createTexture("gBufNormal", desc::make<pixel::rgb10a2>(m_width, m_height, filter_point, false));
+		break;
+	}
+
+	m_gBufDepth = m_renderGraph.createTexture("gBufDepth", desc::make<pixel::depth24>(m_width, m_height, filter_point, false));
+}
+
+void RenderEngine::setupGFrameBuffer()
+{
+	std::array<const Texture2D*, 4> targets = {
+		gBufferTexture(m_gBufDiff), gBufferTexture(m_gBufSpec), gBufferTexture(m_gBufNorm), gBufferTexture(m_gBufDepth)
+	};
+
+	// the pool hands out the same textures every frame, unless it created or deleted some
+	if ((targets == m_gFrameBufferTargets) && (m_gFrameBufferVersion == m_renderGraph.poolVersion()))
+		return;
+
+	FrameBuffer::target_array gTargets;
+	for (unsigned int i = 0; i < 3; ++i) {
+		if (targets[i])
+			gTargets.push_back(make_tex2D_tgt(targets[i]));
+	}
+
+	m_gFrameBuffer->setTargetsDepth(make_tex2D_tgt(targets[3]), std::move(gTargets));
+
+	m_gFrameBufferTargets = targets;
+	m_gFrameBufferVersion = m_renderGraph.poolVersion();
+}
+
+Texture2D* RenderEngine::gBufferTexture(RenderGraph::resource res) const
+{
+	return (res != RenderGraph::invalid_resource) ? m_renderGraph.texture(res) : nullptr;
+}
+
+RenderGraph::texture_desc RenderEngine::auxTextureDesc() const
+{
+	return RenderGraph::texture_desc::make<pixel::rgba8>(m_width, m_height, filter_bilinear, true);
+}
+
+void RenderEngine::updateRenderSize()
+{
+	// the render targets keep the screen size, only the viewport shrinks
+	float scale = m_dynamicResolution.scale();
+	m_renderWidth = glm::clamp(int(std::round(m_width * scale)), 1, glm::max(m_width, 1));
+	m_renderHeight = glm::clamp(int(std::round(m_height * scale)), 1, glm::max(m_height, 1));
+}
+
+glm::vec2 RenderEngine::renderScale() const
+{
+	return glm::vec2(float(m_renderWidth) / float(m_width), float(m_renderHeight) / float(m_height));
+}
+
+unsigned int RenderEngine::gBufferBytesPerPixel() const
+{
+	// rgb8 targets are counted as 4 bytes, which is what they occupy on most hardware
+	switch (m_gBufLayout) {
+	case gbuf_packed:
+		return 4 + 8 + 4;
+	case gbuf_thin:
+		return 4 + 4 + 4;
+	default:
+		return 4 + 4 + 4 + 4;
+	}
+}
+
 void RenderEngine::onResize(int width, int height)
 {
 	m_width = width;
@@ -346,20 +555,24 @@ void RenderEngine::onResize(int width, int height)
 
 	glViewport(0, 0, m_width, m_height);
 
-	m_gBufDiff->setData<pixel::rgb8>(nullptr, m_width, m_height);
-	m_gBufSpec->setData<pixel::rgba8>(nullptr, m_width, m_height);
-	m_gBufNorm->setData<pixel::rgb10a2>(nullptr, m_width, m_height);
-	m_gBufDepth->setData<pixel::depth24>(nullptr, m_width, m_height);
+	updateRenderSize();
 
-	m_accBuffer->setData<pixel::rgba16f>(m_width, m_height, RenderTexture::depth_24);
+	// render graph textures are created with the new size when they are needed next
+	m_renderGraph.clearPool();
 
-	for (auto& rt : m_auxBuffers) {
-		rt->setData<pixel::rgba8>(m_width, m_height);
+	if (m_screenBuffer) {
+		// sRGB, so the output matches what would end up in the backbuffer
+		m_screenBuffer->setData<pixel::srgba8>(m_width, m_height);
 	}
 }
 
 void RenderEngine::render()
 {
+	PROFILE_FUNCTION();
+
+	m_drawCount = 0;
+	m_lightPixelsSaved = 0;
+
 	Scene* scene = m_parent->scene();
 	if (scene) {
 		m_clearColor = scene->backColor();
@@ -370,6 +583,13 @@ void RenderEngine::render()
 
 	if (!m_camera || !m_camera->isActiveAndEnabled()) return; // can't render anything without an active camera!
 
+	auto start = std::chrono::high_resolution_clock::now();
+
+	// the scale follows the times of the previous frames
+	if (m_enableDynamicResolution)
+		m_dynamicResolution.update(m_cpuFrameTime, m_gpuTimer.lastTime());
+	updateRenderSize();
+
 	m_objUniforms.setPerFrame(m_camera, float(m_width), float(m_height));
 
 	if (m_enableViewFrustumCulling)
@@ -378,17 +598,72 @@ void RenderEngine::render()
 	// fill light and render queues
 	fillQueues();
 
-	geometryPass();
+	m_gpuTimer.begin();
+
+	shadowPass();
+
+	buildRenderGraph();
+	m_renderGraph.compile();
+	m_renderGraph.execute();
+
+	m_gpuTimer.end();
+
+	m_cpuFrameTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+void RenderEngine::buildRenderGraph()
+{
+	m_renderGraph.reset();
+
+	m_gBufDiff = m_gBufSpec = m_gBufNorm = m_gBufDepth = RenderGraph::invalid_resource;
+
+	m_accBuffer = m_renderGraph.createTexture("accumulation",
+		RenderGraph::texture_desc::make<pixel::rgba16f>(m_width, m_height, filter_bilinear, true, RenderTexture::depth_24));
+
+	if (!m_deferredQueue.empty())
+		createGBuffer();
+
+	std::array<RenderGraph::resource, 4> gBuffer = { m_gBufDiff, m_gBufSpec, m_gBufNorm, m_gBufDepth };
+
+	if (!m_deferredQueue.empty()) {
+		std::size_t geometry = m_renderGraph.addPass("geometry", [this]() {
+			setupGFrameBuffer();
+			glViewport(0, 0, m_renderWidth, m_renderHeight);
+			geometryPass();
+		});
+
+		for (RenderGraph::resource res : gBuffer) {
+			if (res != RenderGraph::invalid_resource)
+				m_renderGraph.write(geometry, res);
+		}
+	}
 
-	m_accBuffer->fbo()->bind();
-	m_accBuffer->fbo()->setClearColor(0, m_clearColor);
-	m_accBuffer->fbo()->clear();
+	std::size_t lighting = m_renderGraph.addPass("lighting", [this]() {
+		FrameBuffer* fbo = m_renderGraph.renderTexture(m_accBuffer)->fbo();
+		fbo->bind();
+		fbo->setClearColor(0, m_clearColor);
+		fbo->clear();
 
-	lightingPass();
+		// the forward pass keeps the viewport
+		glViewport(0, 0, m_renderWidth, m_renderHeight);
+
+		lightingPass();
+	});
 
-	forwardPass();
+	for (RenderGraph::resource res : gBuffer) {
+		if (res != RenderGraph::invalid_resource)
+			m_renderGraph.read(lighting, res);
+	}
+	m_renderGraph.write(lighting, m_accBuffer);
+
+	std::size_t forward = m_renderGraph.addPass("forward", [this]() {
+		m_renderGraph.renderTexture(m_accBuffer)->fbo()->bind();
+		forwardPass();
+	});
+	m_renderGraph.read(forward, m_accBuffer);
+	m_renderGraph.write(forward, m_accBuffer);
 
-	postProcessing();
+	addPostProcessing();
 }
 
 void RenderEngine::getImgEffects()
@@ -416,13 +691,21 @@ void RenderEngine::getImgEffects()
 
 void RenderEngine::fillQueues()
 {
+	PROFILE_FUNCTION();
+
 	unsigned int sampleAcc = 0, sampleCount = 0;
 	m_triangleCount = 0;
 
 	m_lightQueue.clear();
 
+	renderOccluders();
+	bool occlusion = !m_occluders.empty();
+	m_occlusionCulledCount = 0;
+
+	bool streaming = texture_streaming::isEnabled();
+
 	// sort lights by type and priority
-	for (const Light* light : m_lights) {
+	for (const Light* light : component_registry::components<Light>()) {
 		if (!light->isActiveAndEnabled())
 			continue;
 
@@ -432,11 +715,21 @@ void RenderEngine::fillQueues()
 		m_lightQueue.insert(light);
 	}
 
+	// in queue order, so directional and high priority lights get atlas space first
+	m_shadowLights.clear();
+	m_shadowCasters.clear();
+	if (m_shadowMaps) {
+		for (const Light* light : m_lightQueue) {
+			if (light->castShadows()) m_shadowLights.push_back(light);
+		}
+	}
+
 	m_deferredQueue.clear();
 	m_forwardQueue.clear();
+	m_fwdCandidates.clear();
 
 	// sort objects into render paths and fill render queues
-	for (const Renderer* renderer : m_renderers) {
+	for (const Renderer* renderer : component_registry::components<Renderer>()) {
 		if (!(renderer->isActiveAndEnabled() && renderer->isVisible()))
 			continue;
 
@@ -456,17 +749,38 @@ void RenderEngine::fillQueues()
 			if (!obj)
 				continue;
 
+			// shadow casters are collected before culling, they can cast shadows into the view from outside of it
+			if (!m_shadowLights.empty() && (effect->renderType() != type_transparent)) {
+				const Pass* passShadow = effect->getPass(light_shadow_cast);
+				if (passShadow && passShadow->program)
+					m_shadowCasters.push_back({ transform, obj, material, passShadow, getWorldBounds(transform, obj) });
+			}
+
 			// Frustum culling
 			if (m_enableViewFrustumCulling && !checkIntersection(m_viewFrustum, transform, obj))
 				continue;
 
+			obb bounds = getWorldBounds(transform, obj);
+
+			// Occlusion culling
+			if (occlusion && !m_occlusionCuller->isVisible(bounds)) {
+				++m_occlusionCulledCount;
+				continue;
+			}
+
+			if (streaming)
+				requestTextureLevels(transform, obj, material, bounds);
+
 			m_triangleCount += obj->triangles();
 
+			bool transparent = effect->renderType() == type_transparent;
+			unsigned int depth = getSortDepth(bounds.center, transparent);
+
 			// if the object is not transparent and has a deferred pass, put it into deferred queue (deferred pass will be ignored in transparent effects)
-			if (m_enableDeferred && (effect->renderType() != type_transparent)) {
+			if (m_enableDeferred && !transparent) {
 				const Pass* passDeferred = effect->getPass(light_deferred);
 				if (passDeferred && passDeferred->program) {
-					m_deferredQueue.insert({ transform, obj, material, passDeferred, nullptr });
+					m_deferredQueue.insert({ transform, obj, material, passDeferred, nullptr, depth });
 					continue;
 				}
 			}
@@ -474,43 +788,216 @@ void RenderEngine::fillQueues()
 			// if not, check if forward pass is present
 			const Pass* passFwdBase = effect->getPass(light_forward_base);
 			if (passFwdBase && passFwdBase->program) {
-				const Light* firstLight = nullptr;
+				const Pass* passFwdAdd = effect->getPass(light_forward_add);
+				if (!(passFwdAdd && passFwdAdd->program)) passFwdAdd = nullptr;
 
-				auto lit = m_lightQueue.begin();
-				if (!m_lightQueue.empty()) firstLight = *lit;
-				++lit;
+				m_fwdCandidates.push_back({ transform, obj, material, passFwdBase, passFwdAdd, 0, 0, depth });
+				continue;
+			}
 
-				m_forwardQueue.insert({ transform, obj, material, passFwdBase, firstLight });
+			// skip it otherwise (something probably went wrong while initializing this object)
+		}
+	}
 
-				unsigned int lc = 1;
+	selectForwardLights();
 
-				// fill forward queue with limited amount of lights per object
-				const Pass* passFwdAdd = effect->getPass(light_forward_add);
-				if (passFwdAdd && passFwdAdd->program) {
-					while ((lc <= m_maxFwdLights) && (lit != m_lightQueue.end())) {
-						if (checkIntersection(*lit, transform, obj)) {
-							m_forwardQueue.insert({ transform, obj, material, passFwdAdd, *lit });
-							++lc;
-						}
-						++lit;
-					}
-				}
+	// fill forward queue, the most important light goes into the base pass
+	m_fwdLightPassesSaved = 0;
+	std::size_t maxLights = maxLightsPerObject();
 
-				sampleAcc += lc;
-				++sampleCount;
+	for (std::size_t i = 0; i < m_fwdCandidates.size(); ++i) {
+		const forward_candidate& c = m_fwdCandidates[i];
+		const Light* const* lights = m_fwdLights.data() + i * maxLights;
 
+		m_forwardQueue.insert({ c.transform, c.obj, c.material, c.passBase, (c.lightCount > 0) ? lights[0] : nullptr, c.depth });
+
+		for (std::size_t l = 1; l < c.lightCount; ++l) {
+			m_forwardQueue.insert({ c.transform, c.obj, c.material, c.passAdd, lights[l], c.depth });
+		}
+
+		sampleAcc += unsigned int(std::max(c.lightCount, std::size_t(1)));
+		++sampleCount;
+		m_fwdLightPassesSaved += c.skippedCount;
+	}
+
+	m_avgLightsPerObj = float(sampleAcc) / float(sampleCount);
+}
+
+unsigned int RenderEngine::getSortDepth(const glm::vec3& worldPos, bool transparent) const
+{
+	float depth = -(m_objUniforms.view * glm::vec4(worldPos, 1.0f)).z;
+	return sort_depth(depth, m_camera->nearPlane(), m_camera->farPlane(), m_depthSortBuckets, transparent);
+}
+
+void RenderEngine::requestTextureLevels(const Transform* transform, const Drawable* obj, const Material* material, const obb& bounds) const
+{
+	const auto& textures = material->textures();
+	if (textures.empty())
+		return;
+
+	float uvDensity = obj->uvDensity();
+	if (uvDensity <= 0.0f) {
+		// unknown, assume the UVs span the object once
+		glm::vec3 size = obj->bounds().extents() * 2.0f;
+		uvDensity = 1.0f / glm::max(glm::max(size.x, size.y), glm::max(size.z, 1e-4f));
+	}
+
+	// the largest scale stretches the texels the most, so it needs the finest levels
+	glm::vec3 scale = glm::abs(transform->scale());
+	float worldDensity = uvDensity / glm::max(glm::max(scale.x, scale.y), glm::max(scale.z, 1e-6f));
+
+	// screen pixels per world unit at the closest point of the bounds
+	float pixelsPerUnit = 0.5f * float(m_renderHeight) * m_objUniforms.proj[1][1];
+	if (m_objUniforms.proj[3][3] == 0.0f) {
+		float dist = glm::length(bounds.center - m_objUniforms.camPos) - glm::length(bounds.extents);
+		pixelsPerUnit /= glm::max(dist, m_camera->nearPlane());
+	}
+
+	for (const Texture2D* texture : textures) {
+		float texels = float(glm::max(texture->width(), texture->height())) * worldDensity;
+		texture_streaming::request(texture, texels / pixelsPerUnit);
+	}
+}
+
+void RenderEngine::renderOccluders()
+{
+	m_occluders.clear();
+	if (!m_enableOcclusionCulling) return;
+
+	for (const MeshRenderer* renderer : component_registry::components<MeshRenderer>()) {
+		if (!renderer->isActiveAndEnabled())
+			continue;
+
+		const Mesh* mesh = renderer->occluderMesh();
+		if (!mesh)
+			continue;
+
+		const Transform* transform = renderer->entity()->transform();
+
+		for (std::size_t i = 0; i < mesh->subMeshCount(); ++i) {
+			const SubMesh* subMesh = mesh->getSubMesh(i);
+
+			// occluders outside of the view cannot hide anything
+			if (m_enableViewFrustumCulling && !checkIntersection(m_viewFrustum, transform, subMesh))
 				continue;
+
+			const occluder_geometry& geometry = getOccluderGeometry(subMesh);
+			m_occluders.push_back({ transform->getMatrix(), &geometry.positions, &geometry.indices });
+		}
+	}
+
+	if (!m_occluders.empty())
+		m_occlusionCuller->render(m_occluders, m_objUniforms.vp);
+}
+
+const RenderEngine::occluder_geometry& RenderEngine::getOccluderGeometry(const SubMesh* mesh)
+{
+	auto it = m_occluderGeometry.find(mesh);
+	if (it == m_occluderGeometry.end()) {
+		it = m_occluderGeometry.emplace(mesh, occluder_geometry()).first;
+		mesh->readGeometry(it->second.positions, it->second.indices);
+	}
+
+	return it->second;
+}
+
+std::size_t RenderEngine::maxLightsPerObject() const
+{
+	// base pass light and up to m_maxFwdLights additive lights per object
+	// (compared first, m_maxFwdLights + 1 overflows for "unlimited" where size_t is 32 bits)
+	return (m_maxFwdLights >= m_lightQueue.size()) ? m_lightQueue.size() : std::size_t(m_maxFwdLights) + 1;
+}
+
+void RenderEngine::selectForwardLights()
+{
+	PROFILE_FUNCTION();
+
+	std::size_t maxLights = maxLightsPerObject();
+	m_fwdLights.resize(m_fwdCandidates.size() * maxLights);
+
+	parallel_for(m_fwdCandidates.size(), 32, [this, maxLights](std::size_t begin, std::size_t end) {
+		std::vector<std::pair<float, const Light*>> scored;
+
+		for (std::size_t i = begin; i < end; ++i) {
+			forward_candidate& c = m_fwdCandidates[i];
+
+			scored.clear();
+			for (const Light* light : m_lightQueue) {
+				float importance = lightImportance(light, c.transform, c.obj);
+				if (importance > 0.0f) scored.push_back({ importance, light });
 			}
 
-			// skip it otherwise (something probably went wrong while initializing this object)
+			// bounded top-k, most important first
+			std::size_t k = std::min(c.passAdd ? maxLights : std::size_t(1), scored.size());
+			std::partial_sort(scored.begin(), scored.begin() + k, scored.end(),
+				[](const std::pair<float, const Light*>& a, const std::pair<float, const Light*>& b) { return a.first > b.first; });
+
+			const Light** lights = m_fwdLights.data() + i * maxLights;
+			c.lightCount = 0;
+			while (c.lightCount < k && scored[c.lightCount].first >= m_fwdLightThreshold) {
+				lights[c.lightCount] = scored[c.lightCount].second;
+				++c.lightCount;
+			}
+
+			// the base pass is drawn anyway, only additive passes are saved
+			c.skippedCount = k - std::max(c.lightCount, std::min(k, std::size_t(1)));
+		}
+	});
+}
+
+void RenderEngine::shadowPass()
+{
+	PROFILE_FUNCTION();
+
+	if (!m_shadowMaps) return;
+
+	m_shadowMaps->update(m_shadowLights, m_shadowCasters, { m_objUniforms.view, m_objUniforms.proj, m_camera->nearPlane(), m_camera->farPlane() });
+
+	// only views that moved or whose casters changed, everything else is still in the atlas
+	const auto& views = m_shadowMaps->dirtyViews();
+	if (views.empty()) return;
+
+	m_shadowMaps->frameBuffer()->bind();
+	gl_state::enable(GL_SCISSOR_TEST, true);
+
+	uniforms_per_obj camUniforms = m_objUniforms;
+	const float clearDepth = 1.0f;
+
+	for (const auto& view : views) {
+		glViewport(view.rect.x, view.rect.y, view.rect.z, view.rect.w);
+		glScissor(view.rect.x, view.rect.y, view.rect.z, view.rect.w);
+
+		gl_state::depth_mask(true);
+		glClearBufferfv(GL_DEPTH, 0, &clearDepth);
+
+		m_objUniforms.vp = view.viewProj;
+
+		for (std::size_t ci : view.casters) {
+			const ShadowMaps::caster& c = m_shadowCasters[ci];
+			const ShaderProgram* program = c.pass->program;
+
+			updateRenderState(c.pass->state);
+			program->bind();
+
+			m_objUniforms.setPerObject(c.transform);
+			m_objUniforms.apply(program);
+
+			c.obj->bind();
+			c.obj->draw();
+			++m_drawCount;
 		}
 	}
 
-	m_avgLightsPerObj = float(sampleAcc) / float(sampleCount);
+	m_objUniforms = camUniforms;
+
+	gl_state::enable(GL_SCISSOR_TEST, false);
+	glViewport(0, 0, m_width, m_height);
 }
 
 void RenderEngine::geometryPass()
 {
+	PROFILE_FUNCTION();
+
 	if (m_deferredQueue.empty()) return;
 
 	m_gFrameBuffer->bind();
@@ -552,15 +1039,18 @@ void RenderEngine::geometryPass()
 		}
 
 		curObj->draw();
+		++m_drawCount;
 	}
 }
 
 void RenderEngine::lightingPass()
 {
+	PROFILE_FUNCTION();
+
 	if (m_deferredQueue.empty()) return;
 	if (!(m_deferredAmbientPass && m_deferredAmbientPass->program)) return;
 
-	glBindVertexArray(m_lightMeshVAO);
+	gl_state::bind_vertex_array(m_lightMeshVAO);
 	m_lightMeshIbuf.bind();
 
 	auto ap = m_deferredAmbientPass;
@@ -582,26 +1072,218 @@ void RenderEngine::lightingPass()
 
 	if (!(m_deferredLightPass && m_deferredLightPass->program) || m_outputMode) return;
 
+	if (m_enableTiledLighting && m_deferredTiledPass) {
+		tiledLightingPass();
+	} else if (m_enableLightInstancing && m_deferredInstancedPass) {
+		instancedLightingPass();
+	} else {
+		deferredLightPass(false);
+		return;
+	}
+
+	// shadowed lights need their own shadow uniforms, so the batched paths leave them to the per light pass
+	if (!m_shadowLights.empty())
+		deferredLightPass(true);
+}
+
+void RenderEngine::deferredLightPass(bool shadowedOnly)
+{
 	// Render normal lights
+	gl_state::bind_vertex_array(m_lightMeshVAO);
+	m_lightMeshIbuf.bind();
+
+	const ShaderProgram* program = m_deferredLightPass->program;
 	bindDeferredLightPass(m_deferredLightPass);
-	applyAmbient(false, m_deferredLightPass->program);
+	applyAmbient(false, program);
+
+	for (const Light* light : m_lightQueue) {
+		if (shadowedOnly && !getShadow(light))
+			continue;
+
+		applyLight(light, program);
+		applyShadow(light, program);
+		setLightScissor(light);
+		drawDeferredLight(light, program);
+	}
+
+	setLightScissor(nullptr);
+}
+
+void RenderEngine::tiledLightingPass()
+{
+	PROFILE_FUNCTION();
+
+	m_lightData.clear();
+	for (const Light* light : m_lightQueue) {
+		if (getShadow(light)) continue;
+
+		light_data data;
+		data.atten = glm::vec4(0.f);
+		light->getUniforms(data.color, data.dir, data.atten, data.spot);
+		m_lightData.push_back(data);
+	}
+
+	if (m_lightData.empty()) return;
+
+	m_lightBuffer.setData(m_lightData.size(), m_lightData.data(), GL_DYNAMIC_DRAW);
+
+	const ShaderProgram* program = m_deferredTiledPass->program;
+	program->bind();
+	program->setUniform(g_cm_mat_ivp_id, m_objUniforms.ivp);
+	program->setUniform(g_cm_cam_pos_id, m_objUniforms.camPos);
+	program->setUniform(g_lightCount_id, GLuint(m_lightData.size()));
+	program->setUniform(g_renderSize_id, glm::ivec2(m_renderWidth, m_renderHeight));
+	setGBufferTextures(program);
+
+	gl_state::bind_buffer_base(GL_SHADER_STORAGE_BUFFER, 0, m_lightBuffer.glObj());
+
+	// the lights are added to the ambient light already in the accumulation buffer
+	glBindImageTexture(0, m_renderGraph.texture(m_accBuffer)->glObj(), 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA16F);
+
+	glDispatchCompute((m_renderWidth + LIGHT_TILE_SIZE - 1) / LIGHT_TILE_SIZE, (m_renderHeight + LIGHT_TILE_SIZE - 1) / LIGHT_TILE_SIZE, 1);
+
+	// the forward pass blends into the result, post processing samples it
+	glMemoryBarrier(GL_FRAMEBUFFER_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+
+	++m_drawCount;
+}
+
+void RenderEngine::instancedLightingPass()
+{
+	PROFILE_FUNCTION();
+
+	// one batch per light volume mesh
+	for (auto& instances : m_lightVolumeInstances) {
+		instances.clear();
+	}
 
 	for (const Light* light : m_lightQueue) {
-		applyLight(light, m_deferredLightPass->program);
-		drawDeferredLight(light, m_deferredLightPass->program);
+		if (getShadow(light)) continue;
+
+		light_instance inst;
+		inst.light.atten = glm::vec4(0.f);
+		light->getUniforms(inst.light.color, inst.light.dir, inst.light.atten, inst.light.spot);
+
+		m_lightVolumeInstances[getLightVolume(light, inst.transform)].push_back(inst);
+	}
+
+	m_lightInstances.clear();
+	for (const auto& instances : m_lightVolumeInstances) {
+		m_lightInstances.insert(m_lightInstances.end(), instances.begin(), instances.end());
+	}
+
+	if (m_lightInstances.empty()) return;
+
+	m_lightInstanceBuf.setData(m_lightInstances.size(), m_lightInstances.data(), GL_STREAM_DRAW);
+
+	gl_state::bind_vertex_array(m_lightInstanceVAO);
+	m_lightMeshIbuf.bind();
+
+	bindDeferredLightPass(m_deferredInstancedPass);
+
+	std::size_t first = 0;
+	for (unsigned int v = 0; v < light_volume_count; ++v) {
+		std::size_t count = m_lightVolumeInstances[v].size();
+		if (count == 0) continue;
+
+		setLightInstanceOffset(first);
+		glDrawElementsInstanced(GL_TRIANGLES, GLsizei(m_lightVolumeCount[v]), GL_UNSIGNED_INT, reinterpret_cast<void*>(m_lightVolumeOffset[v]), GLsizei(count));
+		++m_drawCount;
+
+		first += count;
+	}
+}
+
+void RenderEngine::setLightInstanceOffset(std::size_t first)
+{
+	// instead of a base instance, which requires GL 4.2
+	m_lightInstanceBuf.bind();
+
+	const GLsizei stride = sizeof(light_instance);
+	std::size_t offset = first * sizeof(light_instance);
+
+	for (GLuint i = 0; i < 4; ++i) {
+		glVertexAttribPointer(1 + i, 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(offset + i * sizeof(glm::vec4)));
+	}
+
+	offset += offsetof(light_instance, light);
+	for (GLuint i = 0; i < 4; ++i) {
+		glVertexAttribPointer(5 + i, 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(offset + i * sizeof(glm::vec4)));
+	}
+}
+
+void RenderEngine::depthPrepass()
+{
+	PROFILE_FUNCTION();
+
+	const ShaderProgram* curProgram = nullptr;
+	const Pass* curPass = nullptr;
+	const Material* curMat = nullptr;
+	const Drawable* curObj = nullptr;
+	const Transform* curTransform = nullptr;
+
+	// one draw per object, the base pass jobs are exactly the objects
+	for (const auto& job : m_forwardQueue) {
+		if (job.lightMode() != light_forward_base)
+			continue;
+
+		const Pass* pass = getDepthPass(job);
+		if (!pass)
+			continue;
+
+		if (pass->program != curProgram) {
+			curProgram = pass->program;
+			curProgram->bind();
+			curTransform = nullptr;
+			curMat = nullptr;
+		}
+
+		if (pass != curPass) {
+			curPass = pass;
+			updateRenderState(curPass->state);
+		}
+
+		// only needed by hand written depth passes (alpha testing)
+		if (job.material != curMat) {
+			curMat = job.material;
+			curMat->apply(curProgram);
+		}
+
+		if (job.obj != curObj) {
+			curObj = job.obj;
+			curObj->bind();
+		}
+
+		if (job.transform != curTransform) {
+			curTransform = job.transform;
+			m_objUniforms.setPerObject(curTransform);
+			m_objUniforms.apply(curProgram);
+		}
+
+		curObj->draw();
+		++m_drawCount;
+		++m_prepassDrawCount;
 	}
 }
 
 void RenderEngine::forwardPass()
 {
+	PROFILE_FUNCTION();
+
+	m_prepassDrawCount = 0;
+
 	if (m_forwardQueue.empty()) return;
 
+	if (m_enableDepthPrepass)
+		depthPrepass();
+
 	const ShaderProgram* curProgram = nullptr;
 	const Pass* curPass = nullptr;
 	const Material* curMat = nullptr;
 	const Light* curLight = nullptr;
 	const Drawable* curObj = nullptr;
 	const Transform* curTransform = nullptr;
+	bool curPrepassed = false;
 
 	for (const auto& job : m_forwardQueue) {
 		if (job.program() != curProgram) {
@@ -612,9 +1294,23 @@ void RenderEngine::forwardPass()
 			curLight = nullptr;
 		}
 
-		if (job.pass != curPass) {
+		bool prepassed = m_enableDepthPrepass && getDepthPass(job);
+
+		if (job.pass != curPass || prepassed != curPrepassed) {
 			curPass = job.pass;
-			updateRenderState(curPass->state);
+			curPrepassed = prepassed;
+
+			if (prepassed) {
+				// the depth buffer already holds the visible surface, anything else is rejected before shading
+				RenderState state = curPass->state;
+				state.depthTestEnable = true;
+				state.depthTestFunction = RenderState::cmp_equal;
+				state.depthWriteEnable = false;
+				updateRenderState(state);
+			} else {
+				updateRenderState(curPass->state);
+			}
+
 			applyAmbient(curPass->mode == light_forward_base, curProgram);
 		}
 
@@ -640,33 +1336,87 @@ void RenderEngine::forwardPass()
 		}
 
 		curObj->draw();
+		++m_drawCount;
 	}
 }
 
-void RenderEngine::postProcessing()
+const Pass* RenderEngine::getDepthPass(const render_job& job) const
 {
-	if (m_activeImgEffects.size() == 0) {
-		// if no image effects are active, just copy the accumulation buffer to the backbuffer
-		setConvertToSRGB(true);
-		blit(m_accBuffer.get(), nullptr);
-	} else {
-		RenderTexture* input = m_accBuffer.get();
-		RenderTexture* output = m_auxBuffers[0].get();
+	const Effect* effect = job.effect();
+	if (!effect->hasDepthPrepass() || (effect->renderType() == type_transparent))
+		return nullptr;
 
-		for (unsigned int i = 0; i < m_activeImgEffects.size(); ++i) {
-			m_currentSourceBuf = input;
-			if (i == m_activeImgEffects.size() - 1)
-				output = nullptr; // the last image effect should write directly into the backbuffer
+	const Pass* pass = effect->getPass(light_depth_only);
+	return (pass && pass->program) ? pass : nullptr;
+}
 
+void RenderEngine::addPostProcessing()
+{
+	// post processing runs at screen resolution
+	if (m_activeImgEffects.size() == 0) {
+		// if no image effects are active, just copy (and upscale) the accumulation buffer to the backbuffer
+		std::size_t present = m_renderGraph.addPass("present", [this]() {
+			glViewport(0, 0, m_width, m_height);
 			setConvertToSRGB(true);
-			m_activeImgEffects[i]->apply(input, output);
+			blitScaled(m_renderGraph.texture(m_accBuffer), nullptr, m_copyMat.get(), 0, renderScale());
+		});
+		m_renderGraph.read(present, m_accBuffer);
+		m_renderGraph.setOutput(present);
+		return;
+	}
+
+	RenderGraph::resource input = m_accBuffer;
+
+	// image effects expect their input to fill the whole texture
+	if ((m_renderWidth != m_width) || (m_renderHeight != m_height)) {
+		RenderGraph::resource upscaled = m_renderGraph.createTexture("upscaled",
+			RenderGraph::texture_desc::make<pixel::rgba16f>(m_width, m_height, filter_bilinear, true));
 
-			std::swap(input, output);
+		std::size_t upscale = m_renderGraph.addPass("upscale", [this, upscaled]() {
+			glViewport(0, 0, m_width, m_height);
+			blitScaled(m_renderGraph.texture(m_accBuffer), m_renderGraph.renderTexture(upscaled), m_copyMat.get(), 0, renderScale());
+		});
+		m_renderGraph.read(upscale, m_accBuffer);
+		m_renderGraph.write(upscale, upscaled);
+
+		input = upscaled;
+	}
+
+	for (unsigned int i = 0; i < m_activeImgEffects.size(); ++i) {
+		ImageEffect* imgEffect = m_activeImgEffects[i];
+
+		// the last image effect should write directly into the backbuffer
+		if (i == m_activeImgEffects.size() - 1) {
+			std::size_t pass = m_renderGraph.addPass("imageEffect", [this, imgEffect, input]() {
+				glViewport(0, 0, m_width, m_height);
+				setConvertToSRGB(true);
+				imgEffect->apply(m_renderGraph.texture(input), nullptr);
+			});
+			m_renderGraph.read(pass, input);
+			m_renderGraph.setOutput(pass);
+			break;
 		}
+
+		RenderGraph::resource output = m_renderGraph.createTexture("imageEffect", auxTextureDesc());
+
+		std::size_t pass = m_renderGraph.addPass("imageEffect", [this, imgEffect, input, output]() {
+			glViewport(0, 0, m_width, m_height);
+			setConvertToSRGB(true);
+			imgEffect->apply(m_renderGraph.texture(input), m_renderGraph.renderTexture(output));
+		});
+		m_renderGraph.read(pass, input);
+		m_renderGraph.write(pass, output);
+
+		input = output;
 	}
 }
 
 void RenderEngine::blit(const Texture2D* source, const RenderTexture* dest, const Material* material, std::size_t passIndex)
+{
+	blitScaled(source, dest, material, passIndex, glm::vec2(1.0f));
+}
+
+void RenderEngine::blitScaled(const Texture2D* source, const RenderTexture* dest, const Material* material, std::size_t passIndex, const glm::vec2& uvScale)
 {
 	if (!material)
 		material = m_copyMat.get();
@@ -678,7 +1428,7 @@ void RenderEngine::blit(const Texture2D* source, const RenderTexture* dest, cons
 			if (dest) {
 				dest->fbo()->bind();
 			} else {
-				FrameBuffer::unbind();
+				bindScreen();
 			}
 
 			pass->program->bind();
@@ -692,56 +1442,78 @@ void RenderEngine::blit(const Texture2D* source, const RenderTexture* dest, cons
 					source->width(), source->height(), 1.f / source->width(), 1.f / source->height()
 				});
 			}
+			pass->program->setUniform(g_img_uv_scale_id, uvScale);
 
-			glBindVertexArray(m_fsQuadVAO);
+			gl_state::bind_vertex_array(m_fsQuadVAO);
 			glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+			++m_drawCount;
 		}
 	}
 }
 
-const RenderTexture* RenderEngine::getAuxRenderTexture()
+void RenderEngine::bindScreen()
 {
-	for (auto& rt : m_auxBuffers) {
-		if (rt.get() != m_currentSourceBuf) { // avoid returning currently used source buffer
-			return rt.get();
-		}
+	if (m_screenBuffer) {
+		m_screenBuffer->fbo()->bind();
+	} else {
+		FrameBuffer::unbind();
 	}
-	return nullptr;
 }
 
-void RenderEngine::setConvertToSRGB(bool l)
+const RenderTexture* RenderEngine::getAuxRenderTexture()
 {
-	if (l) {
-		glEnable(GL_FRAMEBUFFER_SRGB);
-	} else {
-		glDisable(GL_FRAMEBUFFER_SRGB);
-	}
+	// never the input or output of the running pass, it goes back to the pool when the pass is done
+	return m_renderGraph.scratchTexture(auxTextureDesc());
 }
 
-void RenderEngine::addComponent(Component* cmpt)
+void RenderEngine::setConvertToSRGB(bool l)
 {
-	auto r = dynamic_cast<Renderer*>(cmpt);
-	if (r) {
-		m_renderers.push_back(r);
-	}
-
-	auto l = dynamic_cast<Light*>(cmpt);
-	if (l) {
-		m_lights.push_back(l);
-	}
+	gl_state::enable(GL_FRAMEBUFFER_SRGB, l);
 }
 
-void RenderEngine::removeComponent(Component* cmpt)
+float RenderEngine::lightImportance(const Light* light, const Transform* transform, const Drawable* obj) const
 {
-	auto r = dynamic_cast<Renderer*>(cmpt);
-	if (r) {
-		m_renderers.erase(std::remove(m_renderers.begin(), m_renderers.end(), r), m_renderers.end());
-	}
+	glm::vec3 color = glm::vec3(light->color()) * light->intensity();
+	float luminance = glm::dot(color, glm::vec3(0.2126f, 0.7152f, 0.0722f));
+
+	if (light->type() == Light::type_directional) return luminance;
+
+	const Transform* lTrans = light->entity()->transform();
+
+	// light position and direction relative to renderer's coordinate system (without scale)
+	glm::mat4 toLocal = transform->getInverseRigidMatrix();
+	glm::vec3 lPos(toLocal * glm::vec4(lTrans->position(), 1.0f));
+
+	aabb rBounds = obj->bounds();
+	rBounds *= transform->scale();
 
-	auto l = dynamic_cast<Light*>(cmpt);
-	if (l) {
-		m_lights.erase(std::remove(m_lights.begin(), m_lights.end(), l), m_lights.end());
+	// attenuation at the point of the bounds closest to the light (same falloff as light_attenuation in lighting.glh)
+	glm::vec3 closest = glm::clamp(lPos, rBounds.min, rBounds.max);
+	float sqrDist = glm::dot(closest - lPos, closest - lPos);
+	float range = light->range();
+	float atten = glm::clamp(1.0f - sqrDist / (range * range), 0.0f, 1.0f);
+	atten *= atten;
+
+	if (atten <= 0.0f || light->type() != Light::type_spot) return luminance * atten;
+
+	// spot factor at the smallest angle between the spot direction and the bounding sphere of the object
+	glm::vec3 spotDir(toLocal * glm::vec4(lTrans->rotation() * glm::vec3(0.0f, 0.0f, -1.0f), 0.0f));
+	glm::vec3 toObj = rBounds.center() - lPos;
+	float dist = glm::length(toObj);
+	float radius = glm::length(rBounds.extents());
+
+	float angle = 0.0f;
+	if (dist > radius) {
+		float cosAngle = glm::clamp(glm::dot(toObj / dist, spotDir), -1.0f, 1.0f);
+		angle = glm::max(acosf(cosAngle) - asinf(radius / dist), 0.0f);
 	}
+
+	float ca = cosf(glm::radians(light->spotAngle()));
+	float cf = cosf(glm::radians(light->spotAngle() * light->spotFalloff()));
+	float f = glm::min(cosf(angle) - cf, 0.0f) / (ca - cf);
+	float spot = glm::clamp(1.0f - f * f, 0.0f, 1.0f);
+
+	return luminance * atten * spot;
 }
 
 bool RenderEngine::checkIntersection(const Light* light, const Transform* transform, const Drawable* obj) const
@@ -765,38 +1537,47 @@ bool RenderEngine::checkIntersection(const Light* light, const Transform* transf
 
 void RenderEngine::computeViewFrustum()
 {
-	for (unsigned int p = 0; p < 3; ++p) {
-		for (unsigned int i = 0; i < 4; ++i) {
-			m_viewFrustum.planes[p*2+0][i] = m_objUniforms.vp[i][3] + m_objUniforms.vp[i][p];
-			m_viewFrustum.planes[p*2+1][i] = m_objUniforms.vp[i][3] - m_objUniforms.vp[i][p];
-		}
-	}
-
-	m_viewFrustum.normalize();
+	m_viewFrustum = extract_frustum(m_objUniforms.vp);
 }
 
-bool RenderEngine::checkIntersection(const frustum& viewFrustum, const Transform* transform, const Drawable* obj) const
+obb RenderEngine::getWorldBounds(const Transform* transform, const Drawable* obj)
 {
 	glm::quat rot = transform->rotation();
 	aabb scaledBounds = obj->bounds() * glm::abs(transform->scale());
 	glm::vec3 rmin = rot * scaledBounds.min, rmax = rot * scaledBounds.max;
-	obb rBounds{
+	return {
 		transform->position() + (rmax + rmin) * 0.5f,
 		scaledBounds.extents(),
 		glm::mat3_cast(rot)
 	};
+}
 
-	return intersect_obb_frustum(rBounds, viewFrustum);
+bool RenderEngine::checkIntersection(const frustum& viewFrustum, const Transform* transform, const Drawable* obj) const
+{
+	return intersect_obb_frustum(getWorldBounds(transform, obj), viewFrustum);
 }
 
 bool RenderEngine::checkIntersection(const frustum& viewFrustum, const Light* light) const
 {
 	if (light->type() == Light::type_directional) return true;
 
+	cone c;
+	if (getSpotCone(light, c))
+		return intersect_cone_frustum(c, viewFrustum);
+
 	const Transform* lTrans = light->entity()->transform();
 	return intersect_sphere_frustum({ lTrans->position(), light->range() }, viewFrustum);
 }
 
+bool RenderEngine::getSpotCone(const Light* light, cone& c) const
+{
+	if (light->type() != Light::type_spot)
+		return false;
+
+	const Transform* lt = light->entity()->transform();
+	return spot_cone_bounds(lt->position(), lt->rotation() * glm::vec3(0.0f, 0.0f, -1.0f), light->range(), light->spotAngle(), c);
+}
+
 void RenderEngine::bindDeferredLightPass(const Pass* pass)
 {
 	updateRenderState(pass->state);
@@ -805,44 +1586,109 @@ void RenderEngine::bindDeferredLightPass(const Pass* pass)
 	program->bind();
 	program->setUniform(g_cm_mat_ivp_id, m_objUniforms.ivp);
 	program->setUniform(g_cm_cam_pos_id, m_objUniforms.camPos);
-	program->setTexture(g_gbuf_diffuse_id, m_gBufDiff.get());
-	program->setTexture(g_gbuf_specSmooth_id, m_gBufSpec.get());
-	program->setTexture(g_gbuf_normal_id, m_gBufNorm.get());
-	program->setTexture(g_gbuf_depth_id, m_gBufDepth.get());
+	setGBufferTextures(program);
+}
+
+void RenderEngine::setGBufferTextures(const ShaderProgram* program)
+{
+	program->setTexture(g_gbuf_diffuse_id, gBufferTexture(m_gBufDiff));
+	program->setTexture(g_gbuf_specSmooth_id, gBufferTexture(m_gBufSpec));
+	program->setTexture(g_gbuf_normal_id, gBufferTexture(m_gBufNorm));
+	program->setTexture(g_gbuf_depth_id, gBufferTexture(m_gBufDepth));
+	program->setUniform(g_gbuf_uv_scale_id, renderScale());
 }
 
 void RenderEngine::drawDeferredLight(const Light* light, const ShaderProgram* program)
 {
 	glm::mat4 transform;
-	auto o = m_quadOffset;
-	auto c = m_quadCount;
+	light_volume v = light ? getLightVolume(light, transform) : volume_quad;
 
-	if (light) {
-		Light::light_type t = light->type();
-
-		if (t != Light::type_directional) {
-			float r = light->range();
-			float lr = r * m_lightMeshRadius;
-			const Transform* lt = light->entity()->transform();
-			glm::vec4 lp = {lt->position(), 1.0f};
-			glm::vec3 lpos = m_objUniforms.view * lp;
-			
-			if ((-lpos.z - lr) > m_camera->nearPlane()) {
-				transform = m_objUniforms.vp * lt->getRigidMatrix() * glm::scale(glm::vec3(r));
-				// TODO: add spot light mesh
-				switch (t) {
-				case Light::type_point:
-				case Light::type_spot:
-					c = m_sphereCount;
-					o = m_sphereOffset;
-					break;
-				}
-			}
-		}
+	program->setUniform(g_transform_id, transform);
+	glDrawElements(GL_TRIANGLES, GLsizei(m_lightVolumeCount[v]), GL_UNSIGNED_INT, reinterpret_cast<void*>(m_lightVolumeOffset[v]));
+	++m_drawCount;
+}
+
+RenderEngine::light_volume RenderEngine::getLightVolume(const Light* light, glm::mat4& transform)
+{
+	// directional lights, and lights with the near plane inside their volume, are drawn as fullscreen quad
+	if (light->type() == Light::type_directional)
+		return volume_quad;
+
+	float r = light->range();
+	const Transform* lt = light->entity()->transform();
+	glm::vec4 lp = {lt->position(), 1.0f};
+	glm::vec3 lpos = m_objUniforms.view * lp;
+
+	cone c;
+	if (getSpotCone(light, c)) {
+		// bounding sphere of the cone mesh around its tip
+		float br = c.radius * m_coneMeshRadius;
+		float lr = glm::sqrt(r * r + br * br);
+
+		if ((-lpos.z - lr) <= m_camera->nearPlane())
+			return getLightQuad(light, transform);
+
+		transform = m_objUniforms.vp * lt->getRigidMatrix() * glm::scale(glm::vec3(c.radius, c.radius, r));
+		return volume_cone;
 	}
 
-	program->setUniform(g_transform_id, transform);
-	glDrawElements(GL_TRIANGLES, GLsizei(c), GL_UNSIGNED_INT, reinterpret_cast<void*>(o));
+	float lr = r * m_lightMeshRadius;
+
+	if ((-lpos.z - lr) <= m_camera->nearPlane())
+		return getLightQuad(light, transform);
+
+	transform = m_objUniforms.vp * lt->getRigidMatrix() * glm::scale(glm::vec3(r));
+	return volume_sphere;
+}
+
+RenderEngine::light_volume RenderEngine::getLightQuad(const Light* light, glm::mat4& transform)
+{
+	if (!m_enableLightScissor)
+		return volume_quad;
+
+	// shrink the fullscreen quad to the screen rectangle of the light
+	std::size_t screenPixels = std::size_t(m_renderWidth) * std::size_t(m_renderHeight);
+	std::size_t pixels = 0;
+	screen_rect rect;
+
+	if (getLightScreenBounds(light, rect)) {
+		transform = glm::translate(glm::vec3(rect.center(), 0.0f)) * glm::scale(glm::vec3(rect.extents(), 1.0f));
+		glm::vec2 size = rect.extents() * glm::vec2(m_renderWidth, m_renderHeight);
+		pixels = glm::min(std::size_t(size.x * size.y), screenPixels);
+	} else {
+		transform = glm::scale(glm::vec3(0.0f));
+	}
+
+	m_lightPixelsSaved += screenPixels - pixels;
+	return volume_quad;
+}
+
+bool RenderEngine::getLightScreenBounds(const Light* light, screen_rect& rect) const
+{
+	const Transform* lt = light->entity()->transform();
+	glm::vec3 center = m_objUniforms.view * glm::vec4(lt->position(), 1.0f);
+
+	return project_sphere_bounds({ center, light->range() }, m_objUniforms.proj, m_camera->nearPlane(), m_camera->farPlane(), rect);
+}
+
+void RenderEngine::setLightScissor(const Light* light)
+{
+	screen_rect rect;
+	bool clip = m_enableLightScissor && light && (light->type() != Light::type_directional) && getLightScreenBounds(light, rect);
+
+	gl_state::enable(GL_SCISSOR_TEST, clip);
+	if (m_depthBoundsSupported) gl_state::enable(GL_DEPTH_BOUNDS_TEST_EXT, clip);
+
+	if (!clip) return;
+
+	// NDC to pixels, rounded outwards
+	glm::vec2 size(m_renderWidth, m_renderHeight);
+	glm::ivec2 min(glm::floor((rect.min * 0.5f + 0.5f) * size));
+	glm::ivec2 max(glm::ceil((rect.max * 0.5f + 0.5f) * size));
+	glScissor(min.x, min.y, max.x - min.x, max.y - min.y);
+
+	// skip pixels whose stored depth is outside the light's range
+	if (m_depthBoundsSupported) glDepthBoundsEXT(rect.minDepth, rect.maxDepth);
 }
 
 void RenderEngine::applyLight(const Light* light, const ShaderProgram* program)
@@ -854,9 +1700,31 @@ void RenderEngine::applyLight(const Light* light, const ShaderProgram* program)
 		program->setUniform(g_cm_light_dir_id, dir);
 		program->setUniform(g_cm_light_atten_id, atten);
 		program->setUniform(g_cm_light_spot_id, spot);
+	} else {
+		// no light (base pass of an object without relevant lights), only ambient
+		program->setUniform(g_cm_light_color_id, glm::vec4(0.f));
 	}
 }
 
+void RenderEngine::applyShadow(const Light* light, const ShaderProgram* program)
+{
+	const ShadowMaps::light_shadow* shadow = getShadow(light);
+	program->setUniform(g_cm_shadow_count_id, shadow ? shadow->viewCount : 0);
+
+	if (shadow) {
+		program->setTexture(g_cm_shadow_atlas_id, m_shadowMaps->atlas());
+		program->setUniform(g_cm_shadow_mat_id, shadow->matrices);
+		program->setUniform(g_cm_shadow_rect_id, shadow->rects);
+		program->setUniform(g_cm_shadow_splits_id, shadow->splits);
+		program->setUniform(g_cm_shadow_cam_dir_id, m_camera->entity()->transform()->rotation() * glm::vec3(0.0f, 0.0f, -1.0f));
+	}
+}
+
+const ShadowMaps::light_shadow* RenderEngine::getShadow(const Light* light) const
+{
+	return m_shadowMaps ? m_shadowMaps->find(light) : nullptr;
+}
+
 void RenderEngine::applyAmbient(bool enabled, const ShaderProgram* program)
 {
 	program->setUniform(g_cm_light_ambient_id, enabled ? m_ambientLight : glm::vec4(0.f));
@@ -864,7 +1732,8 @@ void RenderEngine::applyAmbient(bool enabled, const ShaderProgram* program)
 
 void RenderEngine::updateRenderState(const RenderState& newState)
 {
-	newState.differentialApply(m_renderState);
+	// the state cache skips what is already set, and also catches changes made outside of render states
+	newState.apply();
 	m_renderState = newState;
 }
 
@@ -987,13 +1856,158 @@ SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, screenHeight, RenderEngine)
 SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, isDeferredEnabled, RenderEngine)
 SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, setDeferredEnabled, RenderEngine)
 
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, isTiledLightingEnabled, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, setTiledLightingEnabled, RenderEngine)
+
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, isLightInstancingEnabled, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, setLightInstancingEnabled, RenderEngine)
+
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, isLightScissorEnabled, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, setLightScissorEnabled, RenderEngine)
+
 SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, isVFCEnabled, RenderEngine)
 SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, setVFCEnabled, RenderEngine)
 
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, depthSortBuckets, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, setDepthSortBuckets, RenderEngine)
+
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, isDepthPrepassEnabled, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, setDepthPrepassEnabled, RenderEngine)
+
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, isOcclusionCullingEnabled, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, setOcclusionCullingEnabled, RenderEngine)
+
 SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, outputMode, RenderEngine)
 SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, setOutputMode, RenderEngine)
 
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, gBufferLayout, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, gBufferBytesPerPixel, RenderEngine)
+
 SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, avgLightsPerObj, RenderEngine)
 SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, triangleCount, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, drawCount, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, prepassDrawCount, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, lightPixelsSaved, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, shadowViewCount, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, shadowViewsRendered, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, fwdLightPassesSaved, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, occlusionCulledCount, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, occluderCount, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, occlusionCullingTime, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, renderTargetMemory, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, renderTargetPoolMemory, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, culledPassCount, RenderEngine)
+
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, renderWidth, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, renderHeight, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, isDynamicResolutionEnabled, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, setDynamicResolutionEnabled, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, resolutionScale, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, setResolutionScale, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, minResolutionScale, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, maxResolutionScale, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, setResolutionScaleBounds, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, resolutionTargetTime, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, setResolutionTargetTime, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, resolutionHysteresis, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, setResolutionHysteresis, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, gpuFrameTime, RenderEngine)
+SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, cpuFrameTime, RenderEngine)
 
 SCRIPTING_AUTO_MODULE_METHOD_C(Graphics, setConvertToSRGB, RenderEngine)
+
+SCRIPTING_DEFINE_METHOD(Graphics, glCallCount)
+{
+	scripting::push_value(L, gl_dispatch::call_count(scripting::check_arg<std::string>(L, 1)));
+	return 1;
+}
+
+SCRIPTING_DEFINE_METHOD(Graphics, resetGlCallCounts)
+{
+	gl_dispatch::reset_call_counts();
+	return 0;
+}
+
+SCRIPTING_DEFINE_METHOD(Graphics, isStateCacheEnabled)
+{
+	scripting::push_value(L, gl_state::enabled());
+	return 1;
+}
+
+SCRIPTING_DEFINE_METHOD(Graphics, setStateCacheEnabled)
+{
+	gl_state::set_enabled(scripting::check_arg<bool>(L, 1));
+	return 0;
+}
+
+SCRIPTING_DEFINE_METHOD(Graphics, stateCallsIssued)
+{
+	scripting::push_value(L, gl_state::last_frame().totalIssued());
+	return 1;
+}
+
+SCRIPTING_DEFINE_METHOD(Graphics, stateCallsSkipped)
+{
+	scripting::push_value(L, gl_state::last_frame().totalSkipped());
+	return 1;
+}
+
+SCRIPTING_DEFINE_METHOD(Graphics, isBindlessTextures)
+{
+	scripting::push_value(L, texture_residency::isBindless());
+	return 1;
+}
+
+SCRIPTING_DEFINE_METHOD(Graphics, textureBinds)
+{
+	scripting::push_value(L, texture_residency::lastFrame().unitBinds);
+	return 1;
+}
+
+SCRIPTING_DEFINE_METHOD(Graphics, textureHandleUpdates)
+{
+	scripting::push_value(L, texture_residency::lastFrame().handleUpdates);
+	return 1;
+}
+
+SCRIPTING_DEFINE_METHOD(Graphics, residentTextures)
+{
+	scripting::push_value(L, texture_residency::residentCount());
+	return 1;
+}
+
+SCRIPTING_DEFINE_METHOD(Graphics, isTextureStreamingEnabled)
+{
+	scripting::push_value(L, texture_streaming::isEnabled());
+	return 1;
+}
+
+SCRIPTING_DEFINE_METHOD(Graphics, streamedTextures)
+{
+	scripting::push_value(L, texture_streaming::textureCount());
+	return 1;
+}
+
+SCRIPTING_DEFINE_METHOD(Graphics, streamedTextureMemory)
+{
+	scripting::push_value(L, texture_streaming::residentBytes());
+	return 1;
+}
+
+SCRIPTING_DEFINE_METHOD(Graphics, requestedTextureMemory)
+{
+	scripting::push_value(L, texture_streaming::requestedBytes());
+	return 1;
+}
+
+SCRIPTING_DEFINE_METHOD(Graphics, textureStreamingBudget)
+{
+	scripting::push_value(L, texture_streaming::budget());
+	return 1;
+}
+
+SCRIPTING_DEFINE_METHOD(Graphics, pendingTextureLoads)
+{
+	scripting::push_value(L, texture_streaming::pendingLoads());
+	return 1;
+}
@@ -1,13 +1,16 @@
 #ifndef RENDERENGINE_HPP
 #define RENDERENGINE_HPP
 
-#include "core/ComponentModule.hpp"
-
 #include "util/singleton.hpp"
 
 #include "graphics/Buffer.hpp"
+#include "graphics/DynamicResolution.hpp"
+#include "graphics/GpuTimer.hpp"
 #include "graphics/Light.hpp"
+#include "graphics/OcclusionCuller.hpp"
+#include "graphics/RenderGraph.hpp"
 #include "graphics/RenderState.hpp"
+#include "graphics/ShadowMaps.hpp"
 #include "util/bounds.hpp"
 
 #include "boost/multi_index_container.hpp"
@@ -17,6 +20,9 @@
 #include "boost/multi_index/member.hpp"
 #include "boost/multi_index/mem_fun.hpp"
 
+#include <algorithm>
+#include <array>
+#include <unordered_map>
 #include <unordered_set>
 #include <set>
 #include <vector>
@@ -38,8 +44,9 @@ class Texture2D;
 class FrameBuffer;
 class RenderTexture;
 class ImageEffect;
+class SubMesh;
 
-class RenderEngine : public singleton<RenderEngine>, public ComponentModule
+class RenderEngine : public singleton<RenderEngine>
 {
 public:
 	enum output_mode
@@ -53,6 +60,20 @@ public:
 		output_mode_max
 	};
 
+	// G-buffer render targets (depth is always depth24):
+	// standard:	diffuse rgb8, specular + smoothness rgba8, normal rgb10a2
+	// octahedral:	diffuse rgb8, specular + smoothness rgba8, octahedral normal rg16
+	// packed:		diffuse or specular color rgba8, octahedral normal + smoothness rgba16
+	// thin:		diffuse or specular color rgba8, octahedral normal + smoothness rgb10a2
+	// (see common/gbuffer.glh for the encoding)
+	enum gbuffer_layout
+	{
+		gbuf_standard,
+		gbuf_octahedral,
+		gbuf_packed,
+		gbuf_thin
+	};
+
 	explicit RenderEngine(Engine *parent);
 	~RenderEngine();
 
@@ -62,26 +83,101 @@ public:
 	int screenWidth() const { return m_width; }
 	int screenHeight() const { return m_height; }
 
+	// size of the viewport the scene is rendered into (the screen size scaled by resolutionScale())
+	int renderWidth() const { return m_renderWidth; }
+	int renderHeight() const { return m_renderHeight; }
+
+	// the scene is rendered at a fraction of the screen resolution and upscaled afterwards,
+	// the fraction follows the frame times if dynamic resolution is enabled (see DynamicResolution)
+	bool isDynamicResolutionEnabled() const { return m_enableDynamicResolution; }
+	void setDynamicResolutionEnabled(bool val) { m_enableDynamicResolution = val; }
+
+	// can be set by hand while dynamic resolution is disabled
+	float resolutionScale() const { return m_dynamicResolution.scale(); }
+	void setResolutionScale(float val) { m_dynamicResolution.setScale(val); }
+
+	float minResolutionScale() const { return m_dynamicResolution.minScale(); }
+	float maxResolutionScale() const { return m_dynamicResolution.maxScale(); }
+	void setResolutionScaleBounds(float minScale, float maxScale) { m_dynamicResolution.setScaleBounds(minScale, maxScale); }
+
+	// frame time (milliseconds) dynamic resolution aims for, and how much faster frames have to be before the scale grows again
+	double resolutionTargetTime() const { return m_dynamicResolution.targetTime(); }
+	void setResolutionTargetTime(double val) { m_dynamicResolution.setTargetTime(val); }
+	float resolutionHysteresis() const { return m_dynamicResolution.hysteresis(); }
+	void setResolutionHysteresis(float val) { m_dynamicResolution.setHysteresis(val); }
+
+	// GPU time of the last measured frame and CPU time of the last render() call (milliseconds, GPU time is negative if not measured)
+	double gpuFrameTime() const { return m_gpuTimer.lastTime(); }
+	double cpuFrameTime() const { return m_cpuFrameTime; }
+
 	bool isDeferredEnabled() const { return m_enableDeferred; }
 	void setDeferredEnabled(bool val) { m_enableDeferred = val; }
 
+	// compute shader over screen tiles instead of one light volume per light (if available)
+	bool isTiledLightingEnabled() const { return m_enableTiledLighting; }
+	void setTiledLightingEnabled(bool val) { m_enableTiledLighting = val; }
+
+	// all light volumes in two instanced draws instead of one draw per light (if available)
+	bool isLightInstancingEnabled() const { return m_enableLightInstancing; }
+	void setLightInstancingEnabled(bool val) { m_enableLightInstancing = val; }
+
+	// per light scissor rectangle and depth bounds from the projected light sphere
+	bool isLightScissorEnabled() const { return m_enableLightScissor; }
+	void setLightScissorEnabled(bool val) { m_enableLightScissor = val; }
+
 	bool isVFCEnabled() const { return m_enableViewFrustumCulling; }
 	void setVFCEnabled(bool val) { m_enableViewFrustumCulling = val; }
 
+	// number of front to back buckets opaque objects are sorted into (before they are sorted by state)
+	unsigned int depthSortBuckets() const { return m_depthSortBuckets; }
+	void setDepthSortBuckets(unsigned int val) { m_depthSortBuckets = std::max(val, 1u); }
+
+	// forward rendered objects of effects with a depth pass are drawn into the depth buffer first,
+	// their base and add passes then only shade the visible fragments
+	bool isDepthPrepassEnabled() const { return m_enableDepthPrepass; }
+	void setDepthPrepassEnabled(bool val) { m_enableDepthPrepass = val; }
+
+	// objects hidden behind occluders (see MeshRenderer::isOccluder) are culled on the CPU
+	bool isOcclusionCullingEnabled() const { return m_enableOcclusionCulling; }
+	void setOcclusionCullingEnabled(bool val) { m_enableOcclusionCulling = val; }
+
 	output_mode outputMode() const { return m_outputMode; }
 	void setOutputMode(output_mode val) { m_outputMode = val; }
 
+	gbuffer_layout gBufferLayout() const { return m_gBufLayout; }
+	unsigned int gBufferBytesPerPixel() const;
+
 	float avgLightsPerObj() const { return m_avgLightsPerObj; }
 	std::size_t triangleCount() const { return m_triangleCount; }
+	std::size_t drawCount() const { return m_drawCount; }
+	// draws of the forward depth pre-pass last frame (included in drawCount)
+	std::size_t prepassDrawCount() const { return m_prepassDrawCount; }
+	// additive forward passes skipped last frame because the light's estimated contribution was too small
+	std::size_t fwdLightPassesSaved() const { return m_fwdLightPassesSaved; }
+	// shadow views in use / shadow views whose cached content had to be re-rendered last frame
+	std::size_t shadowViewCount() const { return m_shadowMaps ? m_shadowMaps->viewCount() : 0; }
+	std::size_t shadowViewsRendered() const { return m_shadowMaps ? m_shadowMaps->viewsRendered() : 0; }
+	// objects culled by the occlusion culling last frame, and the time it took to rasterize the occluders (in milliseconds)
+	std::size_t occlusionCulledCount() const { return m_occlusionCulledCount; }
+	std::size_t occluderCount() const { return m_occluders.size(); }
+	double occlusionCullingTime() const { return m_occlusionCuller ? m_occlusionCuller->renderTime() : 0.0; }
+	// pixels of fullscreen light quads cut away by the light scissor rectangles last frame
+	std::size_t lightPixelsSaved() const { return m_lightPixelsSaved; }
+	// bytes of render targets alive at the same time last frame / bytes of all render targets kept by the render graph's pool
+	std::size_t renderTargetMemory() const { return m_renderGraph.peakMemory(); }
+	std::size_t renderTargetPoolMemory() const { return m_renderGraph.poolMemory(); }
+	// render graph passes skipped last frame because nothing used their results
+	std::size_t culledPassCount() const { return m_renderGraph.culledPassCount(); }
 
 	void setConvertToSRGB(bool l);
 
 	void blit(const Texture2D* source, const RenderTexture* dest, const Material* material = nullptr, std::size_t passIndex = 0);
 
+	// temporary render target for image effects, only valid until ImageEffect::apply() returns
 	const RenderTexture* getAuxRenderTexture();
 
-	virtual void addComponent(Component* cmpt) final;
-	virtual void removeComponent(Component* cmpt) final;
+	// final output in headless mode (nullptr if the backbuffer is used)
+	const RenderTexture* screenBuffer() const { return m_screenBuffer.get(); }
 
 	void render();
 
@@ -101,6 +197,28 @@ private:
 		void apply(const ShaderProgram* program) const;
 	};
 
+	// layout of a light in the light buffer of the tiled lighting pass (see common/light_buffer.glh)
+	struct light_data
+	{
+		glm::vec4 color, dir, spot, atten;
+	};
+
+	// mesh used to draw a deferred light
+	enum light_volume
+	{
+		volume_quad = 0,
+		volume_sphere,
+		volume_cone,
+		light_volume_count
+	};
+
+	// per instance vertex attributes of the instanced light pass (see pbr_light_instanced.vert)
+	struct light_instance
+	{
+		glm::mat4 transform;
+		light_data light;
+	};
+
 	struct render_job
 	{
 		const Transform* transform;
@@ -108,6 +226,7 @@ private:
 		const Material* material;
 		const Pass* pass;
 		const Light* light;
+		unsigned int depth; // see sort_depth()
 
 		const Effect* effect() const;
 		int priority() const;
@@ -118,6 +237,7 @@ private:
 	struct deferred_queue_indices : public mi::indexed_by<
 		mi::ordered_non_unique<mi::composite_key<render_job,
 			mi::const_mem_fun<render_job, int, &render_job::priority>,
+			mi::member<render_job, unsigned int, &render_job::depth>,
 			mi::const_mem_fun<render_job, const ShaderProgram*, &render_job::program>,
 			mi::member<render_job, const Pass*, &render_job::pass>,
 			mi::member<render_job, const Material*, &render_job::material>,
@@ -133,6 +253,7 @@ private:
 	struct forward_queue_indices : public mi::indexed_by<
 		mi::ordered_non_unique<mi::composite_key<render_job,
 			mi::const_mem_fun<render_job, int, &render_job::priority>,
+			mi::member<render_job, unsigned int, &render_job::depth>,
 			mi::const_mem_fun<render_job, const ShaderProgram*, &render_job::program>,
 			mi::const_mem_fun<render_job, unsigned int, &render_job::lightMode>,
 			mi::member<render_job, const Pass*, &render_job::pass>,
@@ -158,10 +279,20 @@ private:
 		light_queue_indices
 	>;
 
+	// forward rendered object, its lights are selected after all objects have been collected
+	struct forward_candidate
+	{
+		const Transform* transform;
+		const Drawable* obj;
+		const Material* material;
+		const Pass* passBase;
+		const Pass* passAdd;
+		std::size_t lightCount, skippedCount;
+		unsigned int depth;
+	};
+
 	Engine *m_parent;
 
-	std::vector<const Renderer*> m_renderers;
-	std::vector<const Light*> m_lights;
 
 	std::vector<ImageEffect*> m_imgEffects, m_activeImgEffects;
 
@@ -175,42 +306,94 @@ private:
 	deferred_queue m_deferredQueue;
 	forward_queue m_forwardQueue;
 
+	// the G-buffer and the accumulation buffer are render graph textures, invalid_resource if unused this frame
+	RenderGraph m_renderGraph;
+	RenderGraph::resource m_gBufDiff, m_gBufSpec, m_gBufNorm, m_gBufDepth;
+	RenderGraph::resource m_accBuffer;
+
+	// attached textures and pool version the G-buffer frame buffer was set up with
 	std::unique_ptr<FrameBuffer> m_gFrameBuffer;
-	std::unique_ptr<Texture2D> m_gBufDiff, m_gBufSpec, m_gBufNorm, m_gBufDepth;
+	std::array<const Texture2D*, 4> m_gFrameBufferTargets;
+	std::size_t m_gFrameBufferVersion;
 
-	std::unique_ptr<RenderTexture> m_accBuffer;
-	std::vector<std::unique_ptr<RenderTexture>> m_auxBuffers;
+	std::unique_ptr<RenderTexture> m_screenBuffer;
 
 	std::unique_ptr<Effect> m_deferredLightEffect;
 	const Pass* m_deferredAmbientPass;
 	const Pass* m_deferredLightPass;
 	const Pass* m_deferredDebugPass;
+	const Pass* m_deferredTiledPass;
+	const Pass* m_deferredInstancedPass;
+
+	std::vector<light_data> m_lightData;
+	Buffer<light_data, GL_SHADER_STORAGE_BUFFER> m_lightBuffer;
 
 	GLuint m_lightMeshVAO;
 	VertexBuffer<glm::vec3> m_lightMeshVbuf;
 	IndexBuffer<unsigned int> m_lightMeshIbuf;
-	float m_lightMeshRadius;
-	std::size_t m_quadOffset, m_sphereOffset;
-	std::size_t m_quadCount, m_sphereCount;
+	float m_lightMeshRadius, m_coneMeshRadius;
+	std::size_t m_lightVolumeOffset[light_volume_count];
+	std::size_t m_lightVolumeCount[light_volume_count];
+
+	GLuint m_lightInstanceVAO;
+	VertexBuffer<light_instance> m_lightInstanceBuf;
+	std::vector<light_instance> m_lightInstances;
+	std::vector<light_instance> m_lightVolumeInstances[light_volume_count];
 
 	GLuint m_fsQuadVAO;
 	VertexBuffer<float> m_fsQuadVbuf;
 	std::unique_ptr<Material> m_copyMat;
-	RenderTexture* m_currentSourceBuf;
+
+	DynamicResolution m_dynamicResolution;
+	GpuTimer m_gpuTimer;
+	int m_renderWidth, m_renderHeight;
+	double m_cpuFrameTime;
 
 	light_queue m_lightQueue;
 
+	std::unique_ptr<ShadowMaps> m_shadowMaps;
+	std::vector<const Light*> m_shadowLights;
+	std::vector<ShadowMaps::caster> m_shadowCasters;
+
+	// occluder meshes are read back from the GPU the first time they are used
+	struct occluder_geometry
+	{
+		std::vector<glm::vec3> positions;
+		std::vector<std::uint32_t> indices;
+	};
+
+	std::unique_ptr<OcclusionCuller> m_occlusionCuller;
+	std::vector<OcclusionCuller::occluder> m_occluders;
+	std::unordered_map<const SubMesh*, occluder_geometry> m_occluderGeometry;
+
 	RenderState m_renderState;
 	uniforms_per_obj m_objUniforms;
 	unsigned int m_maxFwdLights;
+	float m_fwdLightThreshold;
+	unsigned int m_depthSortBuckets;
+	std::vector<forward_candidate> m_fwdCandidates;
+	std::vector<const Light*> m_fwdLights;
 	glm::vec4 m_ambientLight;
 
 	bool m_enableDeferred;
+	bool m_enableTiledLighting;
+	bool m_enableLightInstancing;
+	bool m_enableLightScissor;
+	bool m_depthBoundsSupported;
 	bool m_enableViewFrustumCulling;
+	bool m_enableOcclusionCulling;
+	bool m_enableDepthPrepass;
+	bool m_enableDynamicResolution;
 	output_mode m_outputMode;
+	gbuffer_layout m_gBufLayout;
 
 	float m_avgLightsPerObj;
 	std::size_t m_triangleCount;
+	std::size_t m_drawCount;
+	std::size_t m_prepassDrawCount;
+	std::size_t m_lightPixelsSaved;
+	std::size_t m_fwdLightPassesSaved;
+	std::size_t m_occlusionCulledCount;
 
 
 	void setupDeferredPath();
@@ -220,25 +403,60 @@ private:
 
 	void getImgEffects();
 	void fillQueues();
+	void selectForwardLights();
+	std::size_t maxLightsPerObject() const;
+	void renderOccluders();
+	const occluder_geometry& getOccluderGeometry(const SubMesh* mesh);
+	unsigned int getSortDepth(const glm::vec3& worldPos, bool transparent) const;
+	void requestTextureLevels(const Transform* transform, const Drawable* obj, const Material* material, const obb& bounds) const;
+	void buildRenderGraph();
+	void createGBuffer();
+	void setupGFrameBuffer();
+	Texture2D* gBufferTexture(RenderGraph::resource res) const;
+	RenderGraph::texture_desc auxTextureDesc() const;
+	void updateRenderSize();
+	glm::vec2 renderScale() const;
+	void shadowPass();
 	void geometryPass();
 	void lightingPass();
+	void deferredLightPass(bool shadowedOnly);
+	void tiledLightingPass();
+	void instancedLightingPass();
+	void setLightInstanceOffset(std::size_t first);
+	void depthPrepass();
 	void forwardPass();
-	void postProcessing();
+	const Pass* getDepthPass(const render_job& job) const;
+	void addPostProcessing();
+
+	void blitScaled(const Texture2D* source, const RenderTexture* dest, const Material* material, std::size_t passIndex, const glm::vec2& uvScale);
+	void bindScreen();
 
 	void applyLight(const Light* light, const ShaderProgram* program);
+	void applyShadow(const Light* light, const ShaderProgram* program);
+	const ShadowMaps::light_shadow* getShadow(const Light* light) const;
 	void applyAmbient(bool enabled, const ShaderProgram* program);
 	void updateRenderState(const RenderState& newState);
 	void bindDeferredLightPass(const Pass* pass);
+	void setGBufferTextures(const ShaderProgram* program);
+	light_volume getLightVolume(const Light* light, glm::mat4& transform);
+	light_volume getLightQuad(const Light* light, glm::mat4& transform);
+	bool getLightScreenBounds(const Light* light, screen_rect& rect) const;
+	void setLightScissor(const Light* light);
+	bool getSpotCone(const Light* light, cone& c) const;
 	void drawDeferredLight(const Light* light, const ShaderProgram* program);
 
 	void computeViewFrustum();
 
+	static obb getWorldBounds(const Transform* transform, const Drawable* obj);
 	bool checkIntersection(const Light* light, const Transform* transform, const Drawable* obj) const;
+	float lightImportance(const Light* light, const Transform* transform, const Drawable* obj) const;
 	bool checkIntersection(const frustum& viewFrustum, const Transform* transform, const Drawable* obj) const;
 	bool checkIntersection(const frustum& viewFrustum, const Light* light) const;
 
 
 	// cppcheck-suppress unusedPrivateFunction
+	static keyword_helper<gbuffer_layout> s_gBufLayouts;
+
 	static void debugMessage(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void* userParam);
 	friend void GLAPIENTRY glDbgMsg(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void* userParam);
 
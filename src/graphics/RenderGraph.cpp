@@ -0,0 +1,295 @@
+#include "RenderGraph.hpp"
+#include "FrameBuffer.hpp"
+#include "RenderBuffer.hpp"
+#include "util/profiler.hpp"
+
+#include <algorithm>
+
+namespace
+{
+	// rgb8 is counted as 4 bytes, which is what it occupies on most hardware
+	std::size_t bytes_per_pixel(GLenum format)
+	{
+		switch (format) {
+		case GL_R8:
+			return 1;
+		case GL_DEPTH_COMPONENT16:
+		case GL_RG8:
+			return 2;
+		case GL_RGBA16:
+		case GL_RGBA16F:
+		case GL_RG32F:
+			return 8;
+		case GL_RGBA32F:
+			return 16;
+		default:
+			return 4;
+		}
+	}
+}
+
+std::size_t RenderGraph::texture_desc::bytes() const
+{
+	std::size_t bpp = bytes_per_pixel(imgFormat);
+	if (depthFormat != RenderTexture::depth_none)
+		bpp += bytes_per_pixel(depthFormat);
+
+	return std::size_t(width) * height * bpp;
+}
+
+bool RenderGraph::texture_desc::canAlias(const texture_desc& other) const
+{
+	// the filter mode is only a parameter, and a RenderTexture can stand in for a plain texture
+	return (width == other.width) && (height == other.height)
+		&& (imgFormat == other.imgFormat) && (pxFormat == other.pxFormat) && (pxType == other.pxType)
+		&& (depthFormat == other.depthFormat) && (frameBuffer || !other.frameBuffer);
+}
+
+RenderGraph::RenderGraph(std::size_t keepFrames)
+	: m_keepFrames(keepFrames), m_frame(0), m_currentPass(0), m_culledCount(0),
+	m_liveMemory(0), m_peakMemory(0), m_poolMemory(0), m_poolVersion(0), m_executing(false) { }
+
+void RenderGraph::reset()
+{
+	m_passes.clear();
+	m_resources.clear();
+	m_culledCount = 0;
+}
+
+RenderGraph::resource RenderGraph::createTexture(const std::string& name, const texture_desc& desc)
+{
+	m_resources.push_back({ name, desc, nullptr, 0, 0, 0, 0, false });
+	return m_resources.size() - 1;
+}
+
+RenderGraph::resource RenderGraph::importTexture(const std::string& name, Texture2D* texture)
+{
+	texture_desc desc{};
+	m_resources.push_back({ name, desc, texture, 0, 0, 0, 0, true });
+	return m_resources.size() - 1;
+}
+
+std::size_t RenderGraph::addPass(const std::string& name, pass_func func)
+{
+	m_passes.push_back({ name, std::move(func), {}, {}, {}, 0, false, false });
+	return m_passes.size() - 1;
+}
+
+void RenderGraph::read(std::size_t pass, resource res)
+{
+	m_passes[pass].reads.push_back(res);
+}
+
+void RenderGraph::write(std::size_t pass, resource res)
+{
+	m_passes[pass].writes.push_back(res);
+	// writing something outside of the graph is a visible result
+	if (m_resources[res].imported)
+		m_passes[pass].output = true;
+}
+
+void RenderGraph::setOutput(std::size_t pass)
+{
+	m_passes[pass].output = true;
+}
+
+RenderTexture* RenderGraph::renderTexture(resource res) const
+{
+	const resource_entry& r = m_resources[res];
+	return (r.imported || r.desc.frameBuffer) ? static_cast<RenderTexture*>(r.texture) : nullptr;
+}
+
+void RenderGraph::compile()
+{
+	PROFILE_FUNCTION();
+
+	// a pass is referenced by the textures it writes, a texture by the passes reading it
+	for (pass& p : m_passes) {
+		p.refCount = p.writes.size();
+		p.culled = false;
+	}
+
+	for (resource_entry& r : m_resources) {
+		r.refCount = 0;
+	}
+
+	for (const pass& p : m_passes) {
+		for (resource res : p.reads) {
+			++m_resources[res].refCount;
+		}
+	}
+
+	std::vector<resource> unused;
+	for (resource res = 0; res < m_resources.size(); ++res) {
+		if (m_resources[res].refCount == 0) unused.push_back(res);
+	}
+
+	// remove the writers of unused textures, which may leave the textures they read unused as well
+	while (!unused.empty()) {
+		resource res = unused.back();
+		unused.pop_back();
+
+		for (pass& p : m_passes) {
+			if (p.culled || p.output) continue;
+			if (std::find(p.writes.begin(), p.writes.end(), res) == p.writes.end()) continue;
+
+			if (--p.refCount == 0) {
+				p.culled = true;
+				for (resource r : p.reads) {
+					if (--m_resources[r].refCount == 0) unused.push_back(r);
+				}
+			}
+		}
+	}
+
+	for (const pass& p : m_passes) {
+		if (p.culled) ++m_culledCount;
+	}
+
+	// lifetimes of the transient textures
+	for (resource_entry& r : m_resources) {
+		r.firstPass = m_passes.size();
+		r.lastPass = 0;
+	}
+
+	for (std::size_t i = 0; i < m_passes.size(); ++i) {
+		const pass& p = m_passes[i];
+		if (p.culled) continue;
+
+		for (const auto* list : { &p.reads, &p.writes }) {
+			for (resource res : *list) {
+				resource_entry& r = m_resources[res];
+				r.firstPass = std::min(r.firstPass, i);
+				r.lastPass = std::max(r.lastPass, i);
+			}
+		}
+	}
+}
+
+void RenderGraph::execute()
+{
+	PROFILE_FUNCTION();
+
+	++m_frame;
+	m_liveMemory = 0;
+	m_peakMemory = 0;
+	m_executing = true;
+
+	for (m_currentPass = 0; m_currentPass < m_passes.size(); ++m_currentPass) {
+		pass& p = m_passes[m_currentPass];
+		if (p.culled) continue;
+
+		for (resource_entry& r : m_resources) {
+			if (!r.imported && (r.firstPass == m_currentPass)) {
+				r.pooled = acquire(r.desc);
+				r.texture = m_pool[r.pooled].texture.get();
+			}
+		}
+
+		p.func();
+
+		for (std::size_t index : p.scratch) {
+			release(index);
+		}
+		p.scratch.clear();
+
+		for (resource_entry& r : m_resources) {
+			if (!r.imported && r.texture && (r.lastPass == m_currentPass)) {
+				release(r.pooled);
+				r.texture = nullptr;
+			}
+		}
+	}
+
+	m_executing = false;
+	trimPool();
+}
+
+RenderTexture* RenderGraph::scratchTexture(const texture_desc& desc)
+{
+	if (!m_executing)
+		return nullptr;
+
+	texture_desc rtDesc = desc;
+	rtDesc.frameBuffer = true;
+
+	std::size_t index = acquire(rtDesc);
+	m_passes[m_currentPass].scratch.push_back(index);
+	return static_cast<RenderTexture*>(m_pool[index].texture.get());
+}
+
+void RenderGraph::clearPool()
+{
+	m_pool.clear();
+	m_poolMemory = 0;
+	++m_poolVersion;
+}
+
+std::size_t RenderGraph::acquire(const texture_desc& desc)
+{
+	// a free texture of the same kind is preferred, so plain textures don't take the frame buffers needed later on
+	std::size_t index = m_pool.size();
+	for (std::size_t i = 0; i < m_pool.size(); ++i) {
+		const pool_entry& e = m_pool[i];
+		if (e.inUse || !e.desc.canAlias(desc)) continue;
+
+		index = i;
+		if (e.desc.frameBuffer == desc.frameBuffer) break;
+	}
+
+	if (index == m_pool.size()) {
+		std::unique_ptr<Texture2D> texture;
+		if (desc.frameBuffer) {
+			auto rt = std::make_unique<RenderTexture>();
+			rt->setParams(false, desc.filtering, wrap_clampToEdge);
+			rt->setData(desc.width, desc.height, desc.imgFormat, desc.pxFormat, desc.pxType, desc.depthFormat);
+			texture = std::move(rt);
+		} else {
+			texture = std::make_unique<Texture2D>();
+			texture->setParams(false, desc.filtering, wrap_clampToEdge);
+			texture->setData(nullptr, desc.width, desc.height, desc.imgFormat, desc.pxFormat, desc.pxType);
+		}
+
+		m_pool.push_back({ std::move(texture), desc, 0, false });
+		m_poolMemory += desc.bytes();
+		++m_poolVersion;
+	}
+
+	pool_entry& e = m_pool[index];
+	if (e.desc.filtering != desc.filtering) {
+		e.texture->setParams(false, desc.filtering, wrap_clampToEdge);
+		e.desc.filtering = desc.filtering;
+	}
+
+	e.inUse = true;
+	e.lastFrame = m_frame;
+
+	m_liveMemory += e.desc.bytes();
+	m_peakMemory = std::max(m_peakMemory, m_liveMemory);
+
+	return index;
+}
+
+void RenderGraph::release(std::size_t index)
+{
+	pool_entry& e = m_pool[index];
+	e.inUse = false;
+	m_liveMemory -= e.desc.bytes();
+}
+
+void RenderGraph::trimPool()
+{
+	auto it = std::remove_if(m_pool.begin(), m_pool.end(), [this](const pool_entry& e) {
+		return !e.inUse && (m_frame - e.lastFrame > m_keepFrames);
+	});
+
+	if (it != m_pool.end()) {
+		m_pool.erase(it, m_pool.end());
+		++m_poolVersion;
+
+		m_poolMemory = 0;
+		for (const pool_entry& e : m_pool) {
+			m_poolMemory += e.desc.bytes();
+		}
+	}
+}
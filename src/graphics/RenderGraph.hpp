@@ -0,0 +1,137 @@
+#ifndef RENDERGRAPH_HPP
+#define RENDERGRAPH_HPP
+
+#include "texture/RenderTexture.hpp"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// the render targets of one frame
+// passes declare which textures they read and write, passes whose results are never used are culled.
+// transient textures only exist from the first to the last pass using them, they are taken from a pool
+// and handed back as soon as their last pass is done, so textures whose lifetimes don't overlap share the same memory.
+// the graph is built again every frame, the pool is kept.
+class RenderGraph
+{
+public:
+	using resource = std::size_t;
+	using pass_func = std::function<void()>;
+
+	static const resource invalid_resource = resource(-1);
+
+	struct texture_desc
+	{
+		unsigned int width, height;
+		GLint imgFormat;
+		GLenum pxFormat, pxType;
+		RenderTexture::depth_format depthFormat;
+		Texture2D::filter filtering;
+		bool frameBuffer; // a RenderTexture with its own frame buffer, otherwise a plain Texture2D
+
+		template<typename T>
+		static texture_desc make(unsigned int w, unsigned int h, Texture2D::filter filtering, bool frameBuffer,
+			RenderTexture::depth_format depthFmt = RenderTexture::depth_none)
+		{
+			return { w, h, image_format<T>(), pixel_format<T>(), pixel_type<T>(), depthFmt, filtering, frameBuffer };
+		}
+
+		std::size_t bytes() const;
+
+		// whether a texture created for this can be used for other as well
+		bool canAlias(const texture_desc& other) const;
+	};
+
+	// pool textures that stay unused for this many frames are deleted
+	explicit RenderGraph(std::size_t keepFrames = 3);
+
+	// forgets the passes and resources of the last frame
+	void reset();
+
+	resource createTexture(const std::string& name, const texture_desc& desc);
+	// texture that lives outside of the graph, passes writing it are never culled
+	resource importTexture(const std::string& name, Texture2D* texture);
+
+	std::size_t addPass(const std::string& name, pass_func func);
+	void read(std::size_t pass, resource res);
+	void write(std::size_t pass, resource res);
+	// the pass has results outside of the graph (e.g. it draws into the backbuffer), it is never culled
+	void setOutput(std::size_t pass);
+
+	// culls the unused passes and computes the lifetimes of the transient textures
+	void compile();
+	// runs the remaining passes, allocating and releasing the transient textures around them
+	void execute();
+
+	// only valid while a pass using the resource is executed
+	Texture2D* texture(resource res) const { return m_resources[res].texture; }
+	RenderTexture* renderTexture(resource res) const;
+
+	// texture that is only needed inside of the running pass, it goes back to the pool when the pass is done
+	// (nullptr outside of execute())
+	RenderTexture* scratchTexture(const texture_desc& desc);
+
+	// changes whenever the pool creates or deletes textures (frame buffers holding graph textures have to be set up again)
+	std::size_t poolVersion() const { return m_poolVersion; }
+
+	// deletes all pooled textures (e.g. after the screen was resized)
+	void clearPool();
+
+	std::size_t passCount() const { return m_passes.size(); }
+	std::size_t culledPassCount() const { return m_culledCount; }
+
+	// bytes of transient textures alive at the same time during the last frame
+	std::size_t peakMemory() const { return m_peakMemory; }
+	// bytes of all textures in the pool
+	std::size_t poolMemory() const { return m_poolMemory; }
+	std::size_t poolSize() const { return m_pool.size(); }
+
+private:
+	struct pass
+	{
+		std::string name;
+		pass_func func;
+		std::vector<resource> reads, writes;
+		std::vector<std::size_t> scratch;
+		std::size_t refCount;
+		bool output;
+		bool culled;
+	};
+
+	struct resource_entry
+	{
+		std::string name;
+		texture_desc desc;
+		Texture2D* texture;
+		std::size_t pooled;
+		std::size_t refCount;
+		std::size_t firstPass, lastPass;
+		bool imported;
+	};
+
+	struct pool_entry
+	{
+		std::unique_ptr<Texture2D> texture;
+		texture_desc desc;
+		std::size_t lastFrame;
+		bool inUse;
+	};
+
+	std::vector<pass> m_passes;
+	std::vector<resource_entry> m_resources;
+	std::vector<pool_entry> m_pool;
+
+	std::size_t m_keepFrames, m_frame;
+	std::size_t m_currentPass;
+	std::size_t m_culledCount;
+	std::size_t m_liveMemory, m_peakMemory, m_poolMemory;
+	std::size_t m_poolVersion;
+	bool m_executing;
+
+	std::size_t acquire(const texture_desc& desc);
+	void release(std::size_t index);
+	void trimPool();
+};
+
+#endif // RENDERGRAPH_HPP
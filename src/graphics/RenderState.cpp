@@ -4,6 +4,7 @@
 json_interpreter<RenderState> RenderState::s_properties({
 	{ "cull",			&RenderState::extractCull },
 	{ "depthTest",		&RenderState::extractDepthTest },
+	{ "colorWrite",		&RenderState::extractColorWrite },
 	{ "depthWrite",		&RenderState::extractDepthWrite },
 	{ "depthOffset",	&RenderState::extractDepthOffset },
 	{ "blend",			&RenderState::extractBlend }
@@ -55,6 +56,7 @@ keyword_helper<RenderState::blend_equation> RenderState::s_blendEqtns({
 
 RenderState::RenderState()
 	: cullEnable(true), cullMode(cull_back),
+	colorWriteEnable(true),
 	depthWriteEnable(true),
 	depthOffsetFactor(0.0f), depthOffsetUnits(0.0f),
 	depthTestEnable(true), depthTestFunction(cmp_less),
@@ -64,6 +66,7 @@ RenderState::RenderState()
 void RenderState::apply() const
 {
 	applyCulling();
+	applyColorWriting();
 	applyDepthWriting();
 	applyDepthOffset();
 	applyDepthTest();
@@ -73,6 +76,7 @@ void RenderState::apply() const
 void RenderState::differentialApply(const RenderState& other) const
 {
 	applyCullingDiff(other);
+	applyColorWriteDiff(other);
 	applyDepthWriteDiff(other);
 	applyDepthOffsetDiff(other);
 	applyDepthTestDiff(other);
@@ -113,6 +117,12 @@ void RenderState::applyCullingDiff(const RenderState& other) const
 		applyCullMode();
 }
 
+void RenderState::applyColorWriteDiff(const RenderState& other) const
+{
+	if (other.colorWriteEnable != colorWriteEnable)
+		applyColorWriting();
+}
+
 void RenderState::applyDepthWriteDiff(const RenderState& other) const
 {
 	if (other.depthWriteEnable != depthWriteEnable)
@@ -175,6 +185,13 @@ void RenderState::extractDepthTest(const nlohmann::json& json)
 	}
 }
 
+void RenderState::extractColorWrite(const nlohmann::json& json)
+{
+	if (json.is_boolean()) {
+		colorWriteEnable = json.get<bool>();
+	}
+}
+
 void RenderState::extractDepthWrite(const nlohmann::json& json)
 {
 	if (json.is_boolean()) {
@@ -1,7 +1,7 @@
 #ifndef RENDER_STATE_HPP
 #define RENDER_STATE_HPP
 
-#include "GL/glew.h"
+#include "gl_state.hpp"
 #include "nlohmann/json.hpp"
 #include "glm.hpp"
 #include "keyword_helper.hpp"
@@ -63,6 +63,9 @@ public:
 	bool cullEnable;
 	cull_mode cullMode;
 
+	// color writing (all channels of all attachments)
+	bool colorWriteEnable;
+
 	// depth writing
 	bool depthWriteEnable;
 
@@ -101,42 +104,48 @@ private:
 	void applyCulling() const;
 	void applyCullMode() const
 	{
-		glCullFace(cullMode);
+		gl_state::cull_face(cullMode);
+	}
+
+	void applyColorWriting() const
+	{
+		gl_state::color_mask(colorWriteEnable);
 	}
 
 	void applyDepthWriting() const
 	{
-		glDepthMask(depthWriteEnable ? GL_TRUE : GL_FALSE);
+		gl_state::depth_mask(depthWriteEnable);
 	}
 
 	void applyDepthOffset() const
 	{
-		glPolygonOffset(depthOffsetFactor, depthOffsetUnits);
+		gl_state::polygon_offset(depthOffsetFactor, depthOffsetUnits);
 	}
 
 
 	void applyDepthTest() const;
 	void applyDepthTestFunc() const
 	{
-		glDepthFunc(depthTestFunction);
+		gl_state::depth_func(depthTestFunction);
 	}
 
 
 	void applyBlending() const;
 	void applyBlendColor() const
 	{
-		glBlendColor(blendColor.r, blendColor.g, blendColor.b, blendColor.a);
+		gl_state::blend_color(blendColor);
 	}
 	void applyBlendEquation() const
 	{
-		glBlendEquationSeparate(blendEquation, blendEquationAlpha);
+		gl_state::blend_equation(blendEquation, blendEquationAlpha);
 	}
 	void applyBlendFunction() const
 	{
-		glBlendFuncSeparate(blendSourceFunction, blendDestFunction, blendSourceAlphaFunction, blendDestAlphaFunction);
+		gl_state::blend_func(blendSourceFunction, blendDestFunction, blendSourceAlphaFunction, blendDestAlphaFunction);
 	}
 
 	void applyCullingDiff(const RenderState& other) const;
+	void applyColorWriteDiff(const RenderState& other) const;
 	void applyDepthWriteDiff(const RenderState& other) const;
 	void applyDepthOffsetDiff(const RenderState& other) const;
 	void applyDepthTestDiff(const RenderState& other) const;
@@ -148,6 +157,8 @@ private:
 	// cppcheck-suppress unusedPrivateFunction
 	void extractCull(const nlohmann::json& json);
 	// cppcheck-suppress unusedPrivateFunction
+	void extractColorWrite(const nlohmann::json& json);
+	// cppcheck-suppress unusedPrivateFunction
 	void extractDepthWrite(const nlohmann::json& json);
 	// cppcheck-suppress unusedPrivateFunction
 	void extractDepthOffset(const nlohmann::json& json);
@@ -158,10 +169,7 @@ private:
 
 	static void setEnabled(GLenum target, bool enabled)
 	{
-		if (enabled)
-			glEnable(target);
-		else
-			glDisable(target);
+		gl_state::enable(target, enabled);
 	}
 
 	friend struct json_initializable<RenderState>;
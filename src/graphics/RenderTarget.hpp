@@ -1,7 +1,7 @@
 #ifndef RENDERTARGET_HPP
 #define RENDERTARGET_HPP
 
-#include "GL/glew.h"
+#include "gl_dispatch.hpp"
 
 class RenderTarget
 {
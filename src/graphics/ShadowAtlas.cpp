@@ -0,0 +1,138 @@
+#include "ShadowAtlas.hpp"
+#include "util/intersection_tests.hpp"
+#include "util/projection.hpp"
+
+#include "boost/functional/hash.hpp"
+
+ShadowAtlas::ShadowAtlas(unsigned int atlasSize, unsigned int tileSize)
+	: m_atlasSize(atlasSize), m_tileSize(tileSize), m_frame(0), m_viewCount(0)
+{
+	unsigned int tilesPerRow = m_atlasSize / m_tileSize;
+	m_tiles.resize(tilesPerRow * tilesPerRow, { nullptr, 0, false });
+}
+
+void ShadowAtlas::update(const std::vector<light_views>& lights, const std::vector<caster>& casters)
+{
+	++m_frame;
+	m_dirtyViews.clear();
+	m_viewCount = 0;
+
+	// free the tiles of lights that are gone (disabled, culled or not casting shadows anymore)
+	for (const light_views& lv : lights) {
+		auto it = m_lights.find(lv.light);
+		if (it != m_lights.end()) it->second.frame = m_frame;
+	}
+
+	for (auto it = m_lights.begin(); it != m_lights.end();) {
+		if (it->second.frame != m_frame) {
+			releaseTiles(it->second.tiles);
+			it = m_lights.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	for (const light_views& lv : lights) {
+		unsigned int count = glm::min(lv.count, max_views);
+
+		auto it = m_lights.find(lv.light);
+		if (it == m_lights.end()) {
+			it = m_lights.emplace(lv.light, light_entry{ { }, m_frame }).first;
+		}
+
+		// the number of views changes with the light type
+		std::vector<unsigned int>& lightTiles = it->second.tiles;
+		if (lightTiles.size() != count) {
+			releaseTiles(lightTiles);
+
+			// atlas is full, the light stays unshadowed
+			if (!allocateTiles(lv.light, count, lightTiles)) {
+				m_lights.erase(it);
+				continue;
+			}
+		}
+
+		for (unsigned int v = 0; v < count; ++v) {
+			unsigned int ti = lightTiles[v];
+			const glm::mat4& viewProj = lv.viewProj[v];
+			++m_viewCount;
+
+			// the signature covers the view itself and the state of every caster inside of it
+			std::size_t signature = 0;
+			for (unsigned int i = 0; i < 16; ++i) {
+				boost::hash_combine(signature, viewProj[i / 4][i % 4]);
+			}
+
+			frustum viewFrustum = extract_frustum(viewProj);
+
+			m_viewCasters.clear();
+			for (std::size_t ci = 0; ci < casters.size(); ++ci) {
+				const caster& c = casters[ci];
+				if (intersect_obb_frustum(c.bounds, viewFrustum)) {
+					m_viewCasters.push_back(ci);
+					boost::hash_combine(signature, ci);
+					boost::hash_combine(signature, c.state);
+				}
+			}
+
+			tile& t = m_tiles[ti];
+			if (t.valid && t.signature == signature)
+				continue;
+
+			t.signature = signature;
+			t.valid = true;
+			m_dirtyViews.push_back({ viewProj, tileRect(ti), m_viewCasters });
+		}
+	}
+}
+
+const std::vector<unsigned int>* ShadowAtlas::tiles(const Light* light) const
+{
+	auto it = m_lights.find(light);
+	return (it != m_lights.end()) ? &it->second.tiles : nullptr;
+}
+
+glm::ivec4 ShadowAtlas::tileRect(unsigned int index) const
+{
+	unsigned int tilesPerRow = m_atlasSize / m_tileSize;
+	return {
+		(index % tilesPerRow) * m_tileSize,
+		(index / tilesPerRow) * m_tileSize,
+		m_tileSize,
+		m_tileSize
+	};
+}
+
+void ShadowAtlas::invalidate()
+{
+	for (tile& t : m_tiles) {
+		t.valid = false;
+	}
+}
+
+bool ShadowAtlas::allocateTiles(const Light* light, unsigned int count, std::vector<unsigned int>& tiles)
+{
+	tiles.clear();
+	for (unsigned int i = 0; (i < m_tiles.size()) && (tiles.size() < count); ++i) {
+		if (!m_tiles[i].owner) tiles.push_back(i);
+	}
+
+	if (tiles.size() < count) {
+		tiles.clear();
+		return false;
+	}
+
+	for (unsigned int i : tiles) {
+		m_tiles[i] = { light, 0, false };
+	}
+
+	return true;
+}
+
+void ShadowAtlas::releaseTiles(std::vector<unsigned int>& tiles)
+{
+	for (unsigned int i : tiles) {
+		m_tiles[i] = { nullptr, 0, false };
+	}
+	tiles.clear();
+}
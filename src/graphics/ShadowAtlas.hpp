@@ -0,0 +1,90 @@
+#ifndef SHADOWATLAS_HPP
+#define SHADOWATLAS_HPP
+
+#include "util/bounds.hpp"
+
+#include "glm.hpp"
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+class Light;
+
+// tiles of the shadow atlas (see ShadowMaps) and what they hold, without touching GL or the lights themselves
+// every view of a light occupies one tile, a tile keeps its content until its view or one of the casters inside of it changes
+class ShadowAtlas
+{
+public:
+	static const unsigned int max_views = 4;
+
+	struct light_views
+	{
+		const Light* light; // only used to recognize the light in later frames
+		unsigned int count;
+		std::array<glm::mat4, max_views> viewProj;
+	};
+
+	struct caster
+	{
+		obb bounds;
+		std::size_t state; // anything that changes what the caster looks like (object, transform version)
+	};
+
+	// view that has to be re-rendered this frame
+	struct dirty_view
+	{
+		glm::mat4 viewProj;
+		glm::ivec4 rect; // x, y, width, height in atlas pixels
+		std::vector<std::size_t> casters; // indices into the caster list passed to update()
+	};
+
+	ShadowAtlas(unsigned int atlasSize, unsigned int tileSize);
+
+	// gives every light a tile per view (the tiles of lights that are not in the list anymore are freed first)
+	// and collects the views whose content changed. lights that don't fit into the atlas get no tiles
+	void update(const std::vector<light_views>& lights, const std::vector<caster>& casters);
+
+	// tiles of the light's views, nullptr if it got none during the last update
+	const std::vector<unsigned int>* tiles(const Light* light) const;
+	glm::ivec4 tileRect(unsigned int index) const;
+
+	const std::vector<dirty_view>& dirtyViews() const { return m_dirtyViews; }
+
+	unsigned int atlasSize() const { return m_atlasSize; }
+	unsigned int tileSize() const { return m_tileSize; }
+	std::size_t tileCount() const { return m_tiles.size(); }
+
+	// views in use by the last update
+	std::size_t viewCount() const { return m_viewCount; }
+
+	// forces all views to be rendered again
+	void invalidate();
+
+private:
+	struct tile
+	{
+		const Light* owner;
+		std::size_t signature;
+		bool valid;
+	};
+
+	struct light_entry
+	{
+		std::vector<unsigned int> tiles;
+		std::size_t frame;
+	};
+
+	unsigned int m_atlasSize, m_tileSize;
+
+	std::vector<tile> m_tiles;
+	std::unordered_map<const Light*, light_entry> m_lights;
+	std::vector<dirty_view> m_dirtyViews;
+	std::vector<std::size_t> m_viewCasters;
+	std::size_t m_frame, m_viewCount;
+
+	bool allocateTiles(const Light* light, unsigned int count, std::vector<unsigned int>& tiles);
+	void releaseTiles(std::vector<unsigned int>& tiles);
+};
+
+#endif // SHADOWATLAS_HPP
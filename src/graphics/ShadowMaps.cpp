@@ -0,0 +1,167 @@
+#include "ShadowMaps.hpp"
+#include "Light.hpp"
+#include "core/Entity.hpp"
+#include "core/Transform.hpp"
+
+#include "boost/functional/hash.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace
+{
+	// clip space to [0, 1]
+	const glm::mat4 g_bias = glm::translate(glm::vec3(0.5f)) * glm::scale(glm::vec3(0.5f));
+
+	glm::vec3 light_up(const glm::vec3& dir)
+	{
+		return (glm::abs(dir.y) > 0.99f) ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+	}
+
+	float view_depth_to_ndc(const glm::mat4& proj, float depth)
+	{
+		return (proj[2][2] * -depth + proj[3][2]) / depth;
+	}
+}
+
+ShadowMaps::ShadowMaps(unsigned int atlasSize, unsigned int tileSize, unsigned int cascades, float distance, float casterDistance)
+	: m_cascades(glm::clamp(cascades, 1u, max_cascades)), m_distance(distance), m_casterDistance(casterDistance),
+	m_tiles(atlasSize, tileSize)
+{
+	m_atlas = std::make_unique<Texture2D>();
+	m_atlas->setParams(false, filter_bilinear, wrap_clampToEdge);
+	m_atlas->setDepthCompare(true);
+	m_atlas->setData<pixel::depth24>(nullptr, atlasSize, atlasSize);
+
+	m_frameBuffer = std::make_unique<FrameBuffer>();
+	m_frameBuffer->setTargetsDepth(make_tex2D_tgt(m_atlas.get()), FrameBuffer::target_array());
+}
+
+void ShadowMaps::update(const std::vector<const Light*>& lights, const std::vector<caster>& casters, const camera_data& camera)
+{
+	m_views.clear();
+	m_splits.clear();
+	m_casters.clear();
+
+	for (const Light* light : lights) {
+		// point lights are not supported (yet)
+		Light::light_type type = light->type();
+		if (type == Light::type_point) continue;
+
+		ShadowAtlas::light_views views;
+		views.light = light;
+
+		glm::vec4 splits;
+
+		if (type == Light::type_directional) {
+			views.count = m_cascades;
+			computeCascades(light, camera, views.viewProj, splits);
+		} else {
+			views.count = 1;
+			computeSpotView(light, views.viewProj[0]);
+			splits = glm::vec4(std::numeric_limits<float>::max());
+		}
+
+		m_views.push_back(views);
+		m_splits.push_back(splits);
+	}
+
+	for (const caster& c : casters) {
+		std::size_t state = 0;
+		boost::hash_combine(state, c.transform);
+		boost::hash_combine(state, c.transform->version());
+		boost::hash_combine(state, c.obj);
+		m_casters.push_back({ c.bounds, state });
+	}
+
+	m_tiles.update(m_views, m_casters);
+
+	// only the lights that got tiles are shadowed
+	m_shadows.clear();
+	for (std::size_t i = 0; i < m_views.size(); ++i) {
+		const ShadowAtlas::light_views& views = m_views[i];
+		const std::vector<unsigned int>* tiles = m_tiles.tiles(views.light);
+		if (!tiles) continue;
+
+		light_shadow& shadow = m_shadows[views.light];
+		shadow.splits = m_splits[i];
+		shadow.viewCount = int(views.count);
+
+		for (unsigned int v = 0; v < views.count; ++v) {
+			shadow.matrices[v] = g_bias * views.viewProj[v];
+			shadow.rects[v] = glm::vec4(m_tiles.tileRect((*tiles)[v])) / float(m_tiles.atlasSize());
+		}
+	}
+}
+
+const ShadowMaps::light_shadow* ShadowMaps::find(const Light* light) const
+{
+	auto it = m_shadows.find(light);
+	return (it != m_shadows.end()) ? &it->second : nullptr;
+}
+
+void ShadowMaps::computeCascades(const Light* light, const camera_data& camera, std::array<glm::mat4, max_cascades>& viewProj, glm::vec4& splits) const
+{
+	float nearPlane = camera.nearPlane;
+	float farPlane = glm::min(camera.farPlane, m_distance);
+	glm::mat4 invViewProj = glm::inverse(camera.proj * camera.view);
+
+	glm::vec3 dir = light->entity()->transform()->rotation() * glm::vec3(0.0f, 0.0f, -1.0f);
+	glm::mat4 lightRot = glm::lookAt(glm::vec3(0.0f), dir, light_up(dir));
+
+	splits = glm::vec4(-1.0f);
+	float sliceNear = nearPlane;
+
+	for (unsigned int c = 0; c < m_cascades; ++c) {
+		// halfway between uniform and logarithmic splits
+		float t = float(c + 1) / float(m_cascades);
+		float sliceFar = glm::mix(nearPlane + (farPlane - nearPlane) * t, nearPlane * std::pow(farPlane / nearPlane, t), 0.5f);
+		splits[c] = sliceFar;
+
+		// bounding sphere of the frustum slice
+		glm::vec3 corners[8];
+		glm::vec3 center(0.0f);
+		for (unsigned int i = 0; i < 8; ++i) {
+			glm::vec4 ndc(
+				(i & 1) ? 1.0f : -1.0f,
+				(i & 2) ? 1.0f : -1.0f,
+				view_depth_to_ndc(camera.proj, (i & 4) ? sliceFar : sliceNear),
+				1.0f);
+			glm::vec4 wp = invViewProj * ndc;
+			corners[i] = glm::vec3(wp) / wp.w;
+			center += corners[i];
+		}
+		center /= 8.0f;
+
+		float radius = 0.0f;
+		for (const glm::vec3& corner : corners) {
+			radius = glm::max(radius, glm::length(corner - center));
+		}
+
+		// fixed size and texel aligned position, so the cascade does not change while the camera turns or moves slightly
+		radius = glm::ceil(radius * 16.0f) / 16.0f;
+		float texel = 2.0f * radius / float(m_tiles.tileSize());
+
+		glm::vec3 lc(lightRot * glm::vec4(center, 1.0f));
+		lc = glm::floor(lc / texel) * texel;
+
+		// extended towards the light to catch casters outside of the slice
+		glm::mat4 view = glm::translate(-lc) * lightRot;
+		glm::mat4 proj = glm::ortho(-radius, radius, -radius, radius, -(radius + m_casterDistance), radius);
+		viewProj[c] = proj * view;
+
+		sliceNear = sliceFar;
+	}
+}
+
+void ShadowMaps::computeSpotView(const Light* light, glm::mat4& viewProj) const
+{
+	const Transform* lt = light->entity()->transform();
+	glm::vec3 pos = lt->position();
+	glm::vec3 dir = lt->rotation() * glm::vec3(0.0f, 0.0f, -1.0f);
+
+	float fov = glm::min(2.0f * glm::radians(light->spotAngle()), glm::radians(170.0f));
+	float range = light->range();
+
+	viewProj = glm::perspective(fov, 1.0f, range * 0.01f, range) * glm::lookAt(pos, pos + dir, light_up(dir));
+}
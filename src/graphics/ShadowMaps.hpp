@@ -0,0 +1,98 @@
+#ifndef SHADOWMAPS_HPP
+#define SHADOWMAPS_HPP
+
+#include "FrameBuffer.hpp"
+#include "ShadowAtlas.hpp"
+#include "texture/Texture2D.hpp"
+#include "util/bounds.hpp"
+
+#include "glm.hpp"
+
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class Light;
+class Transform;
+class Drawable;
+class Material;
+class Pass;
+
+// shadow maps of all shadow casting lights, packed into one depth atlas
+// every shadow view (a spot light or one cascade of a directional light) occupies a tile of the atlas (see ShadowAtlas)
+class ShadowMaps
+{
+public:
+	static const unsigned int max_cascades = ShadowAtlas::max_views;
+
+	struct caster
+	{
+		const Transform* transform;
+		const Drawable* obj;
+		const Material* material;
+		const Pass* pass;
+		obb bounds;
+	};
+
+	// camera the cascades of directional lights are fitted to
+	struct camera_data
+	{
+		glm::mat4 view, proj;
+		float nearPlane, farPlane;
+	};
+
+	// view that has to be re-rendered this frame, its casters index the caster list passed to update()
+	typedef ShadowAtlas::dirty_view dirty_view;
+
+	// shader inputs of a shadow casting light (see common/shadow.glh)
+	struct light_shadow
+	{
+		int viewCount;
+		std::array<glm::mat4, max_cascades> matrices; // world to tile space
+		std::array<glm::vec4, max_cascades> rects; // tile offset (xy) and size (zw) in atlas texture coordinates
+		glm::vec4 splits; // view depth where each cascade ends
+	};
+
+	ShadowMaps(unsigned int atlasSize, unsigned int tileSize, unsigned int cascades, float distance, float casterDistance);
+
+	// assigns tiles to the lights, computes their views and collects the ones whose content changed
+	void update(const std::vector<const Light*>& lights, const std::vector<caster>& casters, const camera_data& camera);
+
+	// nullptr if the light got no tiles (or does not cast shadows)
+	const light_shadow* find(const Light* light) const;
+
+	const std::vector<dirty_view>& dirtyViews() const { return m_tiles.dirtyViews(); }
+
+	const Texture2D* atlas() const { return m_atlas.get(); }
+	const FrameBuffer* frameBuffer() const { return m_frameBuffer.get(); }
+
+	unsigned int atlasSize() const { return m_tiles.atlasSize(); }
+	unsigned int tileSize() const { return m_tiles.tileSize(); }
+	unsigned int cascadeCount() const { return m_cascades; }
+
+	// views in use / views re-rendered by the last update
+	std::size_t viewCount() const { return m_tiles.viewCount(); }
+	std::size_t viewsRendered() const { return m_tiles.dirtyViews().size(); }
+
+	// forces all views to be rendered again
+	void invalidate() { m_tiles.invalidate(); }
+
+private:
+	unsigned int m_cascades;
+	float m_distance, m_casterDistance;
+
+	std::unique_ptr<Texture2D> m_atlas;
+	std::unique_ptr<FrameBuffer> m_frameBuffer;
+
+	ShadowAtlas m_tiles;
+	std::vector<ShadowAtlas::light_views> m_views;
+	std::vector<glm::vec4> m_splits; // per entry of m_views
+	std::vector<ShadowAtlas::caster> m_casters;
+	std::unordered_map<const Light*, light_shadow> m_shadows;
+
+	void computeCascades(const Light* light, const camera_data& camera, std::array<glm::mat4, max_cascades>& viewProj, glm::vec4& splits) const;
+	void computeSpotView(const Light* light, glm::mat4& viewProj) const;
+};
+
+#endif // SHADOWMAPS_HPP
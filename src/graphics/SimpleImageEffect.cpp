@@ -9,7 +9,7 @@
 #include "content/pooled.hpp"
 #include "scripting/class_registry.hpp"
 
-REGISTER_COMPONENT_CLASS(SimpleImageEffect);
+REGISTER_DERIVED_COMPONENT_CLASS(SimpleImageEffect, ImageEffect);
 
 json_interpreter<SimpleImageEffect> SimpleImageEffect::s_properties({
 	{ "material", &SimpleImageEffect::extractMaterial },
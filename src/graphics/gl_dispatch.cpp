@@ -0,0 +1,501 @@
+#define GL_DISPATCH_IMPLEMENTATION
+#include "gl_dispatch.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <unordered_map>
+
+// extension entry points, called through GLEW's function pointers (__glew*)
+#define GL_DISPATCH_GLEW_ENTRY_POINTS(X) \
+	X(AttachShader) \
+	X(BeginQuery) \
+	X(BindBuffer) \
+	X(BindBufferBase) \
+	X(BindFramebuffer) \
+	X(BindImageTexture) \
+	X(BindRenderbuffer) \
+	X(BindTextures) \
+	X(BindVertexArray) \
+	X(BlendColor) \
+	X(BlendEquationSeparate) \
+	X(BlendFuncSeparate) \
+	X(BufferData) \
+	X(CheckFramebufferStatus) \
+	X(ClearBufferfi) \
+	X(ClearBufferfv) \
+	X(ClearBufferiv) \
+	X(CompileShader) \
+	X(CompressedTexImage2D) \
+	X(CopyBufferSubData) \
+	X(CreateBuffers) \
+	X(CreateProgram) \
+	X(CreateShader) \
+	X(CreateVertexArrays) \
+	X(DebugMessageCallback) \
+	X(DebugMessageControl) \
+	X(DeleteBuffers) \
+	X(DeleteFramebuffers) \
+	X(DeleteProgram) \
+	X(DeleteQueries) \
+	X(DeleteRenderbuffers) \
+	X(DeleteShader) \
+	X(DeleteVertexArrays) \
+	X(DepthBoundsEXT) \
+	X(DisableVertexAttribArray) \
+	X(DispatchCompute) \
+	X(DrawBuffers) \
+	X(DrawElementsInstanced) \
+	X(EnableVertexAttribArray) \
+	X(EndQuery) \
+	X(FramebufferRenderbuffer) \
+	X(FramebufferTexture2D) \
+	X(GenerateMipmap) \
+	X(GenFramebuffers) \
+	X(GenQueries) \
+	X(GenRenderbuffers) \
+	X(GenVertexArrays) \
+	X(GetActiveUniform) \
+	X(GetProgramInfoLog) \
+	X(GetProgramiv) \
+	X(GetQueryObjectiv) \
+	X(GetQueryObjectui64v) \
+	X(GetShaderInfoLog) \
+	X(GetShaderiv) \
+	X(GetTextureHandleARB) \
+	X(GetUniformLocation) \
+	X(LinkProgram) \
+	X(MakeTextureHandleNonResidentARB) \
+	X(MakeTextureHandleResidentARB) \
+	X(MapNamedBuffer) \
+	X(MemoryBarrier) \
+	X(ProgramUniform1i) \
+	X(ProgramUniformHandleui64ARB) \
+	X(RenderbufferStorage) \
+	X(ShaderSource) \
+	X(Uniform1f) \
+	X(Uniform1i) \
+	X(Uniform1ui) \
+	X(Uniform2fv) \
+	X(Uniform2iv) \
+	X(Uniform2uiv) \
+	X(Uniform3fv) \
+	X(Uniform3iv) \
+	X(Uniform3uiv) \
+	X(Uniform4fv) \
+	X(Uniform4iv) \
+	X(Uniform4uiv) \
+	X(UniformMatrix3fv) \
+	X(UniformMatrix4fv) \
+	X(UniformMatrix4x3fv) \
+	X(UnmapNamedBuffer) \
+	X(UseProgram) \
+	X(VertexAttribDivisor) \
+	X(VertexAttribPointer)
+
+namespace gl_dispatch
+{
+	namespace gl11
+	{
+#define GL_DISPATCH_DEFINE(name) decltype(&::gl##name) name = &::gl##name;
+		GL_DISPATCH_GL11_ENTRY_POINTS(GL_DISPATCH_DEFINE)
+#undef GL_DISPATCH_DEFINE
+	}
+
+	namespace
+	{
+		enum entry_point_id : std::size_t
+		{
+#define GL_DISPATCH_ID(name) id_##name,
+			GL_DISPATCH_GL11_ENTRY_POINTS(GL_DISPATCH_ID)
+			GL_DISPATCH_GLEW_ENTRY_POINTS(GL_DISPATCH_ID)
+#undef GL_DISPATCH_ID
+			entry_point_count
+		};
+
+		const char* const entry_point_names[] = {
+#define GL_DISPATCH_NAME(name) "gl" #name,
+			GL_DISPATCH_GL11_ENTRY_POINTS(GL_DISPATCH_NAME)
+			GL_DISPATCH_GLEW_ENTRY_POINTS(GL_DISPATCH_NAME)
+#undef GL_DISPATCH_NAME
+		};
+
+		// results of the null backend
+		struct null_state
+		{
+			GLuint nextName;
+			std::unordered_map<GLenum, GLint> integers;
+			std::vector<uniform_info> uniforms;
+			std::unordered_map<std::string, GLint> uniformLocations;
+			GLenum framebufferStatus;
+
+			// buffer contents, so mapping a buffer returns what was uploaded
+			std::unordered_map<GLenum, GLuint> boundBuffers;
+			std::unordered_map<GLuint, std::vector<char>> buffers;
+
+			null_state() : nextName(1), framebufferStatus(GL_FRAMEBUFFER_COMPLETE)
+			{
+				integers[GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS] = 80;
+				integers[GL_MAX_COLOR_ATTACHMENTS] = 8;
+				integers[GL_MAX_DRAW_BUFFERS] = 8;
+			}
+		};
+
+		struct dispatch_state
+		{
+			backend current;
+			std::array<std::size_t, entry_point_count> callCounts;
+			null_state null;
+
+			dispatch_state() : current(backend::native), callCounts() { }
+		};
+
+		dispatch_state& state()
+		{
+			static dispatch_state s;
+			return s;
+		}
+
+		template<std::size_t Id, typename Function>
+		struct hook;
+
+		// counted: installed for the recording and null backends, forwards to the driver or to the null stub
+		template<std::size_t Id, typename R, typename... Args>
+		struct hook<Id, R (GLAPIENTRY*)(Args...)>
+		{
+			using function = R (GLAPIENTRY*)(Args...);
+
+			static function native;
+			static function stub;
+
+			static R GLAPIENTRY noop(Args...)
+			{
+				return R();
+			}
+
+			static R GLAPIENTRY counted(Args... args)
+			{
+				auto& s = state();
+				++s.callCounts[Id];
+				return (s.current == backend::null ? stub : native)(args...);
+			}
+
+			static void install(function& slot, backend b)
+			{
+				// the slot holds the driver's function unless it has already been redirected
+				if (slot != &counted)
+					native = slot;
+
+				slot = (b == backend::native) ? native : &counted;
+			}
+		};
+
+		template<std::size_t Id, typename R, typename... Args>
+		typename hook<Id, R (GLAPIENTRY*)(Args...)>::function hook<Id, R (GLAPIENTRY*)(Args...)>::native = nullptr;
+
+		template<std::size_t Id, typename R, typename... Args>
+		typename hook<Id, R (GLAPIENTRY*)(Args...)>::function hook<Id, R (GLAPIENTRY*)(Args...)>::stub = &hook<Id, R (GLAPIENTRY*)(Args...)>::noop;
+
+		template<std::size_t Id, typename Function>
+		void set_stub(const Function&, typename hook<Id, Function>::function stub)
+		{
+			hook<Id, Function>::stub = stub;
+		}
+
+		void GLAPIENTRY null_gen_names(GLsizei n, GLuint* names)
+		{
+			auto& s = state().null;
+			for (GLsizei i = 0; i < n; ++i) {
+				names[i] = s.nextName++;
+			}
+		}
+
+		GLuint GLAPIENTRY null_create_shader(GLenum)
+		{
+			return state().null.nextName++;
+		}
+
+		GLuint GLAPIENTRY null_create_program()
+		{
+			return state().null.nextName++;
+		}
+
+		const GLubyte* GLAPIENTRY null_get_string(GLenum)
+		{
+			return reinterpret_cast<const GLubyte*>("null");
+		}
+
+		void GLAPIENTRY null_get_integerv(GLenum pname, GLint* data)
+		{
+			auto& integers = state().null.integers;
+			auto it = integers.find(pname);
+			*data = (it != integers.end()) ? it->second : 0;
+		}
+
+		void GLAPIENTRY null_get_shaderiv(GLuint, GLenum pname, GLint* params)
+		{
+			switch (pname) {
+			case GL_COMPILE_STATUS:
+				*params = GL_TRUE;
+				break;
+			case GL_INFO_LOG_LENGTH:
+				*params = 1;
+				break;
+			default:
+				*params = 0;
+			}
+		}
+
+		void GLAPIENTRY null_get_programiv(GLuint, GLenum pname, GLint* params)
+		{
+			auto& uniforms = state().null.uniforms;
+
+			switch (pname) {
+			case GL_LINK_STATUS:
+				*params = GL_TRUE;
+				break;
+			case GL_INFO_LOG_LENGTH:
+				*params = 1;
+				break;
+			case GL_ACTIVE_UNIFORMS:
+				*params = GLint(uniforms.size());
+				break;
+			case GL_ACTIVE_UNIFORM_MAX_LENGTH:
+				*params = 1;
+				for (auto& u : uniforms) {
+					*params = std::max(*params, GLint(u.name.size() + 1));
+				}
+				break;
+			default:
+				*params = 0;
+			}
+		}
+
+		void GLAPIENTRY null_get_info_log(GLuint, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+		{
+			if (length) *length = 0;
+			if (bufSize > 0) infoLog[0] = '\0';
+		}
+
+		void GLAPIENTRY null_get_active_uniform(GLuint, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+		{
+			auto& uniforms = state().null.uniforms;
+			if (index >= uniforms.size() || bufSize <= 0)
+				return;
+
+			const uniform_info& u = uniforms[index];
+			GLsizei l = std::min(GLsizei(u.name.size()), bufSize - 1);
+
+			std::memcpy(name, u.name.c_str(), l);
+			name[l] = '\0';
+
+			if (length) *length = l;
+			*size = 1;
+			*type = u.type;
+		}
+
+		GLint GLAPIENTRY null_get_uniform_location(GLuint, const GLchar* name)
+		{
+			auto& s = state().null;
+
+			auto it = s.uniformLocations.find(name);
+			if (it != s.uniformLocations.end())
+				return it->second;
+
+			// by default, a uniform's location is its index
+			for (std::size_t i = 0; i < s.uniforms.size(); ++i) {
+				if (s.uniforms[i].name == name)
+					return GLint(i);
+			}
+
+			return -1;
+		}
+
+		GLenum GLAPIENTRY null_check_framebuffer_status(GLenum)
+		{
+			return state().null.framebufferStatus;
+		}
+
+		void GLAPIENTRY null_bind_buffer(GLenum target, GLuint buffer)
+		{
+			state().null.boundBuffers[target] = buffer;
+		}
+
+		void GLAPIENTRY null_buffer_data(GLenum target, GLsizeiptr size, const void* data, GLenum)
+		{
+			auto& s = state().null;
+			auto& contents = s.buffers[s.boundBuffers[target]];
+
+			if (data) {
+				auto bytes = static_cast<const char*>(data);
+				contents.assign(bytes, bytes + size);
+			} else {
+				contents.assign(std::size_t(size), 0);
+			}
+		}
+
+		void GLAPIENTRY null_copy_buffer_sub_data(GLenum readTarget, GLenum writeTarget, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size)
+		{
+			auto& s = state().null;
+			auto& src = s.buffers[s.boundBuffers[readTarget]];
+			auto& dst = s.buffers[s.boundBuffers[writeTarget]];
+
+			if (readOffset + size <= GLintptr(src.size()) && writeOffset + size <= GLintptr(dst.size())) {
+				std::memmove(dst.data() + writeOffset, src.data() + readOffset, std::size_t(size));
+			}
+		}
+
+		void GLAPIENTRY null_delete_buffers(GLsizei n, const GLuint* buffers)
+		{
+			auto& s = state().null;
+			for (GLsizei i = 0; i < n; ++i) {
+				s.buffers.erase(buffers[i]);
+			}
+		}
+
+		void* GLAPIENTRY null_map_named_buffer(GLuint buffer, GLenum)
+		{
+			auto& buffers = state().null.buffers;
+			auto it = buffers.find(buffer);
+			return (it != buffers.end() && !it->second.empty()) ? it->second.data() : nullptr;
+		}
+
+		GLboolean GLAPIENTRY null_unmap_named_buffer(GLuint)
+		{
+			return GL_TRUE;
+		}
+
+		void set_null_stubs()
+		{
+			set_stub<id_GenTextures>(gl11::GenTextures, &null_gen_names);
+			set_stub<id_GetIntegerv>(gl11::GetIntegerv, &null_get_integerv);
+			set_stub<id_GetString>(gl11::GetString, &null_get_string);
+
+			set_stub<id_CreateBuffers>(__glewCreateBuffers, &null_gen_names);
+			set_stub<id_CreateVertexArrays>(__glewCreateVertexArrays, &null_gen_names);
+			set_stub<id_GenFramebuffers>(__glewGenFramebuffers, &null_gen_names);
+			set_stub<id_GenQueries>(__glewGenQueries, &null_gen_names);
+			set_stub<id_GenRenderbuffers>(__glewGenRenderbuffers, &null_gen_names);
+			set_stub<id_GenVertexArrays>(__glewGenVertexArrays, &null_gen_names);
+			set_stub<id_CreateShader>(__glewCreateShader, &null_create_shader);
+			set_stub<id_CreateProgram>(__glewCreateProgram, &null_create_program);
+
+			set_stub<id_GetShaderiv>(__glewGetShaderiv, &null_get_shaderiv);
+			set_stub<id_GetProgramiv>(__glewGetProgramiv, &null_get_programiv);
+			set_stub<id_GetShaderInfoLog>(__glewGetShaderInfoLog, &null_get_info_log);
+			set_stub<id_GetProgramInfoLog>(__glewGetProgramInfoLog, &null_get_info_log);
+			set_stub<id_GetActiveUniform>(__glewGetActiveUniform, &null_get_active_uniform);
+			set_stub<id_GetUniformLocation>(__glewGetUniformLocation, &null_get_uniform_location);
+			set_stub<id_CheckFramebufferStatus>(__glewCheckFramebufferStatus, &null_check_framebuffer_status);
+
+			set_stub<id_BindBuffer>(__glewBindBuffer, &null_bind_buffer);
+			set_stub<id_BufferData>(__glewBufferData, &null_buffer_data);
+			set_stub<id_CopyBufferSubData>(__glewCopyBufferSubData, &null_copy_buffer_sub_data);
+			set_stub<id_DeleteBuffers>(__glewDeleteBuffers, &null_delete_buffers);
+			set_stub<id_MapNamedBuffer>(__glewMapNamedBuffer, &null_map_named_buffer);
+			set_stub<id_UnmapNamedBuffer>(__glewUnmapNamedBuffer, &null_unmap_named_buffer);
+		}
+	}
+
+	backend current_backend()
+	{
+		return state().current;
+	}
+
+	void set_backend(backend b)
+	{
+		static bool stubsSet = false;
+		if (b == backend::null && !stubsSet) {
+			set_null_stubs();
+			stubsSet = true;
+		}
+
+#define GL_DISPATCH_INSTALL_GL11(name) hook<id_##name, decltype(gl11::name)>::install(gl11::name, b);
+#define GL_DISPATCH_INSTALL_GLEW(name) hook<id_##name, decltype(__glew##name)>::install(__glew##name, b);
+		GL_DISPATCH_GL11_ENTRY_POINTS(GL_DISPATCH_INSTALL_GL11)
+		GL_DISPATCH_GLEW_ENTRY_POINTS(GL_DISPATCH_INSTALL_GLEW)
+#undef GL_DISPATCH_INSTALL_GL11
+#undef GL_DISPATCH_INSTALL_GLEW
+
+		state().current = b;
+	}
+
+	bool parse_backend(const std::string& name, backend& result)
+	{
+		if (name == "native") {
+			result = backend::native;
+		} else if (name == "recording") {
+			result = backend::recording;
+		} else if (name == "null") {
+			result = backend::null;
+		} else {
+			return false;
+		}
+
+		return true;
+	}
+
+	std::size_t call_count(const std::string& entryPoint)
+	{
+		for (std::size_t i = 0; i < entry_point_count; ++i) {
+			if (entryPoint == entry_point_names[i])
+				return state().callCounts[i];
+		}
+
+		return 0;
+	}
+
+	std::size_t total_call_count()
+	{
+		auto& counts = state().callCounts;
+		std::size_t total = 0;
+		for (std::size_t c : counts) {
+			total += c;
+		}
+		return total;
+	}
+
+	void reset_call_counts()
+	{
+		state().callCounts.fill(0);
+	}
+
+	void write_call_counts(std::ostream& stream)
+	{
+		auto& counts = state().callCounts;
+
+		std::vector<std::size_t> ids;
+		for (std::size_t i = 0; i < entry_point_count; ++i) {
+			if (counts[i] > 0)
+				ids.push_back(i);
+		}
+
+		std::sort(ids.begin(), ids.end(), [&counts](std::size_t a, std::size_t b) {
+			return counts[a] > counts[b];
+		});
+
+		for (std::size_t i : ids) {
+			stream << entry_point_names[i] << ": " << counts[i] << std::endl;
+		}
+	}
+
+	void set_integer(GLenum pname, GLint value)
+	{
+		state().null.integers[pname] = value;
+	}
+
+	void set_active_uniforms(std::vector<uniform_info> uniforms)
+	{
+		state().null.uniforms = std::move(uniforms);
+	}
+
+	void set_uniform_location(const std::string& name, GLint location)
+	{
+		state().null.uniformLocations[name] = location;
+	}
+
+	void set_framebuffer_status(GLenum status)
+	{
+		state().null.framebufferStatus = status;
+	}
+}
@@ -0,0 +1,113 @@
+#ifndef GL_DISPATCH_HPP
+#define GL_DISPATCH_HPP
+
+#include "GL/glew.h"
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+// Pluggable GL dispatch. Include this instead of GL/glew.h.
+// Calls normally go straight to the driver. The entry points used by the engine can be redirected to
+//  - the recording backend, which forwards every call to the driver and counts the calls per entry point
+//  - the null backend, which needs no context at all: it hands out fake object names, counts the calls and
+//    returns configurable results for queries and uniform locations
+// Extension entry points are redirected by replacing GLEW's function pointers, the GL 1.1 ones (which GLEW
+// doesn't load) are called through the pointers below. New entry points have to be added to the lists in
+// gl_dispatch.cpp, otherwise they are neither counted nor stubbed.
+namespace gl_dispatch
+{
+	enum class backend
+	{
+		native,
+		recording,
+		null
+	};
+
+	backend current_backend();
+
+	// switching from null to another backend requires glewInit to have been called in between
+	void set_backend(backend b);
+
+	// "native", "recording" or "null"
+	bool parse_backend(const std::string& name, backend& result);
+
+	// calls per entry point (e.g. "glDrawElements"), only counted by the recording and null backends
+	std::size_t call_count(const std::string& entryPoint);
+	std::size_t total_call_count();
+	void reset_call_counts();
+
+	// all entry points that were called, most frequent first
+	void write_call_counts(std::ostream& stream);
+
+	// active uniforms reported by every program linked on the null backend
+	struct uniform_info
+	{
+		std::string name;
+		GLenum type;
+	};
+
+	// results returned by the null backend
+	void set_integer(GLenum pname, GLint value);
+	void set_active_uniforms(std::vector<uniform_info> uniforms);
+	void set_uniform_location(const std::string& name, GLint location);
+	void set_framebuffer_status(GLenum status);
+
+	namespace gl11
+	{
+#define GL_DISPATCH_GL11_ENTRY_POINTS(X) \
+		X(BindTexture) \
+		X(ColorMask) \
+		X(CullFace) \
+		X(DeleteTextures) \
+		X(DepthFunc) \
+		X(DepthMask) \
+		X(Disable) \
+		X(DrawArrays) \
+		X(DrawElements) \
+		X(Enable) \
+		X(Finish) \
+		X(GenTextures) \
+		X(GetIntegerv) \
+		X(GetString) \
+		X(PolygonOffset) \
+		X(ReadBuffer) \
+		X(Scissor) \
+		X(TexImage2D) \
+		X(TexParameterf) \
+		X(TexParameterfv) \
+		X(TexParameteri) \
+		X(Viewport)
+
+#define GL_DISPATCH_DECLARE(name) extern decltype(&::gl##name) name;
+		GL_DISPATCH_GL11_ENTRY_POINTS(GL_DISPATCH_DECLARE)
+#undef GL_DISPATCH_DECLARE
+	}
+}
+
+#ifndef GL_DISPATCH_IMPLEMENTATION
+#define glBindTexture gl_dispatch::gl11::BindTexture
+#define glColorMask gl_dispatch::gl11::ColorMask
+#define glCullFace gl_dispatch::gl11::CullFace
+#define glDeleteTextures gl_dispatch::gl11::DeleteTextures
+#define glDepthFunc gl_dispatch::gl11::DepthFunc
+#define glDepthMask gl_dispatch::gl11::DepthMask
+#define glDisable gl_dispatch::gl11::Disable
+#define glDrawArrays gl_dispatch::gl11::DrawArrays
+#define glDrawElements gl_dispatch::gl11::DrawElements
+#define glEnable gl_dispatch::gl11::Enable
+#define glFinish gl_dispatch::gl11::Finish
+#define glGenTextures gl_dispatch::gl11::GenTextures
+#define glGetIntegerv gl_dispatch::gl11::GetIntegerv
+#define glGetString gl_dispatch::gl11::GetString
+#define glPolygonOffset gl_dispatch::gl11::PolygonOffset
+#define glReadBuffer gl_dispatch::gl11::ReadBuffer
+#define glScissor gl_dispatch::gl11::Scissor
+#define glTexImage2D gl_dispatch::gl11::TexImage2D
+#define glTexParameterf gl_dispatch::gl11::TexParameterf
+#define glTexParameterfv gl_dispatch::gl11::TexParameterfv
+#define glTexParameteri gl_dispatch::gl11::TexParameteri
+#define glViewport gl_dispatch::gl11::Viewport
+#endif // GL_DISPATCH_IMPLEMENTATION
+
+#endif // GL_DISPATCH_HPP
@@ -0,0 +1,367 @@
+#include "gl_state.hpp"
+
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace gl_state
+{
+	namespace
+	{
+		const char* const category_names[category_count] = {
+			"program",
+			"vertex array",
+			"buffer",
+			"framebuffer",
+			"texture",
+			"render state"
+		};
+
+		// a shadowed value, unknown until it has been set once
+		template<typename T>
+		struct cached
+		{
+			T value;
+			bool known;
+
+			cached() : value(), known(false) { }
+
+			// returns true if the value changed (and the call has to be issued)
+			bool set(const T& v)
+			{
+				if (known && value == v)
+					return false;
+
+				value = v;
+				known = true;
+				return true;
+			}
+
+			// the object was deleted, a binding falls back to 0
+			void forget(const T& v)
+			{
+				if (known && value == v)
+					value = T();
+			}
+		};
+
+		struct cache_state
+		{
+			bool enabled;
+			call_stats frame, lastFrame;
+
+			cached<GLuint> program;
+			cached<GLuint> vertexArray;
+			std::unordered_map<GLenum, cached<GLuint>> buffers;
+			std::unordered_map<GLuint, cached<GLuint>> elementBuffers; // by vertex array
+			std::map<std::pair<GLenum, GLuint>, cached<GLuint>> indexedBuffers;
+			cached<GLuint> drawFramebuffer, readFramebuffer;
+			std::vector<cached<GLuint>> textureUnits;
+
+			std::unordered_map<GLenum, cached<bool>> caps;
+			cached<GLenum> cullMode;
+			cached<bool> colorMask;
+			cached<bool> depthMask;
+			cached<GLenum> depthFunc;
+			cached<glm::vec2> polygonOffset;
+			cached<glm::vec4> blendColor;
+			cached<glm::uvec2> blendEquation;
+			cached<glm::uvec4> blendFunc;
+
+			cache_state() : enabled(true), frame(), lastFrame() { }
+		};
+
+		cache_state& state()
+		{
+			static cache_state s;
+			return s;
+		}
+
+		// counts the call, returns true if it has to be issued
+		template<typename T>
+		bool change(cached<T>& c, const T& value, call_category category)
+		{
+			auto& s = state();
+			bool changed = c.set(value);
+
+			if (changed || !s.enabled) {
+				++s.frame.issued[category];
+				return true;
+			}
+
+			++s.frame.skipped[category];
+			return false;
+		}
+
+		cached<GLuint>& texture_unit(GLuint unit)
+		{
+			auto& units = state().textureUnits;
+			if (unit >= units.size())
+				units.resize(unit + 1);
+
+			return units[unit];
+		}
+	}
+
+	std::size_t call_stats::totalIssued() const
+	{
+		std::size_t total = 0;
+		for (std::size_t c : issued) {
+			total += c;
+		}
+		return total;
+	}
+
+	std::size_t call_stats::totalSkipped() const
+	{
+		std::size_t total = 0;
+		for (std::size_t c : skipped) {
+			total += c;
+		}
+		return total;
+	}
+
+	bool enabled()
+	{
+		return state().enabled;
+	}
+
+	void set_enabled(bool val)
+	{
+		state().enabled = val;
+		invalidate();
+	}
+
+	void invalidate()
+	{
+		auto& s = state();
+		bool enabled = s.enabled;
+		call_stats frame = s.frame, lastFrame = s.lastFrame;
+
+		s = cache_state();
+
+		s.enabled = enabled;
+		s.frame = frame;
+		s.lastFrame = lastFrame;
+	}
+
+	const call_stats& last_frame()
+	{
+		return state().lastFrame;
+	}
+
+	void end_frame()
+	{
+		auto& s = state();
+		s.lastFrame = s.frame;
+		s.frame = call_stats();
+	}
+
+	void write_stats(std::ostream& stream)
+	{
+		auto& stats = state().lastFrame;
+		for (std::size_t i = 0; i < category_count; ++i) {
+			stream << category_names[i] << ": " << stats.issued[i] << " issued, " << stats.skipped[i] << " skipped" << std::endl;
+		}
+		stream << "total: " << stats.totalIssued() << " issued, " << stats.totalSkipped() << " skipped" << std::endl;
+	}
+
+	void use_program(GLuint program)
+	{
+		if (change(state().program, program, category_program))
+			glUseProgram(program);
+	}
+
+	void bind_vertex_array(GLuint vao)
+	{
+		if (change(state().vertexArray, vao, category_vertex_array))
+			glBindVertexArray(vao);
+	}
+
+	void bind_buffer(GLenum target, GLuint buffer)
+	{
+		auto& s = state();
+		auto& c = (target == GL_ELEMENT_ARRAY_BUFFER) ? s.elementBuffers[s.vertexArray.value] : s.buffers[target];
+
+		// without a known vertex array, the element buffer binding is unknown as well
+		if (target == GL_ELEMENT_ARRAY_BUFFER && !s.vertexArray.known)
+			c.known = false;
+
+		if (change(c, buffer, category_buffer))
+			glBindBuffer(target, buffer);
+	}
+
+	void bind_buffer_base(GLenum target, GLuint index, GLuint buffer)
+	{
+		auto& s = state();
+		if (change(s.indexedBuffers[{ target, index }], buffer, category_buffer)) {
+			glBindBufferBase(target, index, buffer);
+			s.buffers[target].set(buffer);
+		}
+	}
+
+	void bind_framebuffer(GLenum target, GLuint fbo)
+	{
+		auto& s = state();
+		bool issue;
+
+		switch (target) {
+		case GL_DRAW_FRAMEBUFFER:
+			issue = change(s.drawFramebuffer, fbo, category_framebuffer);
+			break;
+		case GL_READ_FRAMEBUFFER:
+			issue = change(s.readFramebuffer, fbo, category_framebuffer);
+			break;
+		default:
+		{
+			// both have to be set, count it as a single call
+			bool drawChanged = s.drawFramebuffer.set(fbo);
+			bool readChanged = s.readFramebuffer.set(fbo);
+			issue = drawChanged || readChanged || !s.enabled;
+
+			if (issue)
+				++s.frame.issued[category_framebuffer];
+			else
+				++s.frame.skipped[category_framebuffer];
+			break;
+		}
+		}
+
+		if (issue)
+			glBindFramebuffer(target, fbo);
+	}
+
+	void bind_texture(GLenum target, GLuint texture)
+	{
+		if (change(texture_unit(0), texture, category_texture))
+			glBindTexture(target, texture);
+	}
+
+	void bind_texture_unit(GLuint unit, GLuint texture)
+	{
+		if (change(texture_unit(unit), texture, category_texture))
+			glBindTextures(unit, 1, &texture);
+	}
+
+	void unbind_texture_units(GLuint count)
+	{
+		auto& s = state();
+		for (GLuint i = 0; i < count; ++i) {
+			texture_unit(i).set(0);
+		}
+
+		++s.frame.issued[category_texture];
+		glBindTextures(0, count, nullptr);
+	}
+
+	void enable(GLenum cap, bool val)
+	{
+		if (change(state().caps[cap], val, category_render_state)) {
+			if (val)
+				glEnable(cap);
+			else
+				glDisable(cap);
+		}
+	}
+
+	void cull_face(GLenum mode)
+	{
+		if (change(state().cullMode, mode, category_render_state))
+			glCullFace(mode);
+	}
+
+	void color_mask(bool val)
+	{
+		GLboolean b = val ? GL_TRUE : GL_FALSE;
+		if (change(state().colorMask, val, category_render_state))
+			glColorMask(b, b, b, b);
+	}
+
+	void depth_mask(bool val)
+	{
+		if (change(state().depthMask, val, category_render_state))
+			glDepthMask(val ? GL_TRUE : GL_FALSE);
+	}
+
+	void depth_func(GLenum func)
+	{
+		if (change(state().depthFunc, func, category_render_state))
+			glDepthFunc(func);
+	}
+
+	void polygon_offset(float factor, float units)
+	{
+		if (change(state().polygonOffset, glm::vec2(factor, units), category_render_state))
+			glPolygonOffset(factor, units);
+	}
+
+	void blend_color(const glm::vec4& color)
+	{
+		if (change(state().blendColor, color, category_render_state))
+			glBlendColor(color.r, color.g, color.b, color.a);
+	}
+
+	void blend_equation(GLenum modeRGB, GLenum modeAlpha)
+	{
+		if (change(state().blendEquation, glm::uvec2(modeRGB, modeAlpha), category_render_state))
+			glBlendEquationSeparate(modeRGB, modeAlpha);
+	}
+
+	void blend_func(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha)
+	{
+		if (change(state().blendFunc, glm::uvec4(srcRGB, dstRGB, srcAlpha, dstAlpha), category_render_state))
+			glBlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
+	}
+
+	void forget_program(GLuint program)
+	{
+		// a deleted program stays in use until another one is used, but its name must not be trusted anymore
+		auto& s = state();
+		if (s.program.known && s.program.value == program)
+			s.program.known = false;
+	}
+
+	void forget_vertex_array(GLuint vao)
+	{
+		auto& s = state();
+		s.vertexArray.forget(vao);
+		s.elementBuffers.erase(vao);
+	}
+
+	void forget_buffer(GLuint buffer)
+	{
+		auto& s = state();
+		for (auto& b : s.buffers) {
+			b.second.forget(buffer);
+		}
+
+		for (auto& b : s.indexedBuffers) {
+			b.second.forget(buffer);
+		}
+
+		// only detached from the bound vertex array, the others keep referencing the deleted buffer
+		// (and a new buffer may get its name)
+		for (auto& e : s.elementBuffers) {
+			if (e.first == s.vertexArray.value) {
+				e.second.forget(buffer);
+			} else if (e.second.value == buffer) {
+				e.second.known = false;
+			}
+		}
+	}
+
+	void forget_framebuffer(GLuint fbo)
+	{
+		auto& s = state();
+		s.drawFramebuffer.forget(fbo);
+		s.readFramebuffer.forget(fbo);
+	}
+
+	void forget_texture(GLuint texture)
+	{
+		for (auto& u : state().textureUnits) {
+			u.forget(texture);
+		}
+	}
+}
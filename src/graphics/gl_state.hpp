@@ -0,0 +1,82 @@
+#ifndef GL_STATE_HPP
+#define GL_STATE_HPP
+
+#include "gl_dispatch.hpp"
+#include "glm.hpp"
+
+#include <ostream>
+
+// Central GL state cache.
+// Shadows the bindings and fixed function state the engine changes (program, vertex array, buffers, framebuffers,
+// texture units and the RenderState fields) and skips calls that would not change anything.
+// All changes to this state have to go through here (or be followed by invalidate), and deleted objects have to be
+// forgotten, since GL reuses their names.
+// The element array buffer binding is part of the vertex array state, so it is tracked per vertex array.
+// The active texture unit is always 0, bind_texture binds to it.
+namespace gl_state
+{
+	enum call_category
+	{
+		category_program,
+		category_vertex_array,
+		category_buffer,
+		category_framebuffer,
+		category_texture,
+		category_render_state,
+		category_count
+	};
+
+	struct call_stats
+	{
+		std::size_t issued[category_count];
+		std::size_t skipped[category_count];
+
+		std::size_t totalIssued() const;
+		std::size_t totalSkipped() const;
+	};
+
+	// when disabled, every call is issued (but still counted)
+	bool enabled();
+	void set_enabled(bool val);
+
+	// forget everything, the next call of every kind is issued
+	void invalidate();
+
+	// calls during the last frame
+	const call_stats& last_frame();
+	void end_frame();
+
+	void write_stats(std::ostream& stream);
+
+	void use_program(GLuint program);
+	void bind_vertex_array(GLuint vao);
+	void bind_buffer(GLenum target, GLuint buffer);
+	// also binds the buffer to the generic binding point of the target (like glBindBufferBase)
+	void bind_buffer_base(GLenum target, GLuint index, GLuint buffer);
+
+	// GL_FRAMEBUFFER binds both the draw and the read framebuffer
+	void bind_framebuffer(GLenum target, GLuint fbo);
+
+	void bind_texture(GLenum target, GLuint texture);
+	void bind_texture_unit(GLuint unit, GLuint texture);
+	void unbind_texture_units(GLuint count);
+
+	void enable(GLenum cap, bool val);
+	void cull_face(GLenum mode);
+	void color_mask(bool val);
+	void depth_mask(bool val);
+	void depth_func(GLenum func);
+	void polygon_offset(float factor, float units);
+	void blend_color(const glm::vec4& color);
+	void blend_equation(GLenum modeRGB, GLenum modeAlpha);
+	void blend_func(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha);
+
+	// to be called before the objects are deleted
+	void forget_program(GLuint program);
+	void forget_vertex_array(GLuint vao);
+	void forget_buffer(GLuint buffer);
+	void forget_framebuffer(GLuint fbo);
+	void forget_texture(GLuint texture);
+}
+
+#endif // GL_STATE_HPP
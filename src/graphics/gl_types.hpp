@@ -1,7 +1,7 @@
 #ifndef GL_TYPES_HPP
 #define GL_TYPES_HPP
 
-#include "GL/glew.h"
+#include "gl_dispatch.hpp"
 #include "types.hpp"
 
 template<typename> inline constexpr GLenum gl_type() { return 0; }
@@ -4,7 +4,7 @@
 #include "core/NamedObject.hpp"
 #include "util/import.hpp"
 
-#include "GL/glew.h"
+#include "graphics/gl_dispatch.hpp"
 
 #include <string>
 
@@ -29,6 +29,8 @@ public:
 
 	GLuint glObj() const { return m_glObj; }
 
+	shader_type type() const { return m_type; }
+
 	GLint compilerStatus() const { return m_compilerStatus; }
 	const std::string& compilerLog() const { return m_compilerLog; }
 
@@ -1,7 +1,6 @@
 #include "ShaderProgram.hpp"
 #include "Shader.hpp"
 #include "graphics/texture/Texture.hpp"
-#include "graphics/texture/texture_unit_manager.hpp"
 #include "core/type_registry.hpp"
 #include "content/pooled.hpp"
 #include "scripting/class_registry.hpp"
@@ -13,7 +12,10 @@ REGISTER_OBJECT_TYPE_NO_EXT(ShaderProgram);
 
 ShaderProgram::~ShaderProgram()
 {
-	if (m_glObj) glDeleteProgram(m_glObj);
+	if (m_glObj) {
+		gl_state::forget_program(m_glObj);
+		glDeleteProgram(m_glObj);
+	}
 }
 
 ShaderProgram::ShaderProgram(ShaderProgram&& other)
@@ -91,13 +93,20 @@ void ShaderProgram::getUniforms()
 	for (int i = 0; i < uniformCount; ++i) {
 		glGetActiveUniform(m_glObj, i, maxLength, &l, &s, &t, buf.get());
 		std::string name(buf.get());
+
+		// arrays are reported as "name[0]" and set as a whole
+		if (s > 1 && name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0)
+			name.erase(name.size() - 3);
+
 		uniform_id id = uniform_name_to_id(name);
 
 		GLenum texTarget = sampler_type_to_target(t);
 		GLint loc = glGetUniformLocation(m_glObj, buf.get());
 		
 		if (texTarget != 0) {
-			m_textures.emplace(id, tex_unit{ nextUnit++, loc });
+			// units are fixed per program, so the sampler only has to be set once
+			glProgramUniform1i(m_glObj, loc, GLint(nextUnit));
+			m_textures.emplace(id, tex_unit{ nextUnit++, loc, 0 });
 		} else {
 			m_uniforms.emplace(id, loc);
 		}
@@ -120,22 +129,36 @@ void ShaderProgram::setTexture(uniform_id id, const Texture* texture) const
 	if (texture) {
 		auto it = m_textures.find(id);
 		if (it != m_textures.end()) {
-			GLuint glObj = texture->glObj();
 			const auto& u = it->second;
-			glBindTextures(u.unit, 1, &glObj);
-			set_uniform(u.location, GLint(u.unit));
+
+			GLuint64 handle = texture_residency::makeResident(texture);
+			if (handle) {
+				if (u.handle != handle) {
+					glProgramUniformHandleui64ARB(m_glObj, u.location, handle);
+					u.handle = handle;
+					texture_residency::countHandleUpdate();
+				}
+			} else {
+				if (u.handle) {
+					// back from a handle to the unit
+					glProgramUniform1i(m_glObj, u.location, GLint(u.unit));
+					u.handle = 0;
+				}
+				gl_state::bind_texture_unit(u.unit, texture->glObj());
+				texture_residency::countUnitBind();
+			}
 		}
 	}
 }
 
 void ShaderProgram::bind() const
 {
-	if (isGood()) glUseProgram(m_glObj);
+	if (isGood()) gl_state::use_program(m_glObj);
 }
 
 void ShaderProgram::unbind() const
 {
-	glUseProgram(0);
+	gl_state::use_program(0);
 }
 
 template<>
@@ -34,6 +34,8 @@ public:
 
 	GLuint glObj() const { return m_glObj; }
 
+	const std::vector<Shader*>& shaders() const { return m_shaders; }
+
 	GLint linkerStatus() const { return m_linkerStatus; }
 	const std::string& linkerLog() const { return m_linkerLog; }
 
@@ -63,6 +65,7 @@ private:
 	{
 		GLuint unit;
 		GLint location;
+		mutable GLuint64 handle; // resident handle the sampler currently holds, 0 if it samples the unit
 	};
 
 	std::unordered_map<uniform_id, GLint> m_uniforms;
@@ -2,7 +2,9 @@
 #define SET_UNIFORM_HPP
 
 #include "glm.hpp"
-#include "GL/glew.h"
+#include "graphics/gl_dispatch.hpp"
+
+#include <array>
 
 inline void set_uniform(GLint location, float value)
 {
@@ -79,4 +81,16 @@ inline void set_uniform(GLint location, const glm::mat4x3& value)
 	glUniformMatrix4x3fv(location, 1, GL_FALSE, &value[0][0]);
 }
 
+template<std::size_t N>
+inline void set_uniform(GLint location, const std::array<glm::vec4, N>& value)
+{
+	glUniform4fv(location, GLsizei(N), &value[0][0]);
+}
+
+template<std::size_t N>
+inline void set_uniform(GLint location, const std::array<glm::mat4, N>& value)
+{
+	glUniformMatrix4fv(location, GLsizei(N), GL_FALSE, &value[0][0][0]);
+}
+
 #endif // SET_UNIFORM_HPP
\ No newline at end of file
@@ -1,7 +1,10 @@
 #include "shader_preprocessor.hpp"
 #include "content/Content.hpp"
+#include "graphics/texture/texture_residency.hpp"
 
 #include "boost/format.hpp"
+#include "boost/algorithm/string/predicate.hpp"
+#include "boost/algorithm/string/trim.hpp"
 #include "boost/spirit/home/qi.hpp"
 #include "boost/fusion/adapted/struct/adapt_struct.hpp"
 
@@ -23,6 +26,13 @@ shader_preprocessor::shader_preprocessor(std::istream& stream, unsigned int srcI
 	process(stream);
 }
 
+std::map<std::string, std::string> shader_preprocessor::s_globalDefines;
+
+void shader_preprocessor::setGlobalDefine(const std::string& name, const std::string& value)
+{
+	s_globalDefines[name] = value;
+}
+
 bool shader_preprocessor::good() const
 {
 	return m_shaderType != Shader::type_undefined && !m_error;
@@ -139,8 +149,13 @@ void shader_preprocessor::process(std::istream& stream)
 		if (m_error)
 			break;
 
-		if (appendOrig)
+		if (appendOrig) {
 			m_processed.append(line_orig);
+
+			// extensions have to follow the version directive
+			if (boost::algorithm::starts_with(boost::algorithm::trim_left_copy(line_orig), "#version"))
+				version_directive();
+		}
 		++m_currentLine;
 	}
 }
@@ -192,6 +207,23 @@ void shader_preprocessor::include(const path& file)
 	}
 }
 
+void shader_preprocessor::version_directive()
+{
+	bool bindless = texture_residency::isBindless();
+	if (bindless) {
+		// sampler uniforms may hold resident texture handles
+		m_processed.append("#extension GL_ARB_bindless_texture : require\n");
+	}
+
+	for (auto& def : s_globalDefines) {
+		m_processed.append((boost::format("#define %1% %2%\n") % def.first % def.second).str());
+	}
+
+	if (bindless || !s_globalDefines.empty()) {
+		m_processed.append((boost::format("#line %i %i\n") % (m_currentLine + 1) % m_srcId).str());
+	}
+}
+
 void shader_preprocessor::pragma_type(Shader::shader_type type)
 {
 	m_shaderType = type;
@@ -3,8 +3,9 @@
 
 #include <string>
 #include <istream>
+#include <map>
 
-#include "GL/glew.h"
+#include "graphics/gl_dispatch.hpp"
 
 #include "graphics/shader/Shader.hpp"
 
@@ -25,7 +26,12 @@ public:
 
 	bool good() const;
 
+	// defined in every shader (after the version directive), has to be set before the shaders are loaded
+	static void setGlobalDefine(const std::string& name, const std::string& value);
+
 private:
+	static std::map<std::string, std::string> s_globalDefines;
+
 	path m_filename;
 	std::string m_original;
 	std::string m_processed;
@@ -35,6 +41,7 @@ private:
 	unsigned int m_srcId, m_nextSrcId;
 
 	void process(std::istream& stream);
+	void version_directive();
 
 	// cppcheck-suppress unusedPrivateFunction
 	void include(const path& file);
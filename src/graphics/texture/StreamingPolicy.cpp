@@ -0,0 +1,173 @@
+#include "StreamingPolicy.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <utility>
+
+StreamingPolicy::StreamingPolicy(std::size_t budget, std::size_t keepFrames)
+	: m_budget(budget), m_keepFrames(keepFrames), m_frame(0), m_targetBytes(0), m_requestedBytes(0) { }
+
+StreamingPolicy::texture_id StreamingPolicy::add(std::vector<std::size_t> levelBytes, std::size_t pinnedLevel)
+{
+	if (levelBytes.empty())
+		levelBytes.push_back(0);
+
+	pinnedLevel = std::min(pinnedLevel, levelBytes.size() - 1);
+	entry e{ std::move(levelBytes), pinnedLevel, pinnedLevel, pinnedLevel, pinnedLevel, pinnedLevel, 0, true };
+
+	if (!m_free.empty()) {
+		texture_id id = m_free.back();
+		m_free.pop_back();
+		m_entries[id] = std::move(e);
+		return id;
+	}
+
+	m_entries.push_back(std::move(e));
+	return m_entries.size() - 1;
+}
+
+void StreamingPolicy::remove(texture_id id)
+{
+	entry& e = m_entries[id];
+	if (e.active) {
+		e.active = false;
+		e.levelBytes.clear();
+		m_free.push_back(id);
+	}
+}
+
+void StreamingPolicy::request(texture_id id, std::size_t level)
+{
+	entry& e = m_entries[id];
+	if (e.lastRequest != m_frame) {
+		e.lastRequest = m_frame;
+		e.requested = e.pinnedLevel;
+	}
+
+	e.requested = std::min(e.requested, level);
+}
+
+void StreamingPolicy::setResidentLevel(texture_id id, std::size_t level)
+{
+	entry& e = m_entries[id];
+	e.resident = std::min(level, e.pinnedLevel);
+}
+
+const std::vector<StreamingPolicy::change>& StreamingPolicy::update()
+{
+	m_changes.clear();
+
+	std::size_t used = 0;
+	m_requestedBytes = 0;
+
+	// missing levels and texture, the texture missing the most gets the next level
+	std::priority_queue<std::pair<std::size_t, texture_id>> grants;
+	std::vector<texture_id> unwanted;
+
+	for (texture_id id = 0; id < m_entries.size(); ++id) {
+		entry& e = m_entries[id];
+		if (!e.active) continue;
+
+		if (e.lastRequest == m_frame) {
+			e.wanted = e.requested;
+		} else if (m_frame - e.lastRequest > m_keepFrames) {
+			e.wanted = e.pinnedLevel;
+		}
+
+		e.target = e.pinnedLevel;
+		used += bytesFrom(e, e.pinnedLevel);
+		m_requestedBytes += bytesFrom(e, e.wanted);
+
+		if (e.wanted < e.target)
+			grants.emplace(e.target - e.wanted, id);
+	}
+
+	while (!grants.empty()) {
+		texture_id id = grants.top().second;
+		grants.pop();
+
+		entry& e = m_entries[id];
+
+		std::size_t cost = e.levelBytes[e.target - 1];
+		if (used + cost > m_budget)
+			continue; // the texture stays at the levels granted so far
+
+		used += cost;
+		--e.target;
+
+		if (e.wanted < e.target)
+			grants.emplace(e.target - e.wanted, id);
+	}
+
+	// the rest of the budget keeps what is resident already, most recently used first
+	for (texture_id id = 0; id < m_entries.size(); ++id) {
+		const entry& e = m_entries[id];
+		if (e.active && e.resident < e.target)
+			unwanted.push_back(id);
+	}
+
+	std::sort(unwanted.begin(), unwanted.end(), [this](texture_id a, texture_id b) {
+		return m_entries[a].lastRequest > m_entries[b].lastRequest;
+	});
+
+	for (texture_id id : unwanted) {
+		entry& e = m_entries[id];
+		while (e.resident < e.target && used + e.levelBytes[e.target - 1] <= m_budget) {
+			used += e.levelBytes[e.target - 1];
+			--e.target;
+		}
+	}
+
+	m_targetBytes = used;
+
+	for (texture_id id = 0; id < m_entries.size(); ++id) {
+		const entry& e = m_entries[id];
+		if (e.active && e.target > e.resident)
+			m_changes.push_back({ id, e.target });
+	}
+
+	std::size_t evictions = m_changes.size();
+
+	for (texture_id id = 0; id < m_entries.size(); ++id) {
+		const entry& e = m_entries[id];
+		if (e.active && e.target < e.resident)
+			m_changes.push_back({ id, e.target });
+	}
+
+	std::stable_sort(m_changes.begin() + evictions, m_changes.end(), [this](const change& a, const change& b) {
+		return (m_entries[a.id].resident - a.level) > (m_entries[b.id].resident - b.level);
+	});
+
+	++m_frame;
+
+	return m_changes;
+}
+
+std::size_t StreamingPolicy::requiredLevel(float texelsPerPixel)
+{
+	// the GPU picks the level from log2 of the texel footprint, trilinear filtering touches the next finer level as well
+	if (!(texelsPerPixel > 1.0f))
+		return 0;
+
+	return std::size_t(std::floor(std::log2(texelsPerPixel)));
+}
+
+std::size_t StreamingPolicy::residentBytes() const
+{
+	std::size_t bytes = 0;
+	for (const entry& e : m_entries) {
+		if (e.active)
+			bytes += bytesFrom(e, e.resident);
+	}
+	return bytes;
+}
+
+std::size_t StreamingPolicy::bytesFrom(const entry& e, std::size_t level)
+{
+	std::size_t bytes = 0;
+	for (std::size_t l = level; l < e.levelBytes.size(); ++l) {
+		bytes += e.levelBytes[l];
+	}
+	return bytes;
+}
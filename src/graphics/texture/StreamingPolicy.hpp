@@ -0,0 +1,85 @@
+#ifndef STREAMINGPOLICY_HPP
+#define STREAMINGPOLICY_HPP
+
+#include <cstddef>
+#include <vector>
+
+// decides which mip levels of the streamed textures should be resident (see texture_streaming), without touching GL.
+// every frame the renderer requests the finest level each visible texture is sampled at. the requested levels are
+// granted within the memory budget, one level at a time to the texture that misses the most levels.
+// what is left of the budget keeps levels that are not requested any more, the least recently used ones are evicted first.
+// the coarse levels of a texture (from its pinned level on) count against the budget, but are never evicted.
+class StreamingPolicy
+{
+public:
+	using texture_id = std::size_t;
+
+	struct change
+	{
+		texture_id id;
+		std::size_t level; // new finest resident level
+	};
+
+	// budget in bytes, requests are remembered for keepFrames frames after the last one
+	StreamingPolicy(std::size_t budget, std::size_t keepFrames);
+
+	// levelBytes holds the size of every mip level, finest first. the levels from pinnedLevel on are resident
+	texture_id add(std::vector<std::size_t> levelBytes, std::size_t pinnedLevel);
+	void remove(texture_id id);
+
+	// the texture is sampled at this level during the current frame (the finest request of a frame counts)
+	void request(texture_id id, std::size_t level);
+
+	// the levels from level on are resident now (a load or an eviction has finished)
+	void setResidentLevel(texture_id id, std::size_t level);
+	std::size_t residentLevel(texture_id id) const { return m_entries[id].resident; }
+	std::size_t targetLevel(texture_id id) const { return m_entries[id].target; }
+
+	// decides the target levels from the requests of the current frame and starts the next one.
+	// returns the textures whose target differs from what is resident, evictions first (they free the memory for the loads),
+	// then loads, the ones missing the most levels first
+	const std::vector<change>& update();
+
+	// finest level that is sampled when level 0 has texelsPerPixel texels per screen pixel
+	static std::size_t requiredLevel(float texelsPerPixel);
+
+	std::size_t budget() const { return m_budget; }
+	void setBudget(std::size_t val) { m_budget = val; }
+
+	std::size_t keepFrames() const { return m_keepFrames; }
+	void setKeepFrames(std::size_t val) { m_keepFrames = val; }
+
+	std::size_t textureCount() const { return m_entries.size() - m_free.size(); }
+
+	// bytes of the resident levels of all textures
+	std::size_t residentBytes() const;
+	// bytes of the target levels, as of the last update()
+	std::size_t targetBytes() const { return m_targetBytes; }
+	// bytes the requested levels would need without a budget, as of the last update()
+	std::size_t requestedBytes() const { return m_requestedBytes; }
+
+private:
+	struct entry
+	{
+		std::vector<std::size_t> levelBytes;
+		std::size_t pinnedLevel;
+		std::size_t requested; // finest request of the current frame
+		std::size_t wanted; // what the recent requests asked for
+		std::size_t resident, target;
+		std::size_t lastRequest;
+		bool active;
+	};
+
+	std::vector<entry> m_entries;
+	std::vector<texture_id> m_free;
+	std::vector<change> m_changes;
+
+	std::size_t m_budget, m_keepFrames;
+	std::size_t m_frame;
+	std::size_t m_targetBytes, m_requestedBytes;
+
+	// bytes of the levels from level on
+	static std::size_t bytesFrom(const entry& e, std::size_t level);
+};
+
+#endif // STREAMINGPOLICY_HPP
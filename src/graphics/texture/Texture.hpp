@@ -1,40 +1,59 @@
 #ifndef TEXTURE_HPP
 #define TEXTURE_HPP
 
-#include "GL/glew.h"
+#include "graphics/gl_state.hpp"
+#include "texture_residency.hpp"
 
 #include "core/NamedObject.hpp"
 
+#include <utility>
+
 class Texture : public NamedObject
 {
 public:
-	explicit Texture(GLenum target) : m_target(target), m_glObj(0)
+	explicit Texture(GLenum target) : m_target(target), m_glObj(0), m_immutable(false)
 	{
 		glGenTextures(1, &m_glObj);
 	}
 
 	virtual ~Texture()
 	{
-		if (m_glObj)
+		if (m_glObj) {
+			texture_residency::release(this);
+			gl_state::forget_texture(m_glObj);
 			glDeleteTextures(1, &m_glObj);
+		}
 	}
 
 	GLenum glTarget() const { return m_target; }
 	GLuint glObj() const { return m_glObj; }
 
+	// an immutable texture does not accept new data or parameters, but can be made resident (see texture_residency)
+	bool isImmutable() const { return m_immutable; }
+	void makeImmutable() { m_immutable = true; }
+
+	// exchanges the GL textures of both, so an immutable texture can still get new contents (see texture_streaming)
+	void swapObject(Texture& other)
+	{
+		texture_residency::release(this);
+		texture_residency::release(&other);
+		std::swap(m_glObj, other.m_glObj);
+	}
+
 	void bind() const
 	{
-		glBindTexture(m_target, m_glObj);
+		gl_state::bind_texture(m_target, m_glObj);
 	}
 
 	void unbind() const
 	{
-		glBindTexture(m_target, 0);
+		gl_state::bind_texture(m_target, 0);
 	}
 
 protected:
 	GLenum m_target;
 	GLuint m_glObj;
+	bool m_immutable;
 };
 
 #endif // TEXTURE_HPP
\ No newline at end of file
@@ -1,10 +1,13 @@
 #include "Texture2D.hpp"
+#include "texture_streaming.hpp"
 #include "core/type_registry.hpp"
 #include "util/json_utils.hpp"
 #include "content/Content.hpp"
 #include "scripting/class_registry.hpp"
 
 #include <assert.h>
+#include <algorithm>
+#include <iostream>
 
 #define STB_IMAGE_IMPLEMENTATION
 #define STBI_NO_STDIO
@@ -14,8 +17,18 @@ REGISTER_OBJECT_TYPE(Texture2D, ".rbt");
 
 Texture2D::Texture2D() : Texture(GL_TEXTURE_2D), m_width(0), m_height(0), m_mipmaps(true) { }
 
+Texture2D::~Texture2D()
+{
+	texture_streaming::remove(this);
+}
+
 void Texture2D::setData(const void* data, unsigned int w, unsigned int h, GLint imgFormat, GLenum pxFormat, GLenum pxType)
 {
+	if (m_immutable) {
+		std::cout << "ERROR: cannot change immutable texture \"" << name() << "\"" << std::endl;
+		return;
+	}
+
 	bind();
 	glTexImage2D(m_target, 0, imgFormat, w, h, 0, pxFormat, pxType, data);
 
@@ -31,6 +44,11 @@ void Texture2D::setData(const void* data, unsigned int w, unsigned int h, GLint
 
 void Texture2D::setCompressedData(const void* data, GLsizei dataSize, unsigned int w, unsigned int h, GLint format)
 {
+	if (m_immutable) {
+		std::cout << "ERROR: cannot change immutable texture \"" << name() << "\"" << std::endl;
+		return;
+	}
+
 	bind();
 	glCompressedTexImage2D(m_target, 0, format, w, h, 0, dataSize, data);
 
@@ -44,8 +62,41 @@ void Texture2D::setCompressedData(const void* data, GLsizei dataSize, unsigned i
 	m_height = h;
 }
 
+void Texture2D::setMipLevels(const std::vector<mip_level>& levels, unsigned int w, unsigned int h, bool compressed, GLint imgFormat, GLenum pxFormat, GLenum pxType)
+{
+	if (m_immutable) {
+		std::cout << "ERROR: cannot change immutable texture \"" << name() << "\"" << std::endl;
+		return;
+	}
+
+	bind();
+
+	for (std::size_t i = 0; i < levels.size(); ++i) {
+		const mip_level& level = levels[i];
+		if (compressed) {
+			glCompressedTexImage2D(m_target, GLint(i), imgFormat, level.width, level.height, 0, GLsizei(level.data.size()), level.data.data());
+		} else {
+			glTexImage2D(m_target, GLint(i), imgFormat, level.width, level.height, 0, pxFormat, pxType, level.data.data());
+		}
+	}
+
+	// the chain may end before 1x1, the texture has to stay complete
+	glTexParameteri(m_target, GL_TEXTURE_BASE_LEVEL, 0);
+	glTexParameteri(m_target, GL_TEXTURE_MAX_LEVEL, GLint(levels.empty() ? 0 : levels.size() - 1));
+
+	unbind();
+
+	m_width = w;
+	m_height = h;
+}
+
 void Texture2D::setParams(bool mipmaps, filter filtering, wrap wrapping, float anisotropic, const glm::vec4& borderColor)
 {
+	if (m_immutable) {
+		std::cout << "ERROR: cannot change immutable texture \"" << name() << "\"" << std::endl;
+		return;
+	}
+
 	m_mipmaps = mipmaps;
 	GLenum minFilter, magFilter;
 	switch (filtering) {
@@ -75,6 +126,19 @@ void Texture2D::setParams(bool mipmaps, filter filtering, wrap wrapping, float a
 	unbind();
 }
 
+void Texture2D::setDepthCompare(bool enabled)
+{
+	if (m_immutable) {
+		std::cout << "ERROR: cannot change immutable texture \"" << name() << "\"" << std::endl;
+		return;
+	}
+
+	bind();
+	glTexParameteri(m_target, GL_TEXTURE_COMPARE_MODE, enabled ? GL_COMPARE_REF_TO_TEXTURE : GL_NONE);
+	glTexParameteri(m_target, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+	unbind();
+}
+
 template<>
 std::unique_ptr<Texture2D> import_object<Texture2D>(const path& filename)
 {
@@ -89,17 +153,43 @@ std::unique_ptr<Texture2D> import_object<Texture2D>(const path& filename)
 
 		auto hdrStart = file.tellg();
 
-		rbt_info header;
-		file.read(reinterpret_cast<char*>(&header), sizeof(header));
+		// fields missing in older (smaller) headers stay 0
+		rbt_info header = { };
+		file.read(reinterpret_cast<char*>(&header), std::min(headerSize, sizeof(header)));
 
 		// manually seek to start of data stream (in case of mismatching header size)
 		file.seekg(hdrStart + std::streamoff(headerSize));
 
+		newTexture->setParams(header.params.mipmaps, header.params.filter, header.params.wrap, header.params.anisotropic);
+
+		if (header.levels > 0) {
+			// offline generated mip levels, only the coarse ones are loaded if the texture is streamed
+			std::vector<texture_streaming::level_source> sources(header.levels);
+			for (auto& src : sources) {
+				file.read(reinterpret_cast<char*>(&src.size), sizeof(src.size));
+				src.offset = file.tellg();
+				file.seekg(std::streamoff(src.size), std::ios::cur);
+			}
+
+			std::size_t first = texture_streaming::pinnedLevel(header);
+
+			std::vector<Texture2D::mip_level> levels;
+			if (texture_streaming::readLevels(file, header, sources, first, levels)) {
+				newTexture->setMipLevels(levels, header.width, header.height, header.compressed, header.imgFormat, header.pxFormat, header.pxType);
+			}
+
+			newTexture->makeImmutable();
+
+			if (first > 0) {
+				texture_streaming::add(newTexture.get(), filename, header, std::move(sources), first);
+			}
+
+			return std::move(newTexture);
+		}
+
 		std::vector<unsigned char> data(dataSize);
 		file.read(reinterpret_cast<char*>(data.data()), dataSize);
 
-		newTexture->setParams(header.params.mipmaps, header.params.filter, header.params.wrap, header.params.anisotropic);
-
 		if (header.compressed) {
 			newTexture->setCompressedData(data.data(), GLsizei(data.size()), header.width, header.height, header.imgFormat);
 
@@ -117,6 +207,8 @@ std::unique_ptr<Texture2D> import_object<Texture2D>(const path& filename)
 			stbi_image_free(imgData);
 		}
 
+		newTexture->makeImmutable();
+
 		return std::move(newTexture);
 	}
 
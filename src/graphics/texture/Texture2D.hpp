@@ -13,6 +13,7 @@
 #include "util/import.hpp"
 
 #include <memory>
+#include <vector>
 
 class image_importer;
 
@@ -22,7 +23,14 @@ public:
 	using filter = rbt_filter;
 	using wrap = rbt_wrap;
 
+	struct mip_level
+	{
+		std::vector<unsigned char> data; // compressed blocks, or pixels in the format passed to setMipLevels()
+		unsigned int width, height;
+	};
+
 	Texture2D();
+	virtual ~Texture2D();
 
 	void setData(const void* data, unsigned int w, unsigned int h, GLint imgFormat, GLenum pxFormat, GLenum pxType);
 
@@ -40,6 +48,10 @@ public:
 
 	void setCompressedData(const void* data, GLsizei dataSize, unsigned int w, unsigned int h, GLint format);
 
+	// uploads mip levels that were generated offline, levels[0] becomes level 0 and no mipmaps are generated.
+	// w and h are the size of the whole image, levels[0] can be one of its coarser levels (see texture_streaming)
+	void setMipLevels(const std::vector<mip_level>& levels, unsigned int w, unsigned int h, bool compressed, GLint imgFormat, GLenum pxFormat, GLenum pxType);
+
 	void setParams(bool mipmaps, filter filtering, wrap wrapping, float anisotropic, const glm::vec4& borderColor);
 	void setParams(bool mipmaps, filter filtering, wrap wrapping, float anisotropic)
 	{
@@ -50,6 +62,9 @@ public:
 		setParams(mipmaps, filtering, wrapping, 1.0f);
 	}
 
+	// depth textures only, for sampling with sampler2DShadow
+	void setDepthCompare(bool enabled);
+
 	unsigned int width() const { return m_width; }
 	unsigned int height() const { return m_height; }
 
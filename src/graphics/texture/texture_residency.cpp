@@ -0,0 +1,59 @@
+#include "texture_residency.hpp"
+#include "Texture.hpp"
+#include "core/app_info.hpp"
+
+#include <iostream>
+
+bool texture_residency::s_initialized = false, texture_residency::s_bindless = false;
+std::unordered_map<const Texture*, GLuint64> texture_residency::s_handles;
+texture_residency::frame_stats texture_residency::s_frame = { }, texture_residency::s_lastFrame = { };
+
+void texture_residency::init()
+{
+	if (!s_initialized) {
+		s_initialized = true;
+		s_bindless = app_info::get<bool>("bindlessTextures", true) && GLEW_ARB_bindless_texture;
+
+		std::cout << "Texture binding: " << (s_bindless ? "bindless" : "texture units") << std::endl;
+	}
+}
+
+bool texture_residency::isBindless()
+{
+	init(); // lazy initialization
+	return s_bindless;
+}
+
+GLuint64 texture_residency::makeResident(const Texture* texture)
+{
+	if (!isBindless() || !texture->isImmutable())
+		return 0;
+
+	auto it = s_handles.find(texture);
+	if (it != s_handles.end())
+		return it->second;
+
+	// creating a handle makes the texture immutable on the GL side as well
+	GLuint64 handle = glGetTextureHandleARB(texture->glObj());
+	if (handle) {
+		glMakeTextureHandleResidentARB(handle);
+		s_handles.emplace(texture, handle);
+	}
+
+	return handle;
+}
+
+void texture_residency::release(const Texture* texture)
+{
+	auto it = s_handles.find(texture);
+	if (it != s_handles.end()) {
+		glMakeTextureHandleNonResidentARB(it->second);
+		s_handles.erase(it);
+	}
+}
+
+void texture_residency::endFrame()
+{
+	s_lastFrame = s_frame;
+	s_frame = frame_stats();
+}
@@ -0,0 +1,47 @@
+#ifndef TEXTURE_RESIDENCY_HPP
+#define TEXTURE_RESIDENCY_HPP
+
+#include "graphics/gl_state.hpp"
+
+#include <unordered_map>
+
+class Texture;
+
+// Decides how textures reach the samplers of a shader program.
+// With ARB_bindless_texture, immutable textures get a resident handle that is written to the sampler uniform
+// (once per program and texture), so drawing with them does not bind anything.
+// Other textures (render targets, or everything if the extension is missing or disabled) are bound to the unit
+// the program assigned to the sampler.
+class texture_residency
+{
+public:
+	struct frame_stats
+	{
+		std::size_t unitBinds;
+		std::size_t handleUpdates;
+	};
+
+	// whether bindless textures are in use, shaders get the extension enabled in this case
+	static bool isBindless();
+
+	// returns the resident handle of the texture, or 0 if it has to be bound to a unit
+	static GLuint64 makeResident(const Texture* texture);
+	static void release(const Texture* texture);
+
+	static void countUnitBind() { ++s_frame.unitBinds; }
+	static void countHandleUpdate() { ++s_frame.handleUpdates; }
+
+	static std::size_t residentCount() { return s_handles.size(); }
+
+	static const frame_stats& lastFrame() { return s_lastFrame; }
+	static void endFrame();
+
+private:
+	static bool s_initialized, s_bindless;
+	static std::unordered_map<const Texture*, GLuint64> s_handles;
+	static frame_stats s_frame, s_lastFrame;
+
+	static void init();
+};
+
+#endif // TEXTURE_RESIDENCY_HPP
@@ -0,0 +1,255 @@
+#include "texture_streaming.hpp"
+#include "core/app_info.hpp"
+#include "util/profiler.hpp"
+
+#include "boost/filesystem/fstream.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+#define STBI_NO_STDIO
+#include "stb_image.h"
+
+bool texture_streaming::s_initialized = false, texture_streaming::s_enabled = false;
+unsigned int texture_streaming::s_minResidentSize = 0;
+StreamingPolicy texture_streaming::s_policy(0, 0);
+std::unordered_map<const Texture2D*, texture_streaming::texture_entry> texture_streaming::s_textures;
+std::vector<const Texture2D*> texture_streaming::s_byId;
+std::size_t texture_streaming::s_nextSerial = 0, texture_streaming::s_pending = 0;
+
+std::thread texture_streaming::s_thread;
+std::mutex texture_streaming::s_mutex;
+std::condition_variable texture_streaming::s_wakeup;
+std::deque<texture_streaming::load_request> texture_streaming::s_requests;
+std::vector<texture_streaming::load_result> texture_streaming::s_results;
+bool texture_streaming::s_stop = false;
+
+void texture_streaming::init()
+{
+	if (!s_initialized) {
+		s_initialized = true;
+		s_enabled = app_info::get<bool>("textureStreaming", true);
+		s_minResidentSize = std::max(app_info::get<unsigned int>("textureStreamingMinSize", 128), 1u);
+
+		s_policy.setBudget(std::size_t(app_info::get<unsigned int>("textureStreamingBudget", 512)) * 1024 * 1024);
+		s_policy.setKeepFrames(app_info::get<unsigned int>("textureStreamingKeepFrames", 60));
+
+		if (s_enabled) {
+			std::cout << "Texture streaming: " << (s_policy.budget() / (1024 * 1024)) << " MB budget" << std::endl;
+			s_thread = std::thread(&texture_streaming::ioThread);
+		}
+	}
+}
+
+bool texture_streaming::isEnabled()
+{
+	init(); // lazy initialization
+	return s_enabled;
+}
+
+std::size_t texture_streaming::pinnedLevel(const rbt_info& info)
+{
+	if (!isEnabled() || info.levels <= 1)
+		return 0;
+
+	std::size_t level = 0;
+	while ((level + 1 < info.levels) && (std::max(info.width >> level, info.height >> level) > s_minResidentSize)) {
+		++level;
+	}
+
+	return level;
+}
+
+bool texture_streaming::readLevels(std::istream& file, const rbt_info& info, const std::vector<level_source>& sources, std::size_t first,
+	std::vector<Texture2D::mip_level>& levels)
+{
+	levels.clear();
+
+	std::vector<unsigned char> data;
+	for (std::size_t l = first; l < sources.size(); ++l) {
+		const level_source& src = sources[l];
+
+		data.resize(src.size);
+		file.clear();
+		file.seekg(src.offset);
+		file.read(reinterpret_cast<char*>(data.data()), src.size);
+		if (!file)
+			return false;
+
+		Texture2D::mip_level level;
+		level.width = std::max(info.width >> l, 1u);
+		level.height = std::max(info.height >> l, 1u);
+
+		if (info.compressed) {
+			level.data.swap(data);
+		} else {
+			int w, h, comp;
+			unsigned char* pixels = stbi_load_from_memory(data.data(), int(data.size()), &w, &h, &comp, 4);
+			if (!pixels)
+				return false;
+
+			level.data.assign(pixels, pixels + std::size_t(w) * std::size_t(h) * 4);
+			stbi_image_free(pixels);
+		}
+
+		levels.push_back(std::move(level));
+	}
+
+	return true;
+}
+
+void texture_streaming::add(Texture2D* texture, const path& file, const rbt_info& info, std::vector<level_source> levels, std::size_t residentLevel)
+{
+	if (!isEnabled() || levels.empty())
+		return;
+
+	// what the levels take up on the GPU, uncompressed levels are decoded to RGBA8
+	std::vector<std::size_t> levelBytes(levels.size());
+	for (std::size_t l = 0; l < levels.size(); ++l) {
+		levelBytes[l] = info.compressed ? levels[l].size
+			: std::size_t(std::max(info.width >> l, 1u)) * std::size_t(std::max(info.height >> l, 1u)) * 4;
+	}
+
+	StreamingPolicy::texture_id id = s_policy.add(std::move(levelBytes), residentLevel);
+	if (id >= s_byId.size())
+		s_byId.resize(id + 1, nullptr);
+	s_byId[id] = texture;
+
+	s_textures[texture] = texture_entry{ texture, file, info, std::move(levels), id, s_nextSerial++, false, false };
+}
+
+void texture_streaming::remove(const Texture2D* texture)
+{
+	auto it = s_textures.find(texture);
+	if (it != s_textures.end()) {
+		s_policy.remove(it->second.id);
+		s_byId[it->second.id] = nullptr;
+		s_textures.erase(it);
+	}
+}
+
+void texture_streaming::request(const Texture2D* texture, float texelsPerPixel)
+{
+	auto it = s_textures.find(texture);
+	if (it != s_textures.end()) {
+		s_policy.request(it->second.id, StreamingPolicy::requiredLevel(texelsPerPixel));
+	}
+}
+
+void texture_streaming::endFrame()
+{
+	if (!s_enabled) return;
+
+	PROFILE_FUNCTION();
+
+	std::vector<load_result> results;
+	{
+		std::lock_guard<std::mutex> lock(s_mutex);
+		results.swap(s_results);
+	}
+
+	for (load_result& result : results) {
+		--s_pending;
+		applyResult(result);
+	}
+
+	bool started = false;
+
+	for (const StreamingPolicy::change& c : s_policy.update()) {
+		if (s_pending >= max_pending_loads)
+			break;
+
+		texture_entry& entry = s_textures[s_byId[c.id]];
+		if (entry.loading || entry.failed)
+			continue;
+
+		entry.loading = true;
+		++s_pending;
+		started = true;
+
+		std::lock_guard<std::mutex> lock(s_mutex);
+		s_requests.push_back({ entry.texture, entry.serial, entry.file, entry.info, entry.levels, c.level });
+	}
+
+	if (started)
+		s_wakeup.notify_one();
+}
+
+void texture_streaming::applyResult(load_result& result)
+{
+	auto it = s_textures.find(result.texture);
+	if (it == s_textures.end() || it->second.serial != result.serial)
+		return; // the texture was deleted in the meantime
+
+	texture_entry& entry = it->second;
+	entry.loading = false;
+
+	if (!result.success) {
+		// keep what is resident and don't try again
+		std::cout << "WARNING: failed to stream texture \"" << entry.file << "\"" << std::endl;
+		entry.failed = true;
+		return;
+	}
+
+	const rbt_info& info = entry.info;
+
+	Texture2D replacement;
+	replacement.setParams(info.params.mipmaps, info.params.filter, info.params.wrap, info.params.anisotropic);
+	replacement.setMipLevels(result.levels, info.width, info.height, info.compressed, info.imgFormat, info.pxFormat, info.pxType);
+
+	// the old GL texture is deleted along with the replacement
+	entry.texture->swapObject(replacement);
+	s_policy.setResidentLevel(entry.id, result.first);
+}
+
+void texture_streaming::shutdown()
+{
+	if (s_thread.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock(s_mutex);
+			s_stop = true;
+		}
+		s_wakeup.notify_one();
+		s_thread.join();
+	}
+
+	s_requests.clear();
+	s_results.clear();
+	s_pending = 0;
+	s_enabled = false;
+}
+
+void texture_streaming::ioThread()
+{
+	profiler::set_thread_name("texture streaming");
+
+	std::unique_lock<std::mutex> lock(s_mutex);
+	while (true) {
+		s_wakeup.wait(lock, []() { return s_stop || !s_requests.empty(); });
+		if (s_stop)
+			return;
+
+		load_request request = std::move(s_requests.front());
+		s_requests.pop_front();
+
+		lock.unlock();
+		load_result result = load(request);
+		lock.lock();
+
+		s_results.push_back(std::move(result));
+	}
+}
+
+texture_streaming::load_result texture_streaming::load(const load_request& request)
+{
+	PROFILE_SCOPE("load texture levels");
+
+	load_result result{ request.texture, request.serial, request.first, { }, false };
+
+	boost::filesystem::ifstream file(request.file, std::ios::binary);
+	if (file) {
+		result.success = readLevels(file, request.info, request.levels, request.first, result.levels);
+	}
+
+	return result;
+}
@@ -0,0 +1,114 @@
+#ifndef TEXTURE_STREAMING_HPP
+#define TEXTURE_STREAMING_HPP
+
+#include "Texture2D.hpp"
+#include "StreamingPolicy.hpp"
+
+#include "path.hpp"
+#include "rbt.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <istream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Loads the fine mip levels of imported textures only when they are needed.
+// Textures with offline generated mip levels (see conproc) are imported with their coarse levels only, those always stay resident.
+// Every frame the renderer requests the levels the visible objects need, StreamingPolicy decides what is resident within the budget.
+// The levels are read and decoded by a background thread, then the texture gets a new GL texture holding the new set of levels
+// (imported textures are immutable, see texture_residency), so it keeps its old levels until the new ones have arrived.
+class texture_streaming
+{
+public:
+	// loads and evictions waiting for the I/O thread at the same time
+	static const std::size_t max_pending_loads = 8;
+
+	struct level_source
+	{
+		std::streamoff offset; // of the level data in the file
+		std::size_t size;
+	};
+
+	static bool isEnabled();
+
+	// finest level that is loaded on import and never evicted (0 if the texture is not streamed)
+	static std::size_t pinnedLevel(const rbt_info& info);
+
+	// reads and decodes the levels from first on
+	static bool readLevels(std::istream& file, const rbt_info& info, const std::vector<level_source>& sources, std::size_t first,
+		std::vector<Texture2D::mip_level>& levels);
+
+	// the texture holds the levels from residentLevel on, the finer ones are streamed in from file
+	static void add(Texture2D* texture, const path& file, const rbt_info& info, std::vector<level_source> levels, std::size_t residentLevel);
+	static void remove(const Texture2D* texture);
+
+	// the texture is sampled with texelsPerPixel texels of its finest level per screen pixel (textures that are not streamed are ignored)
+	static void request(const Texture2D* texture, float texelsPerPixel);
+
+	// applies the finished loads and starts new ones from the requests of this frame
+	static void endFrame();
+	// stops the I/O thread
+	static void shutdown();
+
+	static std::size_t textureCount() { return s_policy.textureCount(); }
+	static std::size_t budget() { return s_policy.budget(); }
+	static std::size_t residentBytes() { return s_policy.residentBytes(); }
+	static std::size_t requestedBytes() { return s_policy.requestedBytes(); }
+	static std::size_t pendingLoads() { return s_pending; }
+
+private:
+	struct texture_entry
+	{
+		Texture2D* texture;
+		path file;
+		rbt_info info;
+		std::vector<level_source> levels;
+		StreamingPolicy::texture_id id;
+		std::size_t serial; // tells a texture apart from a later one at the same address
+		bool loading, failed;
+	};
+
+	struct load_request
+	{
+		const Texture2D* texture;
+		std::size_t serial;
+		path file;
+		rbt_info info;
+		std::vector<level_source> levels;
+		std::size_t first;
+	};
+
+	struct load_result
+	{
+		const Texture2D* texture;
+		std::size_t serial;
+		std::size_t first;
+		std::vector<Texture2D::mip_level> levels;
+		bool success;
+	};
+
+	static bool s_initialized, s_enabled;
+	static unsigned int s_minResidentSize;
+	static StreamingPolicy s_policy;
+	static std::unordered_map<const Texture2D*, texture_entry> s_textures;
+	static std::vector<const Texture2D*> s_byId;
+	static std::size_t s_nextSerial, s_pending;
+
+	// shared with the I/O thread
+	static std::thread s_thread;
+	static std::mutex s_mutex;
+	static std::condition_variable s_wakeup;
+	static std::deque<load_request> s_requests;
+	static std::vector<load_result> s_results;
+	static bool s_stop;
+
+	static void init();
+	static void ioThread();
+	static load_result load(const load_request& request);
+	static void applyResult(load_result& result);
+};
+
+#endif // TEXTURE_STREAMING_HPP
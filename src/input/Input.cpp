@@ -1,12 +1,33 @@
 #include "Input.hpp"
+#include "core/Engine.hpp"
+#include "core/app_info.hpp"
 #include "scripting/class_registry.hpp"
+#include "util/profiler.hpp"
 
 #include "GLFW/glfw3.h"
 
-Input::Input(GLFWwindow* window) : m_window(window), m_frame(0), m_cursorX(0.0f), m_cursorY(0.0f), m_cursorDeltaX(0.0f), m_cursorDeltaY(0.0f)
+#include <iostream>
+
+Input::Input(GLFWwindow* window) : m_window(window), m_frame(0), m_cursorX(0.0f), m_cursorY(0.0f), m_cursorDeltaX(0.0f), m_cursorDeltaY(0.0f),
+	m_replaying(false), m_replayCursorLocked(false), m_replayPos(0), m_recordStartFrame(0), m_replayStartFrame(0)
 {
 	glfwSetKeyCallback(m_window, Input::keyCallback);
 	glfwSetMouseButtonCallback(m_window, Input::mouseButtonCallback);
+
+	auto replayPath = app_info::get<path>("inputReplay");
+	if (!replayPath.empty()) {
+		startReplay(replayPath);
+	}
+
+	auto recordPath = app_info::get<path>("inputRecord");
+	if (!recordPath.empty()) {
+		startRecording(recordPath);
+	}
+}
+
+Input::~Input()
+{
+	stopRecording();
 }
 
 bool Input::getKey(input_key key)
@@ -45,12 +66,25 @@ bool Input::getMouseButtonReleased(input_mbutton mbutton)
 
 bool Input::isCursorLocked() const
 {
+	if (m_replaying)
+		return m_replayCursorLocked;
+
 	return glfwGetInputMode(m_window, GLFW_CURSOR) == GLFW_CURSOR_DISABLED;
 }
 
 void Input::setCursorLocked(bool val)
 {
+	// the real cursor is left alone during a replay
+	if (m_replaying) {
+		m_replayCursorLocked = val;
+		return;
+	}
+
 	glfwSetInputMode(m_window, GLFW_CURSOR, val ? GLFW_CURSOR_DISABLED : GLFW_CURSOR_NORMAL);
+
+	if (m_recorder) {
+		record(input_event::cursor_lock, val, 0);
+	}
 }
 
 glm::vec2 Input::cursorPos() const
@@ -63,24 +97,159 @@ glm::vec2 Input::cursorDelta() const
 	return glm::vec2(m_cursorDeltaX, m_cursorDeltaY);
 }
 
+void Input::startRecording(const path& p)
+{
+	stopRecording();
+
+	m_recorder = std::make_unique<input_log_writer>(p);
+	if (!m_recorder->isGood()) {
+		m_recorder.reset();
+		return;
+	}
+
+	std::cout << "recording input to " << p << std::endl;
+
+	// frame 0 holds the state at the start of the recording, so a replay starts out the same
+	m_recordStartFrame = m_frame;
+
+	record(input_event::cursor, 0, 0, m_cursorX, m_cursorY);
+	record(input_event::cursor_lock, isCursorLocked(), 0);
+
+	for (auto& k : m_keys) {
+		if (k.second.down) {
+			record(input_event::key, k.first, GLFW_PRESS);
+		}
+	}
+
+	for (auto& mb : m_mbuttons) {
+		if (mb.second.down) {
+			record(input_event::mouse_button, mb.first, GLFW_PRESS);
+		}
+	}
+}
+
+void Input::stopRecording()
+{
+	if (m_recorder) {
+		m_recorder.reset();
+		std::cout << "input recording stopped" << std::endl;
+	}
+}
+
+void Input::startReplay(const path& p)
+{
+	std::vector<input_event> events;
+	if (!read_input_log(p, events))
+		return;
+
+	std::cout << "replaying input from " << p << std::endl;
+
+	m_replayEvents = std::move(events);
+	m_replayPos = 0;
+	m_replayStartFrame = m_frame;
+	m_replaying = true;
+	m_replayCursorLocked = false;
+
+	m_keys.clear();
+	m_mbuttons.clear();
+
+	// apply the initial state (frame 0) right away
+	float x = m_cursorX, y = m_cursorY;
+	replayEvents(x, y);
+
+	m_cursorX = x;
+	m_cursorY = y;
+	m_cursorDeltaX = m_cursorDeltaY = 0.0f;
+}
+
+void Input::stopReplay()
+{
+	if (!m_replaying)
+		return;
+
+	m_replaying = false;
+	m_replayEvents.clear();
+
+	// continue with live input without a jump in the cursor delta
+	double cx, cy;
+	glfwGetCursorPos(m_window, &cx, &cy);
+	m_cursorX = float(cx);
+	m_cursorY = float(cy);
+
+	std::cout << "input replay finished" << std::endl;
+}
+
 void Input::update()
 {
+	PROFILE_FUNCTION();
+
 	++m_frame;
 
+	// callbacks ignore live input while replaying
 	glfwPollEvents();
 
-	double cx, cy;
-	glfwGetCursorPos(m_window, &cx, &cy);
-	float newX = float(cx), newY = float(cy);
+	float newX = m_cursorX, newY = m_cursorY;
+
+	if (m_replaying) {
+		replayEvents(newX, newY);
+	} else {
+		double cx, cy;
+		glfwGetCursorPos(m_window, &cx, &cy);
+		newX = float(cx);
+		newY = float(cy);
+
+		if (m_recorder && (newX != m_cursorX || newY != m_cursorY)) {
+			record(input_event::cursor, 0, 0, newX, newY);
+		}
+	}
 
 	m_cursorDeltaX = newX - m_cursorX;
 	m_cursorDeltaY = newY - m_cursorY;
 
 	m_cursorX = newX;
 	m_cursorY = newY;
+
+	if (m_replaying && m_replayPos >= m_replayEvents.size()) {
+		stopReplay();
+	}
 }
 
-void Input::onKey(int key, int action)
+void Input::replayEvents(float& cursorX, float& cursorY)
+{
+	unsigned int frame = m_frame - m_replayStartFrame;
+
+	for (; m_replayPos < m_replayEvents.size(); ++m_replayPos) {
+		const input_event& e = m_replayEvents[m_replayPos];
+		if (e.frame > frame)
+			break;
+
+		switch (e.type) {
+		case input_event::key:
+			applyKey(e.code, e.action);
+			break;
+		case input_event::mouse_button:
+			applyMouseButton(e.code, e.action);
+			break;
+		case input_event::cursor:
+			cursorX = e.x;
+			cursorY = e.y;
+			break;
+		case input_event::cursor_lock:
+			m_replayCursorLocked = e.code != 0;
+			break;
+		}
+	}
+}
+
+void Input::record(input_event::event_type type, int code, int action, float x, float y)
+{
+	Engine* engine = Engine::instance();
+	float time = engine ? float(engine->time()) : 0.0f;
+
+	m_recorder->write({ m_frame - m_recordStartFrame, time, type, code, action, x, y });
+}
+
+void Input::applyKey(int key, int action)
 {
 	button& k = m_keys[key];
 	if (action != GLFW_REPEAT) {
@@ -89,13 +258,37 @@ void Input::onKey(int key, int action)
 	}
 }
 
-void Input::onMouseButton(int mbutton, int action)
+void Input::applyMouseButton(int mbutton, int action)
 {
 	button& mb = m_mbuttons[mbutton];
 	mb.down = action == GLFW_PRESS;
 	mb.lastAction = m_frame;
 }
 
+void Input::onKey(int key, int action)
+{
+	if (m_replaying || action == GLFW_REPEAT)
+		return;
+
+	applyKey(key, action);
+
+	if (m_recorder) {
+		record(input_event::key, key, action);
+	}
+}
+
+void Input::onMouseButton(int mbutton, int action)
+{
+	if (m_replaying)
+		return;
+
+	applyMouseButton(mbutton, action);
+
+	if (m_recorder) {
+		record(input_event::mouse_button, mbutton, action);
+	}
+}
+
 
 input_key check_key(lua_State* L, int arg)
 {
@@ -197,3 +390,20 @@ SCRIPTING_AUTO_MODULE_METHOD(Input, cursorPos)
 SCRIPTING_AUTO_MODULE_METHOD(Input, cursorDeltaX)
 SCRIPTING_AUTO_MODULE_METHOD(Input, cursorDeltaY)
 SCRIPTING_AUTO_MODULE_METHOD(Input, cursorDelta)
+
+SCRIPTING_AUTO_MODULE_METHOD(Input, isRecording)
+SCRIPTING_AUTO_MODULE_METHOD(Input, stopRecording)
+SCRIPTING_AUTO_MODULE_METHOD(Input, isReplaying)
+SCRIPTING_AUTO_MODULE_METHOD(Input, stopReplay)
+
+SCRIPTING_DEFINE_METHOD(Input, startRecording)
+{
+	Input::instance()->startRecording(scripting::check_arg<std::string>(L, 1));
+	return 0;
+}
+
+SCRIPTING_DEFINE_METHOD(Input, startReplay)
+{
+	Input::instance()->startReplay(scripting::check_arg<std::string>(L, 1));
+	return 0;
+}
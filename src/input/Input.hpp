@@ -2,15 +2,19 @@
 #define INPUT_HPP
 
 #include <unordered_map>
+#include <memory>
+#include <vector>
 
 #include "util/singleton.hpp"
 #include "glm.hpp"
 #include "keys.hpp"
+#include "input_log.hpp"
 
 class Input : public singleton<Input>
 {
 public:
 	explicit Input(GLFWwindow* window);
+	~Input();
 
 	bool getKey(input_key key);
 	bool getKeyPressed(input_key key);
@@ -31,6 +35,16 @@ public:
 	float cursorDeltaY() const { return m_cursorDeltaY; }
 	glm::vec2 cursorDelta() const;
 
+	// while recording, all input events are written to a log (see input_log.hpp)
+	bool isRecording() const { return bool(m_recorder); }
+	void startRecording(const path& p);
+	void stopRecording();
+
+	// while replaying, events are taken from a recorded log and live input is ignored
+	bool isReplaying() const { return m_replaying; }
+	void startReplay(const path& p);
+	void stopReplay();
+
 	void update();
 
 private:
@@ -53,9 +67,22 @@ private:
 	float m_cursorX, m_cursorY;
 	float m_cursorDeltaX, m_cursorDeltaY;
 
+	std::unique_ptr<input_log_writer> m_recorder;
+
+	bool m_replaying, m_replayCursorLocked;
+	std::vector<input_event> m_replayEvents;
+	std::size_t m_replayPos;
+	unsigned int m_recordStartFrame, m_replayStartFrame;
+
+	void applyKey(int key, int action);
+	void applyMouseButton(int mbutton, int action);
+
 	void onKey(int key, int action);
 	void onMouseButton(int mbutton, int action);
 
+	void record(input_event::event_type type, int code, int action, float x = 0.0f, float y = 0.0f);
+	void replayEvents(float& cursorX, float& cursorY);
+
 	static void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
 	{
 		instance()->onKey(key, action);
@@ -0,0 +1,120 @@
+#include "input_log.hpp"
+
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+	const char log_magic[4] = { 'D', 'R', 'I', 'L' };
+	const std::uint32_t log_version = 1;
+
+	template<typename T>
+	void write_raw(std::ostream& stream, T value)
+	{
+		stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template<typename T>
+	bool read_raw(std::istream& stream, T& value)
+	{
+		return bool(stream.read(reinterpret_cast<char*>(&value), sizeof(T)));
+	}
+}
+
+input_log_writer::input_log_writer(const path& p) : m_file(p, std::ios::binary)
+{
+	if (m_file) {
+		m_file.write(log_magic, sizeof(log_magic));
+		write_raw(m_file, log_version);
+	} else {
+		std::cout << "ERROR: could not open input log " << p << " for writing" << std::endl;
+	}
+}
+
+void input_log_writer::write(const input_event& e)
+{
+	write_raw(m_file, e.frame);
+	write_raw(m_file, e.time);
+	write_raw(m_file, std::uint8_t(e.type));
+
+	switch (e.type) {
+	case input_event::key:
+	case input_event::mouse_button:
+		write_raw(m_file, std::int16_t(e.code));
+		write_raw(m_file, std::uint8_t(e.action));
+		break;
+	case input_event::cursor:
+		write_raw(m_file, e.x);
+		write_raw(m_file, e.y);
+		break;
+	case input_event::cursor_lock:
+		write_raw(m_file, std::uint8_t(e.code));
+		break;
+	}
+}
+
+bool read_input_log(const path& p, std::vector<input_event>& events)
+{
+	boost::filesystem::ifstream file(p, std::ios::binary);
+	if (!file) {
+		std::cout << "ERROR: could not open input log " << p << std::endl;
+		return false;
+	}
+
+	char magic[4];
+	std::uint32_t version;
+	if (!(file.read(magic, sizeof(magic)) && read_raw(file, version)) || std::memcmp(magic, log_magic, sizeof(magic)) != 0) {
+		std::cout << "ERROR: " << p << " is not an input log" << std::endl;
+		return false;
+	}
+
+	if (version != log_version) {
+		std::cout << "ERROR: unsupported input log version " << version << std::endl;
+		return false;
+	}
+
+	while (true) {
+		input_event e{};
+		std::uint8_t type;
+
+		if (!(read_raw(file, e.frame) && read_raw(file, e.time) && read_raw(file, type)))
+			break;
+
+		e.type = input_event::event_type(type);
+
+		bool good = true;
+		switch (e.type) {
+		case input_event::key:
+		case input_event::mouse_button:
+		{
+			std::int16_t code;
+			std::uint8_t action;
+			good = read_raw(file, code) && read_raw(file, action);
+			e.code = code;
+			e.action = action;
+			break;
+		}
+		case input_event::cursor:
+			good = read_raw(file, e.x) && read_raw(file, e.y);
+			break;
+		case input_event::cursor_lock:
+		{
+			std::uint8_t locked;
+			good = read_raw(file, locked);
+			e.code = locked;
+			break;
+		}
+		default:
+			good = false;
+		}
+
+		if (!good) {
+			std::cout << "WARNING: input log " << p << " is truncated or corrupted" << std::endl;
+			break;
+		}
+
+		events.push_back(e);
+	}
+
+	return true;
+}
@@ -0,0 +1,49 @@
+#ifndef INPUT_LOG_HPP
+#define INPUT_LOG_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "path.hpp"
+#include "boost/filesystem/fstream.hpp"
+
+// Binary log of input events, used to record and deterministically replay input.
+// Layout (little endian): "DRIL", uint32 version, followed by the events.
+// Every event starts with uint32 frame, float time, uint8 type, followed by:
+//   key, mouse_button: int16 code, uint8 action
+//   cursor: float x, float y
+//   cursor_lock: uint8 locked
+struct input_event
+{
+	enum event_type : std::uint8_t
+	{
+		key,
+		mouse_button,
+		cursor,
+		cursor_lock
+	};
+
+	std::uint32_t frame;
+	float time;
+	event_type type;
+	int code, action;	// code is the key or mouse button (or whether the cursor is locked)
+	float x, y;
+};
+
+class input_log_writer
+{
+public:
+	explicit input_log_writer(const path& p);
+
+	bool isGood() const { return bool(m_file); }
+
+	void write(const input_event& e);
+
+private:
+	boost::filesystem::ofstream m_file;
+};
+
+// reads all events of a log (in recorded order), returns false if the file could not be read
+bool read_input_log(const path& p, std::vector<input_event>& events);
+
+#endif // INPUT_LOG_HPP
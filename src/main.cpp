@@ -33,10 +33,22 @@ int main(int argc, char *argv[])
 #endif // USE_WINMAIN
 
 	path aiPath;
+	bool headless = false;
+	unsigned int maxFrames = 0;
+	path benchmark, benchmarkOutput;
+	path recordInput, replayInput;
+	std::string glBackend;
 
 	options_description desc;
 	desc.add_options()
-		("app-info,a", value<path>(&aiPath)->default_value("app-info.json"), "application info file to use");
+		("app-info,a", value<path>(&aiPath)->default_value("app-info.json"), "application info file to use")
+		("headless", bool_switch(&headless), "render offscreen without a visible window")
+		("frames,f", value<unsigned int>(&maxFrames), "number of frames to run before exiting")
+		("benchmark,b", value<path>(&benchmark), "benchmark definition to run")
+		("benchmark-output,o", value<path>(&benchmarkOutput), "file to write the benchmark report to")
+		("record-input", value<path>(&recordInput), "record all input events to a log file")
+		("replay-input", value<path>(&replayInput), "replay input events from a log file")
+		("gl-backend", value<std::string>(&glBackend), "GL backend to use (native, recording or null)");
 
 	variables_map vm;
 
@@ -45,6 +57,21 @@ int main(int argc, char *argv[])
 
 	app_info::load(aiPath);
 
+	if (headless)
+		app_info::set("headless", true);
+	if (vm.count("frames"))
+		app_info::set("maxFrames", maxFrames);
+	if (vm.count("benchmark"))
+		app_info::set("benchmark", benchmark.generic_string());
+	if (vm.count("benchmark-output"))
+		app_info::set("benchmarkOutput", benchmarkOutput.generic_string());
+	if (vm.count("record-input"))
+		app_info::set("inputRecord", recordInput.generic_string());
+	if (vm.count("replay-input"))
+		app_info::set("inputReplay", replayInput.generic_string());
+	if (vm.count("gl-backend"))
+		app_info::set("glBackend", glBackend);
+
 	Engine engine;
 	return engine.run();
 }
@@ -11,7 +11,8 @@ namespace scripting
 {
 	REGISTER_COMPONENT_CLASS(Behaviour);
 
-	Behaviour::Behaviour(Entity* parent) : Component(parent), m_good(false), m_objIdx(0) { }
+	Behaviour::Behaviour(Entity* parent) : Component(parent), m_good(false), m_objIdx(0),
+		m_selfRef(LUA_NOREF), m_initRef(LUA_NOREF), m_updateRef(LUA_NOREF), m_dispatched(false), m_dispatchActive(false) { }
 
 	Behaviour::~Behaviour()
 	{
@@ -21,11 +22,51 @@ namespace scripting
 	void Behaviour::destroyObj()
 	{
 		if (m_good) {
-			Environment::instance()->invalidateObject(this);
+			auto scriptEnv = Environment::instance();
+			scriptEnv->releaseBehaviour(this);
+			releaseRefs(scriptEnv->state());
+			scriptEnv->invalidateObject(this);
 			m_good = false;
 		}
 	}
 
+	void Behaviour::cacheRefs(lua_State* L)
+	{
+		// expects the lua object on top of the stack
+		m_initRef = refMethod(L, "init");
+		m_updateRef = refMethod(L, "update");
+
+		lua_pushvalue(L, -1);
+		m_selfRef = luaL_ref(L, LUA_REGISTRYINDEX);
+	}
+
+	void Behaviour::releaseRefs(lua_State* L)
+	{
+		luaL_unref(L, LUA_REGISTRYINDEX, m_selfRef);
+		luaL_unref(L, LUA_REGISTRYINDEX, m_initRef);
+		luaL_unref(L, LUA_REGISTRYINDEX, m_updateRef);
+
+		m_selfRef = m_initRef = m_updateRef = LUA_NOREF;
+	}
+
+	int Behaviour::refMethod(lua_State* L, const char* name)
+	{
+		lua_getfield(L, -1, name);
+
+		// methods that are not overridden by the script resolve to the empty default implementation, so skip them
+		lua_getglobal(L, "Behaviour");
+		lua_getfield(L, -1, name);
+		bool isDefault = lua_rawequal(L, -1, -3) != 0;
+		lua_pop(L, 2);
+
+		if (isDefault || !lua_isfunction(L, -1)) {
+			lua_pop(L, 1);
+			return LUA_NOREF;
+		}
+
+		return luaL_ref(L, LUA_REGISTRYINDEX);
+	}
+
 	void Behaviour::setScript(const std::string& name)
 	{
 		destroyObj();
@@ -39,6 +80,9 @@ namespace scripting
 
 		scriptEnv->createObject(m_script, this, false);
 		m_good = lua_istable(L, -1);
+		if (m_good) {
+			cacheRefs(L);
+		}
 		scriptEnv->pop();
 	}
 
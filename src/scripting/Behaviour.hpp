@@ -45,6 +45,9 @@ namespace scripting
 
 		bool isGood() const { return m_good; }
 
+		bool hasInit() const { return m_initRef != LUA_NOREF; }
+		bool hasUpdate() const { return m_updateRef != LUA_NOREF; }
+
 		COMPONENT_ALLOW_MULTIPLE;
 
 	protected:
@@ -55,13 +58,24 @@ namespace scripting
 		bool m_good;
 		int m_objIdx;
 
+		// registry references to the lua object and its methods (resolved once in setScript)
+		int m_selfRef, m_initRef, m_updateRef;
+		// whether this behaviour is registered with (and marked active in) the lua-side update dispatcher
+		bool m_dispatched, m_dispatchActive;
+
 		void destroyObj();
 
+		void cacheRefs(lua_State* L);
+		void releaseRefs(lua_State* L);
+		int refMethod(lua_State* L, const char* name);
+
 		void beginProperties(lua_State* L);
 		void endProperties(lua_State* L);
 		void submitProperty(lua_State* L, const std::string& name);
 
 		static lua_State* getState();
+
+		friend class Environment;
 	};
 }
 
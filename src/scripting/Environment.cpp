@@ -1,14 +1,19 @@
 #include "Environment.hpp"
 #include "Behaviour.hpp"
 #include "class_registry.hpp"
+#include "math_types.hpp"
 #include "content/Content.hpp"
 #include "core/app_info.hpp"
 #include "core/Component.hpp"
+#include "util/profiler.hpp"
 
 #include "boost/format.hpp"
 
 #include "lua.hpp"
 
+#include <algorithm>
+#include <chrono>
+
 namespace scripting
 {
 	int lua_destroy(lua_State* L)
@@ -17,13 +22,16 @@ namespace scripting
 		return 0;
 	}
 
-	Environment::Environment()
+	Environment::Environment() : m_dispatcherRef(LUA_NOREF), m_gcBudget(-1.0), m_gcTime(0.0),
+		m_gcStepSize(app_info::get<int>("luaGcStepSize", 8)), m_gcFullCollectFactor(std::max(app_info::get<double>("luaGcFullCollectFactor", 2.0), 1.0)),
+		m_gcBaseline(0), m_profileOutput(app_info::get<path>("scriptProfileOutput", "script_profile"))
 	{
-		m_L = luaL_newstate();
+		m_L = lua_newstate(&lua_allocator::alloc, &m_allocator);
 
 		lua_atpanic(m_L, &Environment::onPanic);
 
 		luaL_openlibs(m_L);
+		open_math_types(m_L);
 
 		lua_getglobal(m_L, "package");
 		lua_getfield(m_L, -1, "path");
@@ -47,11 +55,27 @@ namespace scripting
 		lua_pushcfunction(m_L, lua_destroy);
 		lua_setglobal(m_L, "destroy");
 
+		if (loadModule("BehaviourDispatch")) {
+			lua_getglobal(m_L, "BehaviourDispatch");
+			m_dispatcherRef = luaL_ref(m_L, LUA_REGISTRYINDEX);
+		} else {
+			std::cout << "ERROR: failed to load behaviour dispatcher!" << std::endl;
+		}
+
 		class_registry::applyAllClasses();
+
+		setGcBudget(app_info::get<double>("luaGcBudget", 1.0));
+
+		m_profiler.setSampleInterval(m_L, app_info::get<int>("scriptSampleInterval", 0));
+		m_profiler.setEnabled(m_L, app_info::get<bool>("scriptProfiling", false));
 	}
 
 	Environment::~Environment()
 	{
+		if (!m_profiler.empty()) {
+			dumpProfile();
+		}
+
 		lua_close(m_L);
 	}
 
@@ -156,30 +180,166 @@ namespace scripting
 		}
 	}
 
+	// only called for behaviours (see Engine::subscribe)
 	void Environment::addComponent(Component* cmpt)
 	{
-		auto b = dynamic_cast<Behaviour*>(cmpt);
-		if (b) {
-			m_addBhvs.push_back(b);
-		}
+		m_addBhvs.push_back(static_cast<Behaviour*>(cmpt));
 	}
 
 	void Environment::removeComponent(Component* cmpt)
 	{
-		auto b = dynamic_cast<Behaviour*>(cmpt);
-		if (b) {
-			m_removeBhvs.push_back(b);
+		m_removeBhvs.push_back(static_cast<Behaviour*>(cmpt));
+	}
+
+	void Environment::releaseBehaviour(Behaviour* bhv)
+	{
+		if (bhv->m_dispatched) {
+			pushDispatcherFunction("remove");
+			lua_rawgeti(m_L, LUA_REGISTRYINDEX, bhv->m_selfRef);
+			safeCall(1, 0);
+
+			bhv->m_dispatched = false;
+			bhv->m_dispatchActive = false;
 		}
 	}
 
+	bool Environment::isRemoved(Behaviour* bhv) const
+	{
+		return std::find(m_removeBhvs.begin(), m_removeBhvs.end(), bhv) != m_removeBhvs.end();
+	}
+
+	void Environment::initBehaviour(Behaviour* bhv)
+	{
+		if (bhv->isGood() && bhv->hasInit()) {
+			using clock = std::chrono::high_resolution_clock;
+			using ms = std::chrono::duration<double, std::milli>;
+
+			auto start = clock::now();
+
+			lua_rawgeti(m_L, LUA_REGISTRYINDEX, bhv->m_initRef);
+			lua_rawgeti(m_L, LUA_REGISTRYINDEX, bhv->m_selfRef);
+			safeCall(1, 0);
+
+			if (m_profiler.enabled()) {
+				m_profiler.record(bhv->script(), "init", ms(clock::now() - start).count());
+			}
+		}
+	}
+
+	void Environment::syncDispatcher(Behaviour* bhv)
+	{
+		if (!(bhv->isGood() && bhv->hasUpdate()))
+			return;
+
+		if (!bhv->m_dispatched) {
+			pushDispatcherFunction("add");
+			lua_rawgeti(m_L, LUA_REGISTRYINDEX, bhv->m_selfRef);
+			lua_rawgeti(m_L, LUA_REGISTRYINDEX, bhv->m_updateRef);
+			lua_pushstring(m_L, bhv->script().c_str());
+			safeCall(3, 0);
+
+			bhv->m_dispatched = true;
+		}
+
+		bool active = bhv->isActiveAndEnabled();
+		if (active != bhv->m_dispatchActive) {
+			pushDispatcherFunction("setActive");
+			lua_rawgeti(m_L, LUA_REGISTRYINDEX, bhv->m_selfRef);
+			lua_pushboolean(m_L, active);
+			safeCall(2, 0);
+
+			bhv->m_dispatchActive = active;
+		}
+	}
+
+	void Environment::pushDispatcherFunction(const char* name)
+	{
+		lua_rawgeti(m_L, LUA_REGISTRYINDEX, m_dispatcherRef);
+		lua_getfield(m_L, -1, name);
+		lua_remove(m_L, -2);
+	}
+
+	void Environment::dispatchUpdates()
+	{
+		PROFILE_FUNCTION();
+
+		pushDispatcherFunction("update");
+		lua_pushcfunction(m_L, &Environment::traceback);
+
+		if (m_profiler.enabled()) {
+			lua_pushcfunction(m_L, &script_profiler::lua_clock);
+			lua_pushcfunction(m_L, &script_profiler::lua_record);
+			safeCall(3, 0);
+		} else {
+			safeCall(1, 0);
+		}
+	}
+
+	void Environment::setGcBudget(double budget)
+	{
+		bool wasManual = m_gcBudget >= 0.0;
+		m_gcBudget = budget;
+		bool manual = m_gcBudget >= 0.0;
+
+		if (manual != wasManual) {
+			lua_gc(m_L, manual ? LUA_GCSTOP : LUA_GCRESTART, 0);
+			m_gcBaseline = m_allocator.totalBytes();
+		}
+	}
+
+	void Environment::collectGarbage()
+	{
+		PROFILE_FUNCTION();
+
+		using clock = std::chrono::high_resolution_clock;
+		using ms = std::chrono::duration<double, std::milli>;
+
+		m_gcTime = 0.0;
+
+		if (m_gcBudget < 0.0)
+			return;
+
+		auto start = clock::now();
+
+		// always do at least one step so that garbage can't pile up indefinitely
+		do {
+			// stop early once a cycle has been completed
+			if (lua_gc(m_L, LUA_GCSTEP, m_gcStepSize)) {
+				m_gcBaseline = m_allocator.totalBytes();
+				break;
+			}
+
+			m_gcTime = ms(clock::now() - start).count();
+		} while (m_gcTime < m_gcBudget);
+
+		// the steps fall behind scripts that make garbage faster than the budget allows to collect it,
+		// a full collection keeps the heap bounded (like the pause of lua's own collector)
+		if (m_allocator.totalBytes() > m_gcBaseline * m_gcFullCollectFactor) {
+			lua_gc(m_L, LUA_GCCOLLECT, 0);
+			m_gcBaseline = m_allocator.totalBytes();
+		}
+
+		m_gcTime = ms(clock::now() - start).count();
+	}
+
 	void Environment::update()
 	{
+		PROFILE_FUNCTION();
+
+		m_allocator.beginFrame();
+		m_profiler.beginFrame();
+
 		while (m_addBhvs.size() > 0) {
-			m_behaviours.insert(m_behaviours.end(), m_addBhvs.begin(), m_addBhvs.end());
 			auto abs = std::move(m_addBhvs);
-			
+			m_addBhvs.clear();
+
 			for (auto b : abs) {
-				callBehaviourMethod(b, "init");
+				// behaviours might have been destroyed before they got initialized
+				if (isRemoved(b))
+					continue;
+
+				m_behaviours.push_back(b);
+				initBehaviour(b);
 			}
 		}
 
@@ -190,11 +350,16 @@ namespace scripting
 
 		// TODO: call start functions (on the first frame a behaviour is enabled)
 
+		if (m_dispatcherRef == LUA_NOREF)
+			return;
+
+		// only changes in the active state cross over into lua here, the updates themselves are called in one go
 		for (auto b : m_behaviours) {
-			if (b->isActiveAndEnabled()) {
-				callBehaviourMethod(b, "update");
-			}
+			syncDispatcher(b);
 		}
+
+		dispatchUpdates();
+		collectGarbage();
 	}
 
 	int Environment::traceback(lua_State* L)
@@ -226,4 +391,26 @@ namespace scripting
 
 		return 0;
 	}
-}
\ No newline at end of file
+}
+
+SCRIPTING_REGISTER_STATIC_CLASS(Scripting)
+
+SCRIPTING_AUTO_MODULE_METHOD_C(Scripting, memoryUsage, scripting::Environment)
+SCRIPTING_AUTO_MODULE_METHOD_C(Scripting, peakMemoryUsage, scripting::Environment)
+SCRIPTING_AUTO_MODULE_METHOD_C(Scripting, frameAllocations, scripting::Environment)
+SCRIPTING_AUTO_MODULE_METHOD_C(Scripting, frameFrees, scripting::Environment)
+SCRIPTING_AUTO_MODULE_METHOD_C(Scripting, frameAllocatedBytes, scripting::Environment)
+
+SCRIPTING_AUTO_MODULE_METHOD_C(Scripting, gcTime, scripting::Environment)
+SCRIPTING_AUTO_MODULE_METHOD_C(Scripting, gcBudget, scripting::Environment)
+SCRIPTING_AUTO_MODULE_METHOD_C(Scripting, setGcBudget, scripting::Environment)
+
+SCRIPTING_REGISTER_STATIC_CLASS(ScriptProfiler)
+
+SCRIPTING_AUTO_MODULE_METHOD_CM(ScriptProfiler, isEnabled, scripting::Environment, isProfilingEnabled)
+SCRIPTING_AUTO_MODULE_METHOD_CM(ScriptProfiler, setEnabled, scripting::Environment, setProfilingEnabled)
+SCRIPTING_AUTO_MODULE_METHOD_CM(ScriptProfiler, sampleInterval, scripting::Environment, profilerSampleInterval)
+SCRIPTING_AUTO_MODULE_METHOD_CM(ScriptProfiler, setSampleInterval, scripting::Environment, setProfilerSampleInterval)
+SCRIPTING_AUTO_MODULE_METHOD_CM(ScriptProfiler, frameTime, scripting::Environment, profiledFrameTime)
+SCRIPTING_AUTO_MODULE_METHOD_CM(ScriptProfiler, reset, scripting::Environment, resetProfiler)
+SCRIPTING_AUTO_MODULE_METHOD_CM(ScriptProfiler, dump, scripting::Environment, dumpProfile)
@@ -8,6 +8,8 @@
 #include "core/ComponentModule.hpp"
 
 #include "utility.hpp"
+#include "lua_allocator.hpp"
+#include "script_profiler.hpp"
 
 #include <string>
 #include <vector>
@@ -118,13 +120,64 @@ namespace scripting
 
 		void callBehaviourMethod(Behaviour* bhv, const std::string& methodName);
 
+		void releaseBehaviour(Behaviour* bhv);
+
 		virtual void addComponent(Component* cmpt) final;
 		virtual void removeComponent(Component* cmpt) final;
 
+		// memory statistics (the frame counters refer to the last completed frame)
+		std::size_t memoryUsage() const { return m_allocator.totalBytes(); }
+		std::size_t peakMemoryUsage() const { return m_allocator.peakBytes(); }
+		std::size_t frameAllocations() const { return m_allocator.lastFrame().allocations; }
+		std::size_t frameFrees() const { return m_allocator.lastFrame().frees; }
+		std::size_t frameAllocatedBytes() const { return m_allocator.lastFrame().allocatedBytes; }
+
+		// time spent collecting garbage during the last frame (in milliseconds)
+		double gcTime() const { return m_gcTime; }
+
+		// maximum time per frame spent on incremental garbage collection (in milliseconds).
+		// a negative budget gives control back to lua's automatic collector.
+		// if the heap grows past luaGcFullCollectFactor times its size after the last cycle, a full collection is done regardless.
+		double gcBudget() const { return m_gcBudget; }
+		void setGcBudget(double budget);
+
+		script_profiler& profiler() { return m_profiler; }
+
+		bool isProfilingEnabled() const { return m_profiler.enabled(); }
+		void setProfilingEnabled(bool val) { m_profiler.setEnabled(m_L, val); }
+
+		int profilerSampleInterval() const { return m_profiler.sampleInterval(); }
+		void setProfilerSampleInterval(int interval) { m_profiler.setSampleInterval(m_L, interval); }
+
+		double profiledFrameTime(const std::string& script) const { return m_profiler.lastFrameTime(script); }
+
+		void resetProfiler() { m_profiler.reset(); }
+		bool dumpProfile() const { return m_profiler.dump(m_profileOutput); }
+
 	private:
+		lua_allocator m_allocator;
 		lua_State *m_L;
 		std::vector<Behaviour*> m_behaviours, m_addBhvs, m_removeBhvs;
 
+		// registry reference to the lua-side update dispatcher (see BehaviourDispatch.lua)
+		int m_dispatcherRef;
+
+		double m_gcBudget, m_gcTime;
+		int m_gcStepSize;
+		double m_gcFullCollectFactor;
+		std::size_t m_gcBaseline; // heap size after the last completed cycle
+
+		script_profiler m_profiler;
+		path m_profileOutput;
+
+		bool isRemoved(Behaviour* bhv) const;
+
+		void initBehaviour(Behaviour* bhv);
+		void syncDispatcher(Behaviour* bhv);
+		void pushDispatcherFunction(const char* name);
+		void dispatchUpdates();
+		void collectGarbage();
+
 		static int traceback(lua_State* L);
 		static int onPanic(lua_State* L);
 	};
@@ -0,0 +1,169 @@
+#include "lua_allocator.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace scripting
+{
+	namespace
+	{
+		const std::size_t size_classes[] = { 16, 32, 48, 64, 96, 128, 192, 256 };
+		const std::size_t num_size_classes = sizeof(size_classes) / sizeof(size_classes[0]);
+		const std::size_t max_small_size = 256;
+		const std::size_t no_size_class = num_size_classes;
+
+		// (size - 1) / 16 -> size class
+		const std::size_t class_lookup[] = { 0, 1, 2, 3, 4, 4, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7 };
+
+		const std::size_t chunk_size = 64 * 1024;
+
+		std::size_t size_class(std::size_t size)
+		{
+			return (size > 0 && size <= max_small_size) ? class_lookup[(size - 1) / 16] : no_size_class;
+		}
+
+		struct free_block
+		{
+			free_block* next;
+		};
+	}
+
+	struct lua_allocator::block_pools
+	{
+		free_block* heads[num_size_classes];
+		std::vector<std::unique_ptr<char[]>> chunks;
+
+		block_pools()
+		{
+			std::fill(std::begin(heads), std::end(heads), nullptr);
+		}
+
+		void* pop(std::size_t c)
+		{
+			if (!heads[c]) {
+				refill(c);
+			}
+
+			free_block* b = heads[c];
+			heads[c] = b->next;
+			return b;
+		}
+
+		void push(std::size_t c, void* ptr)
+		{
+			free_block* b = static_cast<free_block*>(ptr);
+			b->next = heads[c];
+			heads[c] = b;
+		}
+
+		void refill(std::size_t c)
+		{
+			std::size_t bs = size_classes[c];
+
+			chunks.emplace_back(new char[chunk_size]);
+			char* mem = chunks.back().get();
+
+			// push in reverse so that consecutive allocations are adjacent in memory
+			std::size_t count = chunk_size / bs;
+			for (std::size_t i = count; i > 0; i--) {
+				push(c, mem + (i - 1) * bs);
+			}
+		}
+	};
+
+	lua_allocator::lua_allocator() : m_pools(std::make_unique<block_pools>()), m_totalBytes(0), m_peakBytes(0) { }
+
+	lua_allocator::~lua_allocator() = default;
+
+	void lua_allocator::beginFrame()
+	{
+		m_lastFrame = m_frame;
+		m_frame = lua_alloc_stats();
+	}
+
+	void* lua_allocator::alloc(void* ud, void* ptr, std::size_t osize, std::size_t nsize)
+	{
+		return static_cast<lua_allocator*>(ud)->reallocate(ptr, osize, nsize);
+	}
+
+	void* lua_allocator::reallocate(void* ptr, std::size_t osize, std::size_t nsize)
+	{
+		// for new blocks lua passes the type of the object in osize
+		if (!ptr) {
+			osize = 0;
+		}
+
+		if (nsize == 0) {
+			if (ptr) {
+				freeBlock(ptr, osize);
+				m_totalBytes -= osize;
+				m_frame.frees++;
+			}
+			return nullptr;
+		}
+
+		void* result;
+		std::size_t oc = size_class(osize), nc = size_class(nsize);
+
+		if (!ptr) {
+			result = allocateBlock(nsize);
+		} else if (oc == nc && nc != no_size_class) {
+			// still fits into the same block
+			result = ptr;
+		} else if (oc == no_size_class && nc == no_size_class) {
+			result = std::realloc(ptr, nsize);
+		} else {
+			result = allocateBlock(nsize);
+			if (result) {
+				std::memcpy(result, ptr, std::min(osize, nsize));
+				freeBlock(ptr, osize);
+			}
+		}
+
+		if (!result) {
+			// lua expects shrinking to always succeed, the old block is big enough.
+			// it is freed with the new size later, so it ends up in the free list of the smaller class
+			// (a malloc block is then reused by the pools and never given back to malloc)
+			if (nsize > osize)
+				return nullptr; // lua keeps the old block
+
+			result = ptr;
+		}
+
+		m_totalBytes = m_totalBytes - osize + nsize;
+		m_peakBytes = std::max(m_peakBytes, m_totalBytes);
+
+		m_frame.allocations++;
+		m_frame.allocatedBytes += nsize;
+
+		return result;
+	}
+
+	void* lua_allocator::allocateBlock(std::size_t size)
+	{
+		std::size_t c = size_class(size);
+		if (c != no_size_class) {
+			try {
+				return m_pools->pop(c);
+			} catch (std::bad_alloc&) {
+				return nullptr;
+			}
+		}
+
+		return std::malloc(size);
+	}
+
+	void lua_allocator::freeBlock(void* ptr, std::size_t size)
+	{
+		std::size_t c = size_class(size);
+		if (c != no_size_class) {
+			m_pools->push(c, ptr);
+		} else {
+			std::free(ptr);
+		}
+	}
+}
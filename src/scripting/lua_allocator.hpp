@@ -0,0 +1,53 @@
+#ifndef SCRIPTING_LUA_ALLOCATOR_HPP
+#define SCRIPTING_LUA_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <memory>
+
+namespace scripting
+{
+	struct lua_alloc_stats
+	{
+		std::size_t allocations, frees, allocatedBytes;
+
+		lua_alloc_stats() : allocations(0), frees(0), allocatedBytes(0) { }
+	};
+
+	// lua_Alloc implementation (pass lua_allocator::alloc and a pointer to the allocator to lua_newstate).
+	// Small blocks are served from free lists, one per size class. The chunks backing these lists belong to the allocator
+	// and are given back when it is destroyed (after lua_close), larger blocks go straight to malloc/realloc/free.
+	// Like the lua state itself, an allocator must only be used by one thread at a time.
+	class lua_allocator
+	{
+	public:
+		lua_allocator();
+		~lua_allocator();
+
+		lua_allocator(const lua_allocator&) = delete;
+		lua_allocator& operator=(const lua_allocator&) = delete;
+
+		// bytes currently in use by the lua state
+		std::size_t totalBytes() const { return m_totalBytes; }
+		std::size_t peakBytes() const { return m_peakBytes; }
+
+		// counters of the last completed frame
+		const lua_alloc_stats& lastFrame() const { return m_lastFrame; }
+
+		void beginFrame();
+
+		static void* alloc(void* ud, void* ptr, std::size_t osize, std::size_t nsize);
+
+	private:
+		struct block_pools;
+
+		std::unique_ptr<block_pools> m_pools;
+		std::size_t m_totalBytes, m_peakBytes;
+		lua_alloc_stats m_frame, m_lastFrame;
+
+		void* reallocate(void* ptr, std::size_t osize, std::size_t nsize);
+		void* allocateBlock(std::size_t size);
+		void freeBlock(void* ptr, std::size_t size);
+	};
+}
+
+#endif // SCRIPTING_LUA_ALLOCATOR_HPP
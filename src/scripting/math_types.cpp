@@ -0,0 +1,643 @@
+#include "math_types.hpp"
+#include "utility.hpp"
+
+#include "boost/format.hpp"
+
+namespace scripting
+{
+	namespace
+	{
+		// values of binary operations may be given as native userdata or as plain tables
+		template<typename T>
+		T math_arg(lua_State* L, int arg)
+		{
+			T* ptr = to_math<T>(L, arg);
+			return ptr ? *ptr : check_arg<T>(L, arg);
+		}
+
+		template<typename T>
+		T& math_self(lua_State* L)
+		{
+			return *check_math<T>(L, 1);
+		}
+
+		template<typename T>
+		int component_index(lua_State* L, int keyIdx)
+		{
+			int c = -1;
+
+			if (lua_type(L, keyIdx) == LUA_TNUMBER) {
+				c = int(lua_tointeger(L, keyIdx)) - 1;
+			} else if (lua_type(L, keyIdx) == LUA_TSTRING) {
+				std::size_t len;
+				const char* key = lua_tolstring(L, keyIdx, &len);
+				if (len == 1) {
+					switch (key[0]) {
+					case 'x': case 'r': c = 0; break;
+					case 'y': case 'g': c = 1; break;
+					case 'z': case 'b': c = 2; break;
+					case 'w': case 'a': c = 3; break;
+					}
+				}
+			}
+
+			return (c >= 0 && c < math_type<T>::size) ? c : -1;
+		}
+
+		// returns a component (if the key is an index or a component name) or looks the key up in the module table
+		template<typename T>
+		int mm_index(lua_State* L)
+		{
+			const T& self = math_self<T>(L);
+
+			int c = component_index<T>(L, 2);
+			if (c >= 0) {
+				lua_pushnumber(L, self[c]);
+			} else {
+				lua_pushvalue(L, 2);
+				lua_rawget(L, lua_upvalueindex(1));
+			}
+			return 1;
+		}
+
+		template<typename T>
+		int mm_newindex(lua_State* L)
+		{
+			T& self = math_self<T>(L);
+
+			int c = component_index<T>(L, 2);
+			luaL_argcheck(L, c >= 0, 2, "invalid component");
+			self[c] = float(luaL_checknumber(L, 3));
+			return 0;
+		}
+
+		template<typename T>
+		int mm_add(lua_State* L)
+		{
+			push_math(L, T(math_arg<T>(L, 1) + math_arg<T>(L, 2)));
+			return 1;
+		}
+
+		template<typename T>
+		int mm_sub(lua_State* L)
+		{
+			push_math(L, T(math_arg<T>(L, 1) - math_arg<T>(L, 2)));
+			return 1;
+		}
+
+		template<typename T>
+		int mm_mul(lua_State* L)
+		{
+			if (lua_type(L, 1) == LUA_TNUMBER) {
+				push_math(L, T(float(lua_tonumber(L, 1)) * math_arg<T>(L, 2)));
+			} else if (lua_type(L, 2) == LUA_TNUMBER) {
+				push_math(L, T(math_arg<T>(L, 1) * float(lua_tonumber(L, 2))));
+			} else {
+				push_math(L, T(math_arg<T>(L, 1) * math_arg<T>(L, 2)));
+			}
+			return 1;
+		}
+
+		template<typename T>
+		int mm_div(lua_State* L)
+		{
+			if (lua_type(L, 2) == LUA_TNUMBER) {
+				push_math(L, T(math_arg<T>(L, 1) / float(lua_tonumber(L, 2))));
+			} else {
+				push_math(L, T(math_arg<T>(L, 1) / math_arg<T>(L, 2)));
+			}
+			return 1;
+		}
+
+		template<typename T>
+		int mm_unm(lua_State* L)
+		{
+			push_math(L, T(-math_self<T>(L)));
+			return 1;
+		}
+
+		template<typename T>
+		int mm_len(lua_State* L)
+		{
+			lua_pushinteger(L, math_type<T>::size);
+			return 1;
+		}
+
+		template<typename T>
+		int mm_eq(lua_State* L)
+		{
+			T* lhs = to_math<T>(L, 1);
+			T* rhs = to_math<T>(L, 2);
+			lua_pushboolean(L, lhs && rhs && (*lhs == *rhs));
+			return 1;
+		}
+
+		template<typename T>
+		int mm_tostring(lua_State* L)
+		{
+			const T& self = math_self<T>(L);
+			const float* ptr = glm::value_ptr(self);
+
+			std::string str = std::string(math_type<T>::name + 6) + "(";
+			for (int i = 0; i < math_type<T>::size; ++i) {
+				if (i > 0) str += ", ";
+				str += (boost::format("%1%") % ptr[i]).str();
+			}
+			str += ")";
+
+			lua_pushstring(L, str.c_str());
+			return 1;
+		}
+
+		// mutable methods return self so they can be chained
+
+		template<typename T>
+		int m_set(lua_State* L)
+		{
+			T& self = math_self<T>(L);
+			if (lua_type(L, 2) == LUA_TNUMBER) {
+				float* ptr = glm::value_ptr(self);
+				for (int i = 0; i < math_type<T>::size; ++i) {
+					ptr[i] = float(luaL_optnumber(L, i + 2, ptr[i]));
+				}
+			} else {
+				self = math_arg<T>(L, 2);
+			}
+			lua_settop(L, 1);
+			return 1;
+		}
+
+		template<typename T>
+		int m_copy(lua_State* L)
+		{
+			push_math(L, math_arg<T>(L, 1));
+			return 1;
+		}
+
+		template<typename T>
+		int v_new(lua_State* L)
+		{
+			T result;
+			if (lua_type(L, 1) > LUA_TNUMBER) {
+				result = math_arg<T>(L, 1);
+			} else {
+				for (int i = 0; i < math_type<T>::size; ++i) {
+					result[i] = float(luaL_optnumber(L, i + 1, 0.0));
+				}
+			}
+			push_math(L, result);
+			return 1;
+		}
+
+		template<typename T>
+		int v_add(lua_State* L)
+		{
+			math_self<T>(L) += math_arg<T>(L, 2);
+			lua_settop(L, 1);
+			return 1;
+		}
+
+		template<typename T>
+		int v_sub(lua_State* L)
+		{
+			math_self<T>(L) -= math_arg<T>(L, 2);
+			lua_settop(L, 1);
+			return 1;
+		}
+
+		template<typename T>
+		int v_mul(lua_State* L)
+		{
+			if (lua_type(L, 2) == LUA_TNUMBER) {
+				math_self<T>(L) *= float(lua_tonumber(L, 2));
+			} else {
+				math_self<T>(L) *= math_arg<T>(L, 2);
+			}
+			lua_settop(L, 1);
+			return 1;
+		}
+
+		template<typename T>
+		int v_addScaled(lua_State* L)
+		{
+			math_self<T>(L) += math_arg<T>(L, 2) * float(luaL_checknumber(L, 3));
+			lua_settop(L, 1);
+			return 1;
+		}
+
+		template<typename T>
+		int v_normalize(lua_State* L)
+		{
+			T& self = math_self<T>(L);
+			self = glm::normalize(self);
+			lua_settop(L, 1);
+			return 1;
+		}
+
+		template<typename T>
+		int v_normalized(lua_State* L)
+		{
+			push_math(L, T(glm::normalize(math_arg<T>(L, 1))));
+			return 1;
+		}
+
+		template<typename T>
+		int v_length(lua_State* L)
+		{
+			lua_pushnumber(L, glm::length(math_arg<T>(L, 1)));
+			return 1;
+		}
+
+		template<typename T>
+		int v_length2(lua_State* L)
+		{
+			lua_pushnumber(L, glm::length2(math_arg<T>(L, 1)));
+			return 1;
+		}
+
+		template<typename T>
+		int v_dot(lua_State* L)
+		{
+			lua_pushnumber(L, glm::dot(math_arg<T>(L, 1), math_arg<T>(L, 2)));
+			return 1;
+		}
+
+		template<typename T>
+		int v_distance(lua_State* L)
+		{
+			lua_pushnumber(L, glm::distance(math_arg<T>(L, 1), math_arg<T>(L, 2)));
+			return 1;
+		}
+
+		template<typename T>
+		int v_lerp(lua_State* L)
+		{
+			push_math(L, T(glm::mix(math_arg<T>(L, 1), math_arg<T>(L, 2), float(luaL_checknumber(L, 3)))));
+			return 1;
+		}
+
+		template<typename T, int X, int Y, int Z = 0, int W = 0>
+		int v_constant(lua_State* L)
+		{
+			T result;
+			const float values[] = { float(X), float(Y), float(Z), float(W) };
+			for (int i = 0; i < math_type<T>::size; ++i) {
+				result[i] = values[i];
+			}
+			push_math(L, result);
+			return 1;
+		}
+
+		int vec3_cross(lua_State* L)
+		{
+			push_math(L, glm::cross(math_arg<glm::vec3>(L, 1), math_arg<glm::vec3>(L, 2)), 3);
+			return 1;
+		}
+
+		int vec4_point(lua_State* L)
+		{
+			glm::vec3 p(float(luaL_optnumber(L, 1, 0.0)), float(luaL_optnumber(L, 2, 0.0)), float(luaL_optnumber(L, 3, 0.0)));
+			push_math(L, glm::vec4(p, 1.0f));
+			return 1;
+		}
+
+		int vec4_dir(lua_State* L)
+		{
+			glm::vec3 d(float(luaL_optnumber(L, 1, 0.0)), float(luaL_optnumber(L, 2, 0.0)), float(luaL_optnumber(L, 3, 0.0)));
+			push_math(L, glm::vec4(d, 0.0f));
+			return 1;
+		}
+
+		// quaternion components are given in x, y, z, w order (like in the old lua implementation)
+		int quat_new(lua_State* L)
+		{
+			if (lua_type(L, 1) > LUA_TNUMBER) {
+				push_math(L, math_arg<glm::quat>(L, 1));
+			} else {
+				push_math(L, glm::quat(
+					float(luaL_optnumber(L, 4, 1.0)),
+					float(luaL_optnumber(L, 1, 0.0)),
+					float(luaL_optnumber(L, 2, 0.0)),
+					float(luaL_optnumber(L, 3, 0.0))
+				));
+			}
+			return 1;
+		}
+
+		int quat_identity(lua_State* L)
+		{
+			push_math(L, glm::quat());
+			return 1;
+		}
+
+		int quat_fromAngleAxis(lua_State* L)
+		{
+			push_math(L, glm::angleAxis(float(luaL_checknumber(L, 1)), math_arg<glm::vec3>(L, 2)));
+			return 1;
+		}
+
+		int quat_fromEulerAngles(lua_State* L)
+		{
+			glm::vec3 angles(float(luaL_checknumber(L, 1)), float(luaL_checknumber(L, 2)), float(luaL_checknumber(L, 3)));
+			push_math(L, glm::quat(angles));
+			return 1;
+		}
+
+		int quat_rotate(lua_State* L)
+		{
+			push_math(L, math_arg<glm::quat>(L, 1) * math_arg<glm::vec3>(L, 2), 3);
+			return 1;
+		}
+
+		int quat_mul(lua_State* L)
+		{
+			math_self<glm::quat>(L) *= math_arg<glm::quat>(L, 2);
+			lua_settop(L, 1);
+			return 1;
+		}
+
+		int quat_normalized(lua_State* L)
+		{
+			push_math(L, glm::normalize(math_arg<glm::quat>(L, 1)));
+			return 1;
+		}
+
+		int quat_inverse(lua_State* L)
+		{
+			push_math(L, glm::inverse(math_arg<glm::quat>(L, 1)));
+			return 1;
+		}
+
+		int quat_mm_mul(lua_State* L)
+		{
+			glm::quat lhs = math_arg<glm::quat>(L, 1);
+
+			glm::vec3* v = to_math<glm::vec3>(L, 2);
+			if (v) {
+				push_math(L, lhs * (*v));
+			} else if (lua_type(L, 2) == LUA_TNUMBER) {
+				push_math(L, lhs * float(lua_tonumber(L, 2)));
+			} else {
+				push_math(L, lhs * math_arg<glm::quat>(L, 2));
+			}
+			return 1;
+		}
+
+		int quat_mm_unm(lua_State* L)
+		{
+			push_math(L, -math_self<glm::quat>(L));
+			return 1;
+		}
+
+		int mat4_new(lua_State* L)
+		{
+			if (lua_type(L, 1) > LUA_TNUMBER) {
+				push_math(L, math_arg<glm::mat4>(L, 1));
+			} else {
+				push_math(L, glm::mat4(float(luaL_optnumber(L, 1, 1.0))));
+			}
+			return 1;
+		}
+
+		int mat4_fromTRS(lua_State* L)
+		{
+			push_math(L, glm::translate(math_arg<glm::vec3>(L, 1)) * glm::toMat4(math_arg<glm::quat>(L, 2)) * glm::scale(math_arg<glm::vec3>(L, 3)));
+			return 1;
+		}
+
+		int mat4_get(lua_State* L)
+		{
+			const glm::mat4& self = math_self<glm::mat4>(L);
+			int c = int(luaL_checkinteger(L, 2));
+			int r = int(luaL_checkinteger(L, 3));
+			luaL_argcheck(L, c >= 1 && c <= 4, 2, "column out of range");
+			luaL_argcheck(L, r >= 1 && r <= 4, 3, "row out of range");
+			lua_pushnumber(L, self[c - 1][r - 1]);
+			return 1;
+		}
+
+		int mat4_setElement(lua_State* L)
+		{
+			glm::mat4& self = math_self<glm::mat4>(L);
+			int c = int(luaL_checkinteger(L, 2));
+			int r = int(luaL_checkinteger(L, 3));
+			luaL_argcheck(L, c >= 1 && c <= 4, 2, "column out of range");
+			luaL_argcheck(L, r >= 1 && r <= 4, 3, "row out of range");
+			self[c - 1][r - 1] = float(luaL_checknumber(L, 4));
+			lua_settop(L, 1);
+			return 1;
+		}
+
+		int mat4_column(lua_State* L)
+		{
+			const glm::mat4& self = math_self<glm::mat4>(L);
+			int c = int(luaL_checkinteger(L, 2));
+			luaL_argcheck(L, c >= 1 && c <= 4, 2, "column out of range");
+			push_math(L, self[c - 1], 3);
+			return 1;
+		}
+
+		int mat4_inverse(lua_State* L)
+		{
+			push_math(L, glm::inverse(math_arg<glm::mat4>(L, 1)), 2);
+			return 1;
+		}
+
+		int mat4_transposed(lua_State* L)
+		{
+			push_math(L, glm::transpose(math_arg<glm::mat4>(L, 1)), 2);
+			return 1;
+		}
+
+		int mat4_transformPoint(lua_State* L)
+		{
+			glm::vec4 p = math_arg<glm::mat4>(L, 1) * glm::vec4(math_arg<glm::vec3>(L, 2), 1.0f);
+			push_math(L, glm::vec3(p) / p.w, 3);
+			return 1;
+		}
+
+		int mat4_transformDir(lua_State* L)
+		{
+			glm::vec4 d = math_arg<glm::mat4>(L, 1) * glm::vec4(math_arg<glm::vec3>(L, 2), 0.0f);
+			push_math(L, glm::vec3(d), 3);
+			return 1;
+		}
+
+		int mat4_mm_index(lua_State* L)
+		{
+			// numeric keys return columns
+			if (lua_type(L, 2) == LUA_TNUMBER) {
+				return mat4_column(L);
+			}
+			lua_pushvalue(L, 2);
+			lua_rawget(L, lua_upvalueindex(1));
+			return 1;
+		}
+
+		int mat4_mm_mul(lua_State* L)
+		{
+			glm::mat4 lhs = math_arg<glm::mat4>(L, 1);
+
+			glm::vec4* v = to_math<glm::vec4>(L, 2);
+			if (v) {
+				push_math(L, lhs * (*v));
+			} else {
+				push_math(L, lhs * math_arg<glm::mat4>(L, 2));
+			}
+			return 1;
+		}
+
+		template<typename T>
+		void add_vector_functions(std::vector<luaL_Reg>& funcs)
+		{
+			funcs.insert(funcs.end(), {
+				{ "new", &v_new<T> },
+				{ "copy", &m_copy<T> },
+				{ "set", &m_set<T> },
+				{ "add", &v_add<T> },
+				{ "sub", &v_sub<T> },
+				{ "mul", &v_mul<T> },
+				{ "addScaled", &v_addScaled<T> },
+				{ "normalize", &v_normalize<T> },
+				{ "normalized", &v_normalized<T> },
+				{ "length", &v_length<T> },
+				{ "length2", &v_length2<T> },
+				{ "dot", &v_dot<T> },
+				{ "distance", &v_distance<T> },
+				{ "lerp", &v_lerp<T> }
+			});
+		}
+
+		template<typename T>
+		void add_metamethods(std::vector<luaL_Reg>& meta)
+		{
+			meta.insert(meta.end(), {
+				{ "__newindex", &mm_newindex<T> },
+				{ "__add", &mm_add<T> },
+				{ "__sub", &mm_sub<T> },
+				{ "__mul", &mm_mul<T> },
+				{ "__div", &mm_div<T> },
+				{ "__unm", &mm_unm<T> },
+				{ "__len", &mm_len<T> },
+				{ "__eq", &mm_eq<T> },
+				{ "__tostring", &mm_tostring<T> },
+				{ "__copy", &m_copy<T> }
+			});
+		}
+
+		// creates the module table (left on the stack) and the metatable for type T
+		template<typename T>
+		void register_type(lua_State* L, std::vector<luaL_Reg> funcs, std::vector<luaL_Reg> meta, lua_CFunction index)
+		{
+			funcs.push_back({ nullptr, nullptr });
+			meta.push_back({ nullptr, nullptr });
+
+			lua_createtable(L, 0, int(funcs.size()));
+			luaL_setfuncs(L, funcs.data(), 0);
+
+			luaL_newmetatable(L, math_type<T>::name);
+			luaL_setfuncs(L, meta.data(), 0);
+
+			// methods are looked up in the module table
+			lua_pushvalue(L, -2);
+			lua_pushcclosure(L, index, 1);
+			lua_setfield(L, -2, "__index");
+
+			lua_pop(L, 1);
+		}
+
+		template<typename T>
+		void register_vector_type(lua_State* L, std::vector<luaL_Reg> funcs)
+		{
+			add_vector_functions<T>(funcs);
+
+			std::vector<luaL_Reg> meta;
+			add_metamethods<T>(meta);
+
+			register_type<T>(L, funcs, meta, &mm_index<T>);
+		}
+
+		int open_xmath_native(lua_State* L)
+		{
+			lua_createtable(L, 0, 5);
+
+			register_vector_type<glm::vec2>(L, {
+				{ "zero", &v_constant<glm::vec2, 0, 0> },
+				{ "one", &v_constant<glm::vec2, 1, 1> },
+				{ "right", &v_constant<glm::vec2, 1, 0> },
+				{ "up", &v_constant<glm::vec2, 0, 1> }
+			});
+			lua_setfield(L, -2, "vec2");
+
+			register_vector_type<glm::vec3>(L, {
+				{ "cross", &vec3_cross },
+				{ "zero", &v_constant<glm::vec3, 0, 0, 0> },
+				{ "one", &v_constant<glm::vec3, 1, 1, 1> },
+				{ "right", &v_constant<glm::vec3, 1, 0, 0> },
+				{ "up", &v_constant<glm::vec3, 0, 1, 0> },
+				{ "forward", &v_constant<glm::vec3, 0, 0, 1> }
+			});
+			lua_setfield(L, -2, "vec3");
+
+			register_vector_type<glm::vec4>(L, {
+				{ "point", &vec4_point },
+				{ "dir", &vec4_dir }
+			});
+			lua_setfield(L, -2, "vec4");
+
+			register_type<glm::quat>(L, {
+				{ "new", &quat_new },
+				{ "copy", &m_copy<glm::quat> },
+				{ "set", &m_set<glm::quat> },
+				{ "identity", &quat_identity },
+				{ "fromAngleAxis", &quat_fromAngleAxis },
+				{ "fromEulerAngles", &quat_fromEulerAngles },
+				{ "rotate", &quat_rotate },
+				{ "mul", &quat_mul },
+				{ "normalized", &quat_normalized },
+				{ "inverse", &quat_inverse },
+				{ "length", &v_length<glm::quat> },
+				{ "dot", &v_dot<glm::quat> }
+			}, {
+				{ "__newindex", &mm_newindex<glm::quat> },
+				{ "__mul", &quat_mm_mul },
+				{ "__unm", &quat_mm_unm },
+				{ "__len", &mm_len<glm::quat> },
+				{ "__eq", &mm_eq<glm::quat> },
+				{ "__tostring", &mm_tostring<glm::quat> },
+				{ "__copy", &m_copy<glm::quat> }
+			}, &mm_index<glm::quat>);
+			lua_setfield(L, -2, "quat");
+
+			register_type<glm::mat4>(L, {
+				{ "new", &mat4_new },
+				{ "copy", &m_copy<glm::mat4> },
+				{ "set", &m_set<glm::mat4> },
+				{ "fromTRS", &mat4_fromTRS },
+				{ "get", &mat4_get },
+				{ "setElement", &mat4_setElement },
+				{ "column", &mat4_column },
+				{ "inverse", &mat4_inverse },
+				{ "transposed", &mat4_transposed },
+				{ "transformPoint", &mat4_transformPoint },
+				{ "transformDir", &mat4_transformDir }
+			}, {
+				{ "__mul", &mat4_mm_mul },
+				{ "__len", &mm_len<glm::mat4> },
+				{ "__eq", &mm_eq<glm::mat4> },
+				{ "__tostring", &mm_tostring<glm::mat4> },
+				{ "__copy", &m_copy<glm::mat4> }
+			}, &mat4_mm_index);
+			lua_setfield(L, -2, "mat4");
+
+			return 1;
+		}
+	}
+
+	void open_math_types(lua_State* L)
+	{
+		// the metatables have to exist before any value is pushed from C++, so the module is loaded right away
+		luaL_requiref(L, "xmath.native", &open_xmath_native, 0);
+		lua_pop(L, 1);
+	}
+}
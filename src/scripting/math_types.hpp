@@ -0,0 +1,88 @@
+#ifndef SCRIPTING_MATH_TYPES_HPP
+#define SCRIPTING_MATH_TYPES_HPP
+
+#include <new>
+
+#include "lua.hpp"
+#include "glm.hpp"
+
+namespace scripting
+{
+	// native userdata types backing the xmath module (vectors, quaternions and matrices are stored as glm values)
+
+	template<typename T>
+	struct math_type;
+
+	template<>
+	struct math_type<glm::vec2>
+	{
+		static constexpr const char* name = "xmath.vec2";
+		static constexpr int size = 2;
+	};
+
+	template<>
+	struct math_type<glm::vec3>
+	{
+		static constexpr const char* name = "xmath.vec3";
+		static constexpr int size = 3;
+	};
+
+	template<>
+	struct math_type<glm::vec4>
+	{
+		static constexpr const char* name = "xmath.vec4";
+		static constexpr int size = 4;
+	};
+
+	template<>
+	struct math_type<glm::quat>
+	{
+		static constexpr const char* name = "xmath.quat";
+		static constexpr int size = 4;
+	};
+
+	template<>
+	struct math_type<glm::mat4>
+	{
+		static constexpr const char* name = "xmath.mat4";
+		static constexpr int size = 16;
+	};
+
+	// registers the native math types and makes them available as require("xmath.native")
+	void open_math_types(lua_State* L);
+
+	template<typename T>
+	T* to_math(lua_State* L, int idx)
+	{
+		return static_cast<T*>(luaL_testudata(L, idx, math_type<T>::name));
+	}
+
+	template<typename T>
+	T* check_math(lua_State* L, int arg)
+	{
+		return static_cast<T*>(luaL_checkudata(L, arg, math_type<T>::name));
+	}
+
+	template<typename T>
+	T* push_math(lua_State* L, const T& value)
+	{
+		T* ptr = new (lua_newuserdata(L, sizeof(T))) T(value);
+		luaL_setmetatable(L, math_type<T>::name);
+		return ptr;
+	}
+
+	// writes the value into the userdata at outArg if there is one (and pushes it), otherwise pushes a new userdata
+	template<typename T>
+	T* push_math(lua_State* L, const T& value, int outArg)
+	{
+		T* out = to_math<T>(L, outArg);
+		if (out) {
+			*out = value;
+			lua_pushvalue(L, outArg);
+			return out;
+		}
+		return push_math(L, value);
+	}
+}
+
+#endif // SCRIPTING_MATH_TYPES_HPP
@@ -0,0 +1,197 @@
+#include "script_profiler.hpp"
+#include "Environment.hpp"
+
+#include "boost/filesystem/fstream.hpp"
+#include "boost/format.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+namespace scripting
+{
+	namespace
+	{
+		std::string frame_name(lua_Debug& ar)
+		{
+			std::string name = ar.name ? ar.name : "?";
+
+			switch (*ar.what) {
+			case 'C':
+				return "[C] " + name;
+			case 'm':
+				return std::string("main chunk (") + ar.short_src + ")";
+			default:
+				return (boost::format("%1% (%2%:%3%)") % name % ar.short_src % ar.linedefined).str();
+			}
+		}
+	}
+
+	script_profiler::script_profiler() : m_enabled(false), m_sampleInterval(0), m_frames(0), m_samples(0), m_start(std::chrono::steady_clock::now()) { }
+
+	void script_profiler::setEnabled(lua_State* L, bool val)
+	{
+		m_enabled = val;
+		updateHook(L);
+	}
+
+	void script_profiler::setSampleInterval(lua_State* L, int interval)
+	{
+		m_sampleInterval = std::max(interval, 0);
+		updateHook(L);
+	}
+
+	void script_profiler::updateHook(lua_State* L) const
+	{
+		// the count hook slows down every script, so it is only installed while the samples are wanted
+		if (m_enabled && m_sampleInterval > 0) {
+			lua_sethook(L, &script_profiler::hook, LUA_MASKCOUNT, m_sampleInterval);
+		} else {
+			lua_sethook(L, nullptr, 0, 0);
+		}
+	}
+
+	double script_profiler::now() const
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+	}
+
+	void script_profiler::beginFrame()
+	{
+		if (!m_enabled)
+			return;
+
+		for (auto& m : m_methods) {
+			method_stats& s = m.second;
+			s.lastFrameTime = s.frameTime;
+			s.maxFrameTime = std::max(s.maxFrameTime, s.frameTime);
+			s.frameTime = 0.0;
+		}
+
+		m_frames++;
+	}
+
+	void script_profiler::record(const std::string& script, const std::string& method, double time)
+	{
+		method_stats& s = m_methods[{ script, method }];
+		s.calls++;
+		s.frameTime += time;
+		s.totalTime += time;
+	}
+
+	double script_profiler::lastFrameTime(const std::string& script) const
+	{
+		double result = 0.0;
+		for (auto& m : m_methods) {
+			if (m.first.first == script) {
+				result += m.second.lastFrameTime;
+			}
+		}
+		return result;
+	}
+
+	void script_profiler::reset()
+	{
+		m_methods.clear();
+		m_stacks.clear();
+		m_frames = 0;
+		m_samples = 0;
+	}
+
+	void script_profiler::writeReport(std::ostream& stream) const
+	{
+		using entry = std::pair<method_key, method_stats>;
+		std::vector<entry> entries(m_methods.begin(), m_methods.end());
+
+		std::sort(entries.begin(), entries.end(), [](const entry& a, const entry& b) {
+			return a.second.totalTime > b.second.totalTime;
+		});
+
+		std::size_t frames = std::max<std::size_t>(m_frames, 1);
+
+		stream << boost::format("%1% frames, %2% samples\n\n") % m_frames % m_samples;
+		stream << boost::format("%-32s %-8s %10s %12s %12s %12s\n") % "script" % "method" % "calls" % "total ms" % "avg ms/frame" % "max ms/frame";
+
+		for (auto& e : entries) {
+			const method_stats& s = e.second;
+			stream << boost::format("%-32s %-8s %10d %12.3f %12.4f %12.4f\n")
+				% e.first.first % e.first.second % s.calls % s.totalTime % (s.totalTime / frames) % s.maxFrameTime;
+		}
+	}
+
+	void script_profiler::writeCollapsedStacks(std::ostream& stream) const
+	{
+		for (auto& s : m_stacks) {
+			stream << s.first << " " << s.second << "\n";
+		}
+	}
+
+	bool script_profiler::dump(const path& base) const
+	{
+		path reportPath(base), stacksPath(base);
+		reportPath += ".txt";
+		stacksPath += ".folded";
+
+		boost::filesystem::ofstream report(reportPath), stacks(stacksPath);
+		if (!report || !stacks) {
+			std::cout << "ERROR: could not write script profile to " << base << std::endl;
+			return false;
+		}
+
+		writeReport(report);
+		writeCollapsedStacks(stacks);
+
+		std::cout << "script profile written to " << reportPath << " and " << stacksPath << std::endl;
+		return true;
+	}
+
+	void script_profiler::sample(lua_State* L)
+	{
+		std::vector<std::string> frames;
+		lua_Debug ar;
+
+		for (int level = 0; lua_getstack(L, level, &ar); level++) {
+			lua_getinfo(L, "Sn", &ar);
+			frames.push_back(frame_name(ar));
+		}
+
+		if (frames.empty())
+			return;
+
+		// collapsed stacks start at the outermost frame
+		std::string stack;
+		for (auto it = frames.rbegin(); it != frames.rend(); ++it) {
+			if (!stack.empty()) {
+				stack += ';';
+			}
+			stack += *it;
+		}
+
+		m_stacks[stack]++;
+		m_samples++;
+	}
+
+	int script_profiler::lua_clock(lua_State* L)
+	{
+		lua_pushnumber(L, Environment::instance()->profiler().now());
+		return 1;
+	}
+
+	int script_profiler::lua_record(lua_State* L)
+	{
+		std::string script = luaL_checkstring(L, 1);
+		std::string method = luaL_checkstring(L, 2);
+		double time = luaL_checknumber(L, 3);
+
+		Environment::instance()->profiler().record(script, method, time);
+		return 0;
+	}
+
+	void script_profiler::hook(lua_State* L, lua_Debug* ar)
+	{
+		if (ar->event == LUA_HOOKCOUNT) {
+			Environment::instance()->profiler().sample(L);
+		}
+	}
+}
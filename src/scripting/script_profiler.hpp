@@ -0,0 +1,91 @@
+#ifndef SCRIPTING_SCRIPT_PROFILER_HPP
+#define SCRIPTING_SCRIPT_PROFILER_HPP
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <ostream>
+#include <cstddef>
+
+#include "path.hpp"
+#include "lua.hpp"
+
+namespace scripting
+{
+	// Measures the wall time spent in behaviour methods (per script and method, accumulated per frame)
+	// and optionally samples lua call stacks using a count hook. Samples are aggregated into collapsed stacks
+	// ("outer;inner;leaf count" per line), which can be fed directly into flamegraph tools.
+	class script_profiler
+	{
+	public:
+		struct method_stats
+		{
+			std::size_t calls;
+			double frameTime, lastFrameTime, maxFrameTime, totalTime; // in milliseconds
+
+			method_stats() : calls(0), frameTime(0.0), lastFrameTime(0.0), maxFrameTime(0.0), totalTime(0.0) { }
+		};
+
+		script_profiler();
+
+		bool enabled() const { return m_enabled; }
+		// installs or removes the sampling hook
+		void setEnabled(lua_State* L, bool val);
+
+		// number of lua instructions between two samples (0 if sampling is disabled), only sampled while enabled
+		int sampleInterval() const { return m_sampleInterval; }
+		void setSampleInterval(lua_State* L, int interval);
+
+		// milliseconds since the profiler was created
+		double now() const;
+
+		void beginFrame();
+		void record(const std::string& script, const std::string& method, double time);
+
+		// time spent in all methods of a script during the last frame
+		double lastFrameTime(const std::string& script) const;
+
+		void reset();
+		bool empty() const { return m_methods.empty() && m_stacks.empty(); }
+
+		// writes a table of all method timings, sorted by their total time (the same order as their average time per frame)
+		void writeReport(std::ostream& stream) const;
+		void writeCollapsedStacks(std::ostream& stream) const;
+
+		// writes <base>.txt (report) and <base>.folded (collapsed stacks)
+		bool dump(const path& base) const;
+
+		// returns now() of the active profiler (used by the lua-side update dispatcher)
+		static int lua_clock(lua_State* L);
+		// adds a measurement (script, method, milliseconds) to the active profiler
+		static int lua_record(lua_State* L);
+
+	private:
+		using method_key = std::pair<std::string, std::string>;
+
+		struct key_hash
+		{
+			std::size_t operator() (const method_key& key) const
+			{
+				std::hash<std::string> h;
+				return h(key.first) ^ (h(key.second) * 31);
+			}
+		};
+
+		bool m_enabled;
+		int m_sampleInterval;
+		std::size_t m_frames, m_samples;
+		std::chrono::steady_clock::time_point m_start;
+
+		std::unordered_map<method_key, method_stats, key_hash> m_methods;
+		std::unordered_map<std::string, std::size_t> m_stacks;
+
+		void sample(lua_State* L);
+		void updateHook(lua_State* L) const;
+
+		static void hook(lua_State* L, lua_Debug* ar);
+	};
+}
+
+#endif // SCRIPTING_SCRIPT_PROFILER_HPP
@@ -10,6 +10,7 @@
 #include "util/bounds.hpp"
 #include "boost/polymorphic_pointer_cast.hpp"
 #include "json_to_lua.hpp"
+#include "math_types.hpp"
 
 class Object;
 
@@ -441,77 +442,56 @@ namespace scripting
 		lua_call(L, int(size), 1);
 	}
 
-	template<typename T, glm::precision p>
-	struct type_handler<glm::tvec2<T, p>>
+	// glm values are pushed as native userdata (see math_types.hpp), but plain tables are accepted as well
+	template<typename Native, typename T>
+	struct math_type_handler
 	{
-		static glm::tvec2<T, p> get_value(lua_State* L, int idx)
+		static T get_value(lua_State* L, int idx)
 		{
-			glm::tvec2<T, p> result;
-			get_array(L, idx, &result[0], 2);
+			Native* ptr = to_math<Native>(L, idx);
+			if (ptr) {
+				return T(*ptr);
+			}
+
+			T result;
+			get_array(L, idx, glm::value_ptr(result), math_type<Native>::size);
 			return result;
 		}
 
-		static void push_value(lua_State* L, const glm::tvec2<T, p>& value)
+		static void push_value(lua_State* L, const T& value)
 		{
-			push_struct(L, "xmath.vec2", &value[0], 2);
+			push_math(L, Native(value));
 		}
 
-		static glm::tvec2<T, p> check_arg(lua_State* L, int arg)
+		static T check_arg(lua_State* L, int arg)
 		{
+			Native* ptr = to_math<Native>(L, arg);
+			if (ptr) {
+				return T(*ptr);
+			}
+
 			luaL_checktype(L, arg, LUA_TTABLE);
-			auto l = table_length(L, arg);
-			luaL_argcheck(L, l >= 2, arg, "expected vector with 2 elements");
+			if (table_length(L, arg) < std::size_t(math_type<Native>::size)) {
+				luaL_argerror(L, arg, lua_pushfstring(L, "expected table with %d elements", math_type<Native>::size));
+			}
 			return get_value(L, arg);
 		}
 	};
 
 	template<typename T, glm::precision p>
-	struct type_handler<glm::tvec3<T, p>>
-	{
-		static glm::tvec3<T, p> get_value(lua_State* L, int idx)
-		{
-			glm::tvec3<T, p> result;
-			get_array(L, idx, &result[0], 3);
-			return result;
-		}
+	struct type_handler<glm::tvec2<T, p>> : public math_type_handler<glm::vec2, glm::tvec2<T, p>> { };
 
-		static void push_value(lua_State* L, const glm::tvec3<T, p>& value)
-		{
-			push_struct(L, "xmath.vec3", &value[0], 3);
-		}
-
-		static glm::tvec3<T, p> check_arg(lua_State* L, int arg)
-		{
-			luaL_checktype(L, arg, LUA_TTABLE);
-			auto l = table_length(L, arg);
-			luaL_argcheck(L, l >= 3, arg, "expected vector with 3 elements");
-			return get_value(L, arg);
-		}
-	};
+	template<typename T, glm::precision p>
+	struct type_handler<glm::tvec3<T, p>> : public math_type_handler<glm::vec3, glm::tvec3<T, p>> { };
 
 	template<typename T, glm::precision p>
-	struct type_handler<glm::tvec4<T, p>>
-	{
-		static glm::tvec4<T, p> get_value(lua_State* L, int idx)
-		{
-			glm::tvec4<T, p> result;
-			get_array(L, idx, &result[0], 4);
-			return result;
-		}
+	struct type_handler<glm::tvec4<T, p>> : public math_type_handler<glm::vec4, glm::tvec4<T, p>> { };
 
-		static void push_value(lua_State* L, const glm::tvec4<T, p>& value)
-		{
-			push_struct(L, "xmath.vec4", &value[0], 4);
-		}
+	template<typename T, glm::precision p>
+	struct type_handler<glm::tquat<T, p>> : public math_type_handler<glm::quat, glm::tquat<T, p>> { };
 
-		static glm::tvec4<T, p> check_arg(lua_State* L, int arg)
-		{
-			luaL_checktype(L, arg, LUA_TTABLE);
-			auto l = table_length(L, arg);
-			luaL_argcheck(L, l >= 4, arg, "expected vector with 4 elements");
-			return get_value(L, arg);
-		}
-	};
+	template<typename T, glm::precision p>
+	struct type_handler<glm::tmat4x4<T, p>> : public math_type_handler<glm::mat4, glm::tmat4x4<T, p>> { };
 
 	template<>
 	struct type_handler<aabb>
@@ -546,30 +526,6 @@ namespace scripting
 	};
 
 
-	template<typename T, glm::precision p>
-	struct type_handler<glm::tquat<T, p>>
-	{
-		static glm::tquat<T, p> get_value(lua_State* L, int idx)
-		{
-			glm::tquat<T, p> result;
-			get_array(L, idx, &result[0], 4);
-			return result;
-		}
-
-		static void push_value(lua_State* L, const glm::tquat<T, p>& value)
-		{
-			push_struct(L, "xmath.quat", &value[0], 4);
-		}
-
-		static glm::tquat<T, p> check_arg(lua_State* L, int arg)
-		{
-			luaL_checktype(L, arg, LUA_TTABLE);
-			auto l = table_length(L, arg);
-			luaL_argcheck(L, l >= 4, arg, "expected quaternion with 4 elements");
-			return get_value(L, arg);
-		}
-	};
-
 	template<>
 	struct type_handler<nlohmann::json>
 	{
@@ -11,6 +11,13 @@ struct sphere
 	float radius;
 };
 
+// the tip is at apex, the base is a disc at apex + dir * height
+struct cone
+{
+	glm::vec3 apex, dir;
+	float height, radius;
+};
+
 struct obb
 {
 	glm::vec3 center, extents;
@@ -70,6 +77,38 @@ inline aabb aabb_union(const aabb& a, const aabb& b)
 	return { glm::min(a.min, b.min), glm::max(a.max, b.max) };
 }
 
+// bounding cone of a spot light, spotAngle is the half opening angle in degrees
+// returns false if the range sphere is the tighter bound (the cone is only tighter below ~63 degrees)
+inline bool spot_cone_bounds(const glm::vec3& pos, const glm::vec3& dir, float range, float spotAngle, cone& c)
+{
+	float t = glm::tan(glm::radians(spotAngle));
+	if (!(t >= 0.0f && (t * t) < 4.0f))
+		return false;
+
+	c.apex = pos;
+	c.dir = dir;
+	c.height = range;
+	c.radius = range * t;
+	return true;
+}
+
+// screen space rectangle in normalized device coordinates, with a window space depth range
+struct screen_rect
+{
+	glm::vec2 min, max;
+	float minDepth, maxDepth;
+
+	glm::vec2 center() const
+	{
+		return (min + max) * 0.5f;
+	}
+
+	glm::vec2 extents() const
+	{
+		return (max - min) * 0.5f;
+	}
+};
+
 struct plane
 {
 	glm::vec3 n;
@@ -60,3 +60,26 @@ bool intersect_sphere_frustum(const sphere& sphere, const frustum& frustum)
 	return true;
 }
 
+bool intersect_cone_frustum(const cone& cone, const frustum& frustum)
+{
+	glm::vec3 base = cone.apex + cone.dir * cone.height;
+
+	for (unsigned int i = 0; i < 6; ++i) {
+		const plane& p = frustum.planes[i];
+
+		// da, db: signed distance between apex / base center and plane
+		float da = glm::dot(cone.apex, p.n) + p.d;
+		float db = glm::dot(base, p.n) + p.d;
+
+		// a: extent of the base disc along plane normal
+		float nd = glm::dot(p.n, cone.dir);
+		float a = cone.radius * glm::sqrt(glm::max(1.0f - nd * nd, 0.0f));
+
+		// if apex and base are completely on the "negative" side of any plane then the cone is not inside the frustum
+		if ((da < 0) && (a + db < 0))
+			return false;
+	}
+
+	// if all plane tests pass then cone is inside or intersecting the frustum (conservative)
+	return true;
+}
@@ -7,5 +7,6 @@ bool intersect_aabb_sphere(const aabb& aabb, const sphere& sphere);
 
 bool intersect_obb_frustum(const obb& obb, const frustum& frustum);
 bool intersect_sphere_frustum(const sphere& sphere, const frustum& frustum);
+bool intersect_cone_frustum(const cone& cone, const frustum& frustum);
 
 #endif // INTERSECTION_TESTS_HPP
\ No newline at end of file
@@ -0,0 +1,41 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <vector>
+
+// calls func(begin, end) for consecutive ranges covering [0, count)
+// ranges are processed on worker threads if there are at least minBatch elements per thread
+// func must be safe to call concurrently for disjoint ranges
+template<typename Func>
+void parallel_for(std::size_t count, std::size_t minBatch, const Func& func)
+{
+	std::size_t threads = std::max(std::thread::hardware_concurrency(), 1u);
+	std::size_t batches = std::min(threads, count / std::max(minBatch, std::size_t(1)));
+
+	if (batches <= 1) {
+		func(std::size_t(0), count);
+		return;
+	}
+
+	std::size_t batchSize = (count + batches - 1) / batches;
+
+	std::vector<std::future<void>> tasks;
+	tasks.reserve(batches - 1);
+
+	// the calling thread takes the first range
+	for (std::size_t begin = batchSize; begin < count; begin += batchSize) {
+		std::size_t end = std::min(begin + batchSize, count);
+		tasks.push_back(std::async(std::launch::async, [&func, begin, end]() { func(begin, end); }));
+	}
+
+	func(std::size_t(0), batchSize);
+
+	for (auto& task : tasks) {
+		task.get();
+	}
+}
+
+#endif // PARALLEL_HPP
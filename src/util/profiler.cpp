@@ -0,0 +1,376 @@
+#include "profiler.hpp"
+
+#include "boost/filesystem/fstream.hpp"
+#include "boost/format.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace profiler
+{
+	namespace
+	{
+		using clock = std::chrono::high_resolution_clock;
+
+		const std::size_t buffer_size = 1 << 16;	// events per thread
+		const std::size_t window_size = 120;		// frames in the rolling statistics
+
+		struct open_scope
+		{
+			const char* name;
+			std::int64_t begin;
+			bool recording, script;
+		};
+
+		// written only by the owning thread, the head (write index) is published with release semantics.
+		// other threads read it with read_events, which drops the slots the owner may have overwritten meanwhile
+		struct thread_buffer
+		{
+			std::vector<event> events;
+			std::atomic<std::uint64_t> head;
+			std::uint64_t read;	// consumed by end_frame (main thread)
+			std::uint32_t id;
+			std::string name;
+			std::vector<open_scope> stack;
+
+			explicit thread_buffer(std::uint32_t id) : events(buffer_size), head(0), read(0), id(id) { }
+
+			void push(const event& e)
+			{
+				std::uint64_t h = head.load(std::memory_order_relaxed);
+				// a reader that sees this write sees the head published before it (pairs with the fence in read_events)
+				std::atomic_thread_fence(std::memory_order_release);
+				events[h % buffer_size] = e;
+				head.store(h + 1, std::memory_order_release);
+			}
+
+			// oldest event that has not been overwritten yet
+			std::uint64_t first(std::uint64_t h) const
+			{
+				return h > buffer_size ? h - buffer_size : 0;
+			}
+
+			// appends the completed events from index from on to out, returns the index after the last one
+			std::uint64_t read_events(std::uint64_t from, std::vector<event>& out) const
+			{
+				std::uint64_t h = head.load(std::memory_order_acquire);
+				from = std::max(from, first(h));
+
+				std::size_t base = out.size();
+				for (std::uint64_t i = from; i < h; i++) {
+					out.push_back(events[i % buffer_size]);
+				}
+
+				// the owner may be writing event h2 now, which reuses the slot of h2 - buffer_size.
+				// copies of that slot or older ones may be torn
+				std::atomic_thread_fence(std::memory_order_acquire);
+				std::uint64_t valid = first(head.load(std::memory_order_relaxed) + 1);
+				if (valid > from) {
+					out.erase(out.begin() + base, out.begin() + base + std::size_t(std::min(valid, h) - from));
+				}
+
+				return h;
+			}
+		};
+
+		struct rolling_stats
+		{
+			std::array<double, window_size> samples;
+			std::size_t count, pos, lastCalls;
+
+			rolling_stats() : count(0), pos(0), lastCalls(0) { }
+
+			void add(double value, std::size_t calls)
+			{
+				samples[pos] = value;
+				pos = (pos + 1) % window_size;
+				count = std::min(count + 1, window_size);
+				lastCalls = calls;
+			}
+
+			double last() const
+			{
+				return samples[(pos + window_size - 1) % window_size];
+			}
+		};
+
+		struct frame_entry
+		{
+			double time;
+			std::size_t calls;
+		};
+
+		struct profiler_state
+		{
+			std::atomic<bool> enabled;
+			clock::time_point epoch;
+
+			std::mutex threadMutex;
+			std::vector<std::unique_ptr<thread_buffer>> threads;
+
+			std::mutex nameMutex;
+			std::unordered_set<std::string> names;
+
+			// only accessed from the main thread
+			std::unordered_map<std::string, rolling_stats> scopes;
+			std::unordered_map<std::string, frame_entry> frame;
+			std::vector<scope_time> lastFrame;
+			std::vector<event> readBuffer;
+
+			profiler_state() : enabled(false), epoch(clock::now()) { }
+		};
+
+		profiler_state& state()
+		{
+			static profiler_state s;
+			return s;
+		}
+
+		thread_local thread_buffer* t_buffer = nullptr;
+
+		thread_buffer& current_buffer()
+		{
+			if (!t_buffer) {
+				auto& s = state();
+				std::lock_guard<std::mutex> lock(s.threadMutex);
+
+				s.threads.push_back(std::make_unique<thread_buffer>(std::uint32_t(s.threads.size())));
+				t_buffer = s.threads.back().get();
+			}
+
+			return *t_buffer;
+		}
+
+		std::int64_t now()
+		{
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - state().epoch).count();
+		}
+
+		std::string json_escape(const char* str)
+		{
+			std::string result;
+			for (const char* c = str; *c; c++) {
+				switch (*c) {
+				case '"': result += "\\\""; break;
+				case '\\': result += "\\\\"; break;
+				default:
+					if (static_cast<unsigned char>(*c) >= 0x20)
+						result += *c;
+				}
+			}
+			return result;
+		}
+
+		void push_scope(const char* name, bool script)
+		{
+			thread_buffer& buf = current_buffer();
+
+			// scopes are always pushed, so that toggling the profiler can't unbalance the stack
+			bool recording = enabled();
+			buf.stack.push_back({ name, recording ? now() : 0, recording, script });
+		}
+
+		void pop_scope(thread_buffer& buf)
+		{
+			open_scope s = buf.stack.back();
+			buf.stack.pop_back();
+
+			if (s.recording) {
+				buf.push({ s.name, s.begin, now(), std::uint32_t(buf.stack.size()) });
+			}
+		}
+
+		void end_script_scopes(thread_buffer& buf)
+		{
+			while (!buf.stack.empty() && buf.stack.back().script) {
+				pop_scope(buf);
+			}
+		}
+	}
+
+	bool enabled()
+	{
+		return state().enabled.load(std::memory_order_relaxed);
+	}
+
+	void set_enabled(bool val)
+	{
+		state().enabled.store(val, std::memory_order_relaxed);
+	}
+
+	void begin_scope(const char* name)
+	{
+		push_scope(name, false);
+	}
+
+	void end_scope()
+	{
+		thread_buffer& buf = current_buffer();
+
+		// script scopes left open inside this one would take its place otherwise
+		end_script_scopes(buf);
+		if (!buf.stack.empty())
+			pop_scope(buf);
+	}
+
+	void begin_script_scope(const char* name)
+	{
+		push_scope(name, true);
+	}
+
+	void end_script_scope()
+	{
+		thread_buffer& buf = current_buffer();
+		if (!buf.stack.empty() && buf.stack.back().script)
+			pop_scope(buf);
+	}
+
+	const char* intern(const std::string& name)
+	{
+		auto& s = state();
+		std::lock_guard<std::mutex> lock(s.nameMutex);
+		return s.names.insert(name).first->c_str();
+	}
+
+	void set_thread_name(const std::string& name)
+	{
+		current_buffer().name = name;
+	}
+
+	void end_frame()
+	{
+		auto& s = state();
+
+		end_script_scopes(current_buffer());
+
+		{
+			std::lock_guard<std::mutex> lock(s.threadMutex);
+
+			for (auto& buf : s.threads) {
+				s.readBuffer.clear();
+				buf->read = buf->read_events(buf->read, s.readBuffer);
+
+				for (const event& e : s.readBuffer) {
+					frame_entry& fe = s.frame[e.name];
+					fe.time += (e.end - e.begin) * 1e-6;
+					fe.calls++;
+				}
+			}
+		}
+
+		s.lastFrame.clear();
+
+		for (auto& fe : s.frame) {
+			s.scopes[fe.first].add(fe.second.time, fe.second.calls);
+			s.lastFrame.push_back({ fe.first, fe.second.time, fe.second.calls });
+		}
+		s.frame.clear();
+	}
+
+	const std::vector<scope_time>& last_frame()
+	{
+		return state().lastFrame;
+	}
+
+	namespace
+	{
+		scope_stats make_stats(const std::string& name, const rolling_stats& rs)
+		{
+			scope_stats result{ name, 0.0, 0.0, 0.0, rs.last(), rs.lastCalls };
+
+			auto begin = rs.samples.begin(), end = begin + rs.count;
+			result.min = *std::min_element(begin, end);
+			result.max = *std::max_element(begin, end);
+
+			for (auto it = begin; it != end; ++it) {
+				result.avg += *it;
+			}
+			result.avg /= rs.count;
+
+			return result;
+		}
+	}
+
+	std::vector<scope_stats> stats()
+	{
+		std::vector<scope_stats> result;
+		for (auto& sc : state().scopes) {
+			result.push_back(make_stats(sc.first, sc.second));
+		}
+
+		std::sort(result.begin(), result.end(), [](const scope_stats& a, const scope_stats& b) {
+			return a.avg > b.avg;
+		});
+
+		return result;
+	}
+
+	bool find_stats(const std::string& name, scope_stats& result)
+	{
+		auto& scopes = state().scopes;
+		auto it = scopes.find(name);
+		if (it == scopes.end())
+			return false;
+
+		result = make_stats(it->first, it->second);
+		return true;
+	}
+
+	void write_stats(std::ostream& stream)
+	{
+		stream << boost::format("%-40s %10s %10s %10s %10s %8s\n") % "scope" % "min ms" % "avg ms" % "max ms" % "last ms" % "calls";
+
+		for (auto& st : stats()) {
+			stream << boost::format("%-40s %10.3f %10.3f %10.3f %10.3f %8d\n") % st.name % st.min % st.avg % st.max % st.last % st.calls;
+		}
+	}
+
+	bool write_chrome_trace(const path& p)
+	{
+		boost::filesystem::ofstream file(p);
+		if (!file) {
+			std::cout << "ERROR: could not write profiler trace to " << p << std::endl;
+			return false;
+		}
+
+		auto& s = state();
+		std::lock_guard<std::mutex> lock(s.threadMutex);
+
+		file << "{\"traceEvents\":[\n";
+		bool first = true;
+
+		auto separate = [&]() {
+			if (!first) file << ",\n";
+			first = false;
+		};
+
+		for (auto& buf : s.threads) {
+			if (!buf->name.empty()) {
+				separate();
+				file << boost::format("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%1%,\"args\":{\"name\":\"%2%\"}}")
+					% buf->id % json_escape(buf->name.c_str());
+			}
+
+			std::vector<event> events;
+			buf->read_events(0, events);
+
+			for (const event& e : events) {
+				separate();
+				file << boost::format("{\"name\":\"%1%\",\"cat\":\"cpu\",\"ph\":\"X\",\"ts\":%2$.3f,\"dur\":%3$.3f,\"pid\":0,\"tid\":%4%}")
+					% json_escape(e.name) % (e.begin * 1e-3) % ((e.end - e.begin) * 1e-3) % buf->id;
+			}
+		}
+
+		file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+		std::cout << "profiler trace written to " << p << std::endl;
+		return true;
+	}
+}
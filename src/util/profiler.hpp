@@ -0,0 +1,100 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <ostream>
+
+#include "path.hpp"
+
+// Hierarchical CPU profiler.
+// Every thread records the scopes it leaves into its own ring buffer, the recording path takes no locks.
+// The buffers can be exported as a Chrome trace (chrome://tracing, ui.perfetto.dev), and the main thread
+// aggregates them into rolling per-scope statistics once per frame (see end_frame).
+// The PROFILE_* markers compile to nothing unless PROFILER_ENABLED is defined.
+namespace profiler
+{
+	struct event
+	{
+		const char* name;
+		std::int64_t begin, end; // nanoseconds since startup
+		std::uint32_t depth;
+	};
+
+	// time spent in a scope per frame (in milliseconds) over the last frames
+	struct scope_stats
+	{
+		std::string name;
+		double min, avg, max, last;
+		std::size_t calls; // during the last frame
+	};
+
+	struct scope_time
+	{
+		std::string name;
+		double time; // in milliseconds
+		std::size_t calls;
+	};
+
+	bool enabled();
+	void set_enabled(bool val);
+
+	// name has to stay valid until the profile is written (string literals, or strings returned by intern)
+	void begin_scope(const char* name);
+	void end_scope();
+
+	// scopes opened by scripts, an error can leave them open. they end with the native scope around them,
+	// or at the end of the frame (see end_frame). end_script_scope only ends a scope opened by begin_script_scope
+	void begin_script_scope(const char* name);
+	void end_script_scope();
+
+	// returns a permanent copy of the string
+	const char* intern(const std::string& name);
+
+	void set_thread_name(const std::string& name);
+
+	// collects the events recorded since the last call and updates the per-scope statistics,
+	// script scopes still open on the calling thread are ended first.
+	// this and the statistics functions below must only be called from the main thread.
+	void end_frame();
+
+	// scopes recorded during the frame collected by the last call to end_frame
+	const std::vector<scope_time>& last_frame();
+
+	std::vector<scope_stats> stats();
+	bool find_stats(const std::string& name, scope_stats& result);
+
+	void write_stats(std::ostream& stream);
+	bool write_chrome_trace(const path& p);
+
+	class scope
+	{
+	public:
+		explicit scope(const char* name) { begin_scope(name); }
+		~scope() { end_scope(); }
+
+		scope(const scope&) = delete;
+		scope& operator=(const scope&) = delete;
+	};
+}
+
+#define PROFILER_CONCAT_IMPL(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_IMPL(a, b)
+
+#ifdef PROFILER_ENABLED
+#define PROFILE_SCOPE(name) ::profiler::scope PROFILER_CONCAT(profile_scope_, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name)
+#endif
+
+// qualified, __FUNCTION__ is only the bare name with some compilers
+#ifdef _MSC_VER
+#define PROFILER_FUNCTION_NAME __FUNCSIG__
+#else
+#define PROFILER_FUNCTION_NAME __PRETTY_FUNCTION__
+#endif
+
+#define PROFILE_FUNCTION() PROFILE_SCOPE(PROFILER_FUNCTION_NAME)
+
+#endif // PROFILER_HPP
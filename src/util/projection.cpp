@@ -0,0 +1,74 @@
+#include "projection.hpp"
+
+namespace
+{
+	// bounds of the sphere along one screen axis, from the two lines through the eye tangent to the sphere
+	// c: sphere center in the plane spanned by the axis and the view direction
+	void project_axis(const glm::vec2& c, float r, float nearPlane, float p00, float p20, float& min, float& max)
+	{
+		float sqrDist = glm::dot(c, c);
+		float sqrT = sqrDist - r * r;
+
+		// the near plane cuts the sphere (or the eye is inside), the whole axis is covered
+		if ((c.y + r) >= -nearPlane || sqrT <= 0.0f) {
+			min = -1.0f;
+			max = 1.0f;
+			return;
+		}
+
+		float cosA = glm::sqrt(sqrT / sqrDist);
+		float sinA = r / glm::sqrt(sqrDist);
+
+		// tangent points (rotate the center by +/- the half opening angle, scale to the tangent length)
+		glm::vec2 t0 = glm::vec2(cosA * c.x - sinA * c.y, sinA * c.x + cosA * c.y) * cosA;
+		glm::vec2 t1 = glm::vec2(cosA * c.x + sinA * c.y, -sinA * c.x + cosA * c.y) * cosA;
+
+		float x0 = (p00 * t0.x + p20 * t0.y) / -t0.y;
+		float x1 = (p00 * t1.x + p20 * t1.y) / -t1.y;
+
+		min = glm::clamp(glm::min(x0, x1), -1.0f, 1.0f);
+		max = glm::clamp(glm::max(x0, x1), -1.0f, 1.0f);
+	}
+
+	float window_depth(const glm::mat4& proj, float z)
+	{
+		float ndc = (proj[2][2] * z + proj[3][2]) / -z;
+		return glm::clamp(ndc * 0.5f + 0.5f, 0.0f, 1.0f);
+	}
+}
+
+bool project_sphere_bounds(const sphere& viewSphere, const glm::mat4& proj, float nearPlane, float farPlane, screen_rect& bounds)
+{
+	const glm::vec3& c = viewSphere.center;
+	float r = viewSphere.radius;
+
+	// view space depth range, clipped to the near and far planes (the camera looks down -z)
+	float zNear = glm::min(c.z + r, -nearPlane);
+	float zFar = glm::max(c.z - r, -farPlane);
+	if (zNear <= zFar)
+		return false;
+
+	project_axis({ c.x, c.z }, r, nearPlane, proj[0][0], proj[2][0], bounds.min.x, bounds.max.x);
+	project_axis({ c.y, c.z }, r, nearPlane, proj[1][1], proj[2][1], bounds.min.y, bounds.max.y);
+
+	if (bounds.min.x >= bounds.max.x || bounds.min.y >= bounds.max.y)
+		return false;
+
+	bounds.minDepth = window_depth(proj, zNear);
+	bounds.maxDepth = window_depth(proj, zFar);
+	return true;
+}
+
+frustum extract_frustum(const glm::mat4& viewProj)
+{
+	frustum f;
+	for (unsigned int p = 0; p < 3; ++p) {
+		for (unsigned int i = 0; i < 4; ++i) {
+			f.planes[p*2+0][i] = viewProj[i][3] + viewProj[i][p];
+			f.planes[p*2+1][i] = viewProj[i][3] - viewProj[i][p];
+		}
+	}
+
+	f.normalize();
+	return f;
+}
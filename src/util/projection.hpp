@@ -0,0 +1,13 @@
+#ifndef PROJECTION_HPP
+#define PROJECTION_HPP
+
+#include "bounds.hpp"
+
+// screen space bounds of a view space sphere under a perspective projection
+// returns false if the sphere is not in front of the camera or does not cover any part of the screen
+bool project_sphere_bounds(const sphere& viewSphere, const glm::mat4& proj, float nearPlane, float farPlane, screen_rect& bounds);
+
+// planes of the clip space volume of a view projection matrix, pointing inwards
+frustum extract_frustum(const glm::mat4& viewProj);
+
+#endif // PROJECTION_HPP
\ No newline at end of file
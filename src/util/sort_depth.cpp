@@ -0,0 +1,19 @@
+#include "sort_depth.hpp"
+
+#include "glm.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+unsigned int sort_depth(float viewDepth, float nearPlane, float farPlane, unsigned int buckets, bool transparent)
+{
+	// logarithmic, close objects get a bigger share of the range
+	float t = std::log(glm::max(viewDepth, nearPlane) / nearPlane) / std::log(farPlane / nearPlane);
+	t = glm::clamp(t, 0.0f, 1.0f);
+
+	if (transparent)
+		return sort_depth_max - static_cast<unsigned int>(t * float(sort_depth_max));
+
+	buckets = std::max(buckets, 1u);
+	return std::min(static_cast<unsigned int>(t * float(buckets)), buckets - 1);
+}
@@ -0,0 +1,12 @@
+#ifndef SORT_DEPTH_HPP
+#define SORT_DEPTH_HPP
+
+// 24 bits, floats cannot resolve more anyway
+const unsigned int sort_depth_max = (1u << 24) - 1;
+
+// depth part of the render queue keys (sorted ascending after the priority), from a view space depth (positive in front of the camera).
+// transparent: strictly back to front over [0, sort_depth_max], blending depends on it
+// opaque: coarse front to back buckets [0, buckets) for early depth rejection, objects in the same bucket are still sorted by state
+unsigned int sort_depth(float viewDepth, float nearPlane, float farPlane, unsigned int buckets, bool transparent);
+
+#endif // SORT_DEPTH_HPP
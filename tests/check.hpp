@@ -0,0 +1,27 @@
+#ifndef CHECK_HPP
+#define CHECK_HPP
+
+#include <iostream>
+
+// minimal checks for the CPU side math, the executables return the number of failed checks
+
+namespace check
+{
+	inline int& failures()
+	{
+		static int count = 0;
+		return count;
+	}
+
+	inline void report(bool passed, const char* expr, const char* file, int line)
+	{
+		if (!passed) {
+			std::cout << "FAILED: " << expr << " (" << file << ":" << line << ")" << std::endl;
+			++failures();
+		}
+	}
+}
+
+#define CHECK(expr) check::report((expr), #expr, __FILE__, __LINE__)
+
+#endif // CHECK_HPP
@@ -0,0 +1,148 @@
+#include "check.hpp"
+
+#include "util/intersection_tests.hpp"
+#include "util/projection.hpp"
+
+namespace
+{
+	// camera at the origin looking down -z, 90 degrees vertical field of view
+	// (the side planes are x = +/-z and y = +/-z)
+	frustum camera_frustum()
+	{
+		return extract_frustum(glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 100.0f));
+	}
+
+	cone make_cone(const glm::vec3& apex, const glm::vec3& dir, float height, float radius)
+	{
+		return { apex, glm::normalize(dir), height, radius };
+	}
+
+	void cone_frustum()
+	{
+		frustum f = camera_frustum();
+
+		// inside
+		CHECK(intersect_cone_frustum(make_cone({ 0.0f, 0.0f, -10.0f }, { 0.0f, 0.0f, -1.0f }, 5.0f, 1.0f), f));
+		CHECK(intersect_cone_frustum(make_cone({ 2.0f, 1.0f, -20.0f }, { 1.0f, 0.0f, 0.0f }, 5.0f, 2.0f), f));
+
+		// outside, behind the camera, beyond the far plane and beside the frustum pointing away from it
+		CHECK(!intersect_cone_frustum(make_cone({ 0.0f, 0.0f, 5.0f }, { 0.0f, 0.0f, 1.0f }, 10.0f, 2.0f), f));
+		CHECK(!intersect_cone_frustum(make_cone({ 0.0f, 0.0f, -110.0f }, { 0.0f, 0.0f, -1.0f }, 10.0f, 2.0f), f));
+		CHECK(!intersect_cone_frustum(make_cone({ 30.0f, 0.0f, -10.0f }, { 1.0f, 0.0f, 0.0f }, 10.0f, 2.0f), f));
+
+		// straddling a plane: apex outside, base inside
+		CHECK(intersect_cone_frustum(make_cone({ 30.0f, 0.0f, -10.0f }, { -1.0f, 0.0f, 0.0f }, 30.0f, 2.0f), f));
+		// apex inside, base outside
+		CHECK(intersect_cone_frustum(make_cone({ 0.0f, 0.0f, -10.0f }, { 1.0f, 0.0f, 0.0f }, 30.0f, 2.0f), f));
+		// through the near plane
+		CHECK(intersect_cone_frustum(make_cone({ 0.0f, 0.0f, 2.0f }, { 0.0f, 0.0f, -1.0f }, 5.0f, 1.0f), f));
+		// apex and base center outside, only the base disc reaches over the plane
+		CHECK(intersect_cone_frustum(make_cone({ 14.0f, 0.0f, -10.0f }, { 0.0f, 0.0f, -1.0f }, 2.0f, 4.0f), f));
+
+		// narrow: next to the right plane, where the range sphere would still intersect
+		cone narrow = make_cone({ 15.0f, 0.0f, -10.0f }, { 0.0f, 0.0f, -1.0f }, 4.0f, 0.05f);
+		CHECK(!intersect_cone_frustum(narrow, f));
+		CHECK(intersect_sphere_frustum({ narrow.apex, narrow.height }, f));
+		// narrow, pointing into the frustum
+		CHECK(intersect_cone_frustum(make_cone({ 15.0f, 0.0f, -10.0f }, { -1.0f, 0.0f, -1.0f }, 10.0f, 0.05f), f));
+
+		// wider than 90 degrees (base radius above the height): the disc is what reaches into the frustum
+		CHECK(intersect_cone_frustum(make_cone({ 30.0f, 0.0f, -10.0f }, { 0.0f, 0.0f, -1.0f }, 2.0f, 40.0f), f));
+		CHECK(!intersect_cone_frustum(make_cone({ 0.0f, 0.0f, 10.0f }, { 0.0f, 0.0f, 1.0f }, 2.0f, 40.0f), f));
+	}
+
+	void spot_cones()
+	{
+		glm::vec3 pos(1.0f, 2.0f, 3.0f), dir(0.0f, 0.0f, -1.0f);
+		cone c;
+
+		CHECK(spot_cone_bounds(pos, dir, 10.0f, 1.0f, c));
+		CHECK(c.apex == pos && c.dir == dir && c.height == 10.0f);
+		CHECK(c.radius > 0.0f && c.radius < 0.2f);
+
+		CHECK(spot_cone_bounds(pos, dir, 10.0f, 45.0f, c));
+		CHECK(glm::abs(c.radius - 10.0f) < 1e-4f);
+
+		CHECK(spot_cone_bounds(pos, dir, 10.0f, 60.0f, c));
+
+		// the range sphere is tighter from ~63 degrees on, and tan() turns negative past 90
+		CHECK(!spot_cone_bounds(pos, dir, 10.0f, 70.0f, c));
+		CHECK(!spot_cone_bounds(pos, dir, 10.0f, 90.0f, c));
+		CHECK(!spot_cone_bounds(pos, dir, 10.0f, 120.0f, c));
+	}
+
+	bool near_equal(float a, float b, float eps = 1e-4f)
+	{
+		return glm::abs(a - b) <= eps;
+	}
+
+	// screen rect of points sampled on the sphere surface (the sphere has to be in front of the near plane)
+	screen_rect sampled_bounds(const sphere& s, const glm::mat4& proj)
+	{
+		const int steps = 256;
+		screen_rect r{ glm::vec2(1e9f), glm::vec2(-1e9f), 0.0f, 0.0f };
+
+		for (int i = 0; i <= steps; ++i) {
+			float theta = glm::pi<float>() * i / steps;
+			for (int j = 0; j < 2 * steps; ++j) {
+				float phi = glm::pi<float>() * j / steps;
+				glm::vec3 n(glm::sin(theta) * glm::cos(phi), glm::sin(theta) * glm::sin(phi), glm::cos(theta));
+				glm::vec4 clip = proj * glm::vec4(s.center + n * s.radius, 1.0f);
+				glm::vec2 ndc(clip.x / clip.w, clip.y / clip.w);
+
+				r.min = glm::min(r.min, ndc);
+				r.max = glm::max(r.max, ndc);
+			}
+		}
+
+		return r;
+	}
+
+	void sphere_projection()
+	{
+		const float nearPlane = 0.1f, farPlane = 100.0f;
+		glm::mat4 proj = glm::perspective(glm::radians(60.0f), 1.5f, nearPlane, farPlane);
+		screen_rect r;
+
+		// centered: symmetric around the screen center
+		CHECK(project_sphere_bounds({ { 0.0f, 0.0f, -10.0f }, 1.0f }, proj, nearPlane, farPlane, r));
+		CHECK(near_equal(r.min.x, -r.max.x) && near_equal(r.min.y, -r.max.y));
+		CHECK(r.max.x > 0.0f && r.max.y > r.max.x);
+		CHECK(r.minDepth > 0.0f && r.minDepth < r.maxDepth && r.maxDepth < 1.0f);
+
+		// off axis: contains every projected surface point and is tight against them
+		sphere offAxis{ { 2.5f, -1.5f, -8.0f }, 1.5f };
+		CHECK(project_sphere_bounds(offAxis, proj, nearPlane, farPlane, r));
+		screen_rect sampled = sampled_bounds(offAxis, proj);
+		CHECK(r.min.x <= sampled.min.x + 1e-4f && r.max.x >= sampled.max.x - 1e-4f);
+		CHECK(r.min.y <= sampled.min.y + 1e-4f && r.max.y >= sampled.max.y - 1e-4f);
+		CHECK(near_equal(r.min.x, sampled.min.x, 2e-3f) && near_equal(r.max.x, sampled.max.x, 2e-3f));
+		CHECK(near_equal(r.min.y, sampled.min.y, 2e-3f) && near_equal(r.max.y, sampled.max.y, 2e-3f));
+
+		// behind the camera
+		CHECK(!project_sphere_bounds({ { 0.0f, 0.0f, 5.0f }, 1.0f }, proj, nearPlane, farPlane, r));
+		CHECK(!project_sphere_bounds({ { 3.0f, 0.0f, 0.5f }, 0.3f }, proj, nearPlane, farPlane, r));
+
+		// crossing the near plane: starts at the near plane and covers the whole screen
+		CHECK(project_sphere_bounds({ { 0.0f, 0.0f, -0.5f }, 1.0f }, proj, nearPlane, farPlane, r));
+		CHECK(r.minDepth == 0.0f && r.maxDepth > 0.0f);
+		CHECK(r.min.x == -1.0f && r.max.x == 1.0f && r.min.y == -1.0f && r.max.y == 1.0f);
+
+		// beyond the far plane, and reaching over it
+		CHECK(!project_sphere_bounds({ { 0.0f, 0.0f, -120.0f }, 5.0f }, proj, nearPlane, farPlane, r));
+		CHECK(project_sphere_bounds({ { 0.0f, 0.0f, -98.0f }, 5.0f }, proj, nearPlane, farPlane, r));
+		CHECK(r.maxDepth == 1.0f);
+
+		// beside the frustum
+		CHECK(!project_sphere_bounds({ { 40.0f, 0.0f, -10.0f }, 1.0f }, proj, nearPlane, farPlane, r));
+	}
+}
+
+int main()
+{
+	cone_frustum();
+	spot_cones();
+	sphere_projection();
+
+	return check::failures();
+}
@@ -0,0 +1,153 @@
+#include "check.hpp"
+
+#include "content/Content.hpp"
+#include "core/app_info.hpp"
+#include "core/Engine.hpp"
+#include "core/ObjectRegistry.hpp"
+#include "core/Scene.hpp"
+#include "graphics/RenderEngine.hpp"
+#include "graphics/gl_dispatch.hpp"
+#include "graphics/gl_state.hpp"
+
+// renders a small scene on the null backend and checks the GL calls that reach the driver
+// (runs in the output directory of DeferredRenderer, where the processed content is)
+
+namespace
+{
+	// three cubes in front of the camera, a directional light (fullscreen quad) and a point light (light volume)
+	const char* const g_scene = R"({
+		"name": "null_backend",
+		"backColor": "#000000",
+		"ambientLight": "#202020",
+		"entities": [
+			{
+				"name": "floor",
+				"components": [
+					{ "type": "Transform", "position": [ 0, -1, -10 ], "scale": [ 20, 1, 20 ] },
+					{ "type": "MeshRenderer", "mesh": "cube", "materials": [ "brick" ] }
+				]
+			},
+			{
+				"name": "obj0",
+				"components": [
+					{ "type": "Transform", "position": [ -2, 1, -6 ] },
+					{ "type": "MeshRenderer", "mesh": "cube", "materials": [ "steel" ] }
+				]
+			},
+			{
+				"name": "obj1",
+				"components": [
+					{ "type": "Transform", "position": [ 2, 1, -6 ] },
+					{ "type": "MeshRenderer", "mesh": "cube", "materials": [ "steel" ] }
+				]
+			},
+			{
+				"name": "camera",
+				"components": [
+					{ "type": "Transform", "position": [ 0, 3, 0 ] },
+					{ "type": "Camera", "fov": 60, "nearPlane": 0.1, "farPlane": 100 }
+				]
+			},
+			{
+				"name": "sun",
+				"components": [
+					{ "type": "Transform", "rotation": [ 75, 20, 0 ] },
+					{ "type": "Light", "lightType": "directional", "color": "#fffdf4", "intensity": 0.8 }
+				]
+			},
+			{
+				"name": "lamp",
+				"components": [
+					{ "type": "Transform", "position": [ 0, 1, -5 ] },
+					{ "type": "Light", "lightType": "point", "color": "#89beff", "range": 8, "intensity": 1.1 }
+				]
+			}
+		]
+	})";
+
+	struct frame_calls
+	{
+		std::size_t drawElements;
+		std::size_t draws;
+		std::size_t matrices;
+		gl_state::call_stats state;
+	};
+
+	frame_calls render_frame(RenderEngine* renderer)
+	{
+		gl_dispatch::reset_call_counts();
+		renderer->render();
+		gl_state::end_frame();
+
+		std::size_t drawElements = gl_dispatch::call_count("glDrawElements");
+		std::size_t draws = drawElements + gl_dispatch::call_count("glDrawElementsInstanced") + gl_dispatch::call_count("glDrawArrays");
+		return { drawElements, draws, gl_dispatch::call_count("glUniformMatrix4fv"), gl_state::last_frame() };
+	}
+}
+
+int main()
+{
+	app_info::load("app-info.json");
+	app_info::set("glBackend", "null");
+	app_info::set("headless", true);
+	app_info::set("glStateCache", true);
+	app_info::set("bindlessTextures", false);
+	app_info::set("textureStreaming", false);
+	app_info::set("tiledLighting", false);
+	app_info::set("occlusionCulling", false);
+	app_info::set("shadows", false);
+	app_info::set("dynamicResolution", false);
+	app_info::set("cpuProfiling", false);
+
+	// every program linked on the null backend reports these uniforms
+	gl_dispatch::set_backend(gl_dispatch::backend::null);
+	gl_dispatch::set_integer(GL_MAX_COLOR_ATTACHMENTS, 8);
+	gl_dispatch::set_integer(GL_MAX_DRAW_BUFFERS, 8);
+	gl_dispatch::set_active_uniforms({
+		{ "cm_mat_wvp", GL_FLOAT_MAT4 },
+		{ "cm_mat_world", GL_FLOAT_MAT4 },
+		{ "cm_light_color", GL_FLOAT_VEC4 }
+	});
+	gl_dispatch::set_uniform_location("cm_mat_wvp", 0);
+	gl_dispatch::set_uniform_location("cm_mat_world", 1);
+	gl_dispatch::set_uniform_location("cm_light_color", 2);
+
+	Engine engine;
+
+	RenderEngine* renderer = RenderEngine::instance();
+	CHECK(renderer != nullptr);
+	if (!renderer) return check::failures();
+
+	CHECK(gl_dispatch::current_backend() == gl_dispatch::backend::null);
+
+	auto scene = ObjectRegistry::instance()->addUnique(Content::instance()->getFromJson<Scene>(nlohmann::json::parse(g_scene)));
+	CHECK(scene != nullptr);
+	if (!scene) return check::failures();
+
+	// every counted draw is one draw call, the cubes are drawn into the G-buffer
+	frame_calls first = render_frame(renderer);
+	CHECK(first.drawElements >= 3);
+	CHECK(first.draws == renderer->drawCount());
+	CHECK(first.matrices >= 3);
+	CHECK(first.state.totalIssued() > 0);
+
+	// the same frame again, the cache skips the bindings that are still in place
+	frame_calls second = render_frame(renderer);
+	CHECK(second.drawElements == first.drawElements);
+	CHECK(second.draws == renderer->drawCount());
+	CHECK(second.state.totalIssued() > 0);
+	CHECK(second.state.totalSkipped() > 0);
+
+	// without the cache every call is issued, the draws stay the same
+	gl_state::set_enabled(false);
+	frame_calls third = render_frame(renderer);
+	CHECK(third.drawElements == second.drawElements);
+	CHECK(third.draws == second.draws);
+	CHECK(third.state.totalSkipped() == 0);
+	CHECK(third.state.totalIssued() == second.state.totalIssued() + second.state.totalSkipped());
+	gl_state::set_enabled(true);
+
+	scene.reset();
+
+	return check::failures();
+}
@@ -0,0 +1,84 @@
+#include "check.hpp"
+
+#include "graphics/OcclusionCuller.hpp"
+
+#include <vector>
+
+namespace
+{
+	obb make_box(const glm::vec3& center, float extent)
+	{
+		return { center, glm::vec3(extent), glm::mat3(1.0f) };
+	}
+
+	void wall()
+	{
+		// camera at the origin looking down -z
+		glm::mat4 viewProj = glm::perspective(glm::radians(60.0f), 2.0f, 0.1f, 100.0f);
+
+		// 8x8 quad at z = -10, moved there by the model matrix
+		std::vector<glm::vec3> positions = {
+			{ -4.0f, -4.0f, 0.0f }, { 4.0f, -4.0f, 0.0f }, { 4.0f, 4.0f, 0.0f }, { -4.0f, 4.0f, 0.0f }
+		};
+		std::vector<std::uint32_t> indices = { 0, 1, 2, 0, 2, 3 };
+
+		glm::mat4 model(1.0f);
+		model[3] = glm::vec4(0.0f, 0.0f, -10.0f, 1.0f);
+
+		OcclusionCuller culler(250, 125);
+		CHECK(culler.width() == 256 && culler.height() == 128);
+
+		// nothing rendered yet
+		CHECK(culler.isVisible(make_box({ 0.0f, 0.0f, -20.0f }, 1.0f)));
+
+		culler.render({ { model, &positions, &indices } }, viewProj);
+		CHECK(culler.triangleCount() == 2);
+
+		// the wall is in the middle of the buffer, the corners are empty
+		CHECK(culler.depth(128, 64) < 1.0f);
+		CHECK(culler.depth(0, 0) == 1.0f && culler.depth(255, 127) == 1.0f);
+
+		// behind the wall
+		CHECK(!culler.isVisible(make_box({ 0.0f, 0.0f, -20.0f }, 1.0f)));
+		CHECK(!culler.isVisible(make_box({ 1.0f, -1.0f, -50.0f }, 3.0f)));
+
+		// beside it, partly beside it, in front of it, and crossing the near plane
+		CHECK(culler.isVisible(make_box({ 15.0f, 0.0f, -20.0f }, 1.0f)));
+		CHECK(culler.isVisible(make_box({ 9.0f, 0.0f, -20.0f }, 1.0f)));
+		CHECK(culler.isVisible(make_box({ 0.0f, 0.0f, -5.0f }, 1.0f)));
+		CHECK(culler.isVisible(make_box({ 0.0f, 0.0f, 0.0f }, 1.0f)));
+
+		// intersecting the wall
+		CHECK(culler.isVisible(make_box({ 0.0f, 0.0f, -10.0f }, 1.0f)));
+
+		// the buffer is cleared by the next render
+		culler.render({ }, viewProj);
+		CHECK(culler.triangleCount() == 0);
+		CHECK(culler.isVisible(make_box({ 0.0f, 0.0f, -20.0f }, 1.0f)));
+	}
+
+	void wall_behind_camera()
+	{
+		glm::mat4 viewProj = glm::perspective(glm::radians(60.0f), 2.0f, 0.1f, 100.0f);
+
+		// the same wall behind the camera hides nothing
+		std::vector<glm::vec3> positions = {
+			{ -4.0f, -4.0f, 10.0f }, { 4.0f, -4.0f, 10.0f }, { 4.0f, 4.0f, 10.0f }, { -4.0f, 4.0f, 10.0f }
+		};
+		std::vector<std::uint32_t> indices = { 0, 1, 2, 0, 2, 3 };
+
+		OcclusionCuller culler(256, 128);
+		culler.render({ { glm::mat4(1.0f), &positions, &indices } }, viewProj);
+
+		CHECK(culler.isVisible(make_box({ 0.0f, 0.0f, -20.0f }, 1.0f)));
+		CHECK(culler.depth(128, 64) == 1.0f);
+	}
+}
+
+int main()
+{
+	wall();
+	wall_behind_camera();
+
+	return check::failures();
+}
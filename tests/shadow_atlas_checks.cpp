@@ -0,0 +1,169 @@
+#include "check.hpp"
+
+#include "graphics/ShadowAtlas.hpp"
+
+#include <vector>
+
+namespace
+{
+	// only used as keys
+	const Light* const light_a = reinterpret_cast<const Light*>(0x10);
+	const Light* const light_b = reinterpret_cast<const Light*>(0x20);
+
+	// left and right half of a 20x10 area in front of the origin, looking down -z
+	const glm::mat4 g_left = glm::ortho(-10.0f, 0.0f, -5.0f, 5.0f, 0.0f, 20.0f);
+	const glm::mat4 g_right = glm::ortho(0.0f, 10.0f, -5.0f, 5.0f, 0.0f, 20.0f);
+
+	ShadowAtlas::caster make_caster(const glm::vec3& center, std::size_t state)
+	{
+		return { { center, glm::vec3(1.0f), glm::mat3(1.0f) }, state };
+	}
+
+	ShadowAtlas::light_views two_views(const Light* light)
+	{
+		ShadowAtlas::light_views views;
+		views.light = light;
+		views.count = 2;
+		views.viewProj[0] = g_left;
+		views.viewProj[1] = g_right;
+		return views;
+	}
+
+	ShadowAtlas::light_views one_view(const Light* light)
+	{
+		ShadowAtlas::light_views views;
+		views.light = light;
+		views.count = 1;
+		views.viewProj[0] = g_left;
+		return views;
+	}
+
+	void static_casters()
+	{
+		ShadowAtlas atlas(1024, 256);
+		std::vector<ShadowAtlas::light_views> lights = { two_views(light_a) };
+		std::vector<ShadowAtlas::caster> casters = { make_caster({ -5.0f, 0.0f, -5.0f }, 1), make_caster({ 5.0f, 0.0f, -5.0f }, 2) };
+
+		atlas.update(lights, casters);
+		CHECK(atlas.viewCount() == 2);
+		CHECK(atlas.dirtyViews().size() == 2);
+		CHECK(atlas.dirtyViews()[0].casters == std::vector<std::size_t>{ 0 });
+		CHECK(atlas.dirtyViews()[1].casters == std::vector<std::size_t>{ 1 });
+
+		// nothing changed
+		atlas.update(lights, casters);
+		CHECK(atlas.viewCount() == 2);
+		CHECK(atlas.dirtyViews().empty());
+
+		atlas.invalidate();
+		atlas.update(lights, casters);
+		CHECK(atlas.dirtyViews().size() == 2);
+	}
+
+	void moving_caster()
+	{
+		ShadowAtlas atlas(1024, 256);
+		std::vector<ShadowAtlas::light_views> lights = { two_views(light_a) };
+		std::vector<ShadowAtlas::caster> casters = { make_caster({ -5.0f, 0.0f, -5.0f }, 1), make_caster({ 5.0f, 0.0f, -5.0f }, 2) };
+		atlas.update(lights, casters);
+
+		const std::vector<unsigned int>* tiles = atlas.tiles(light_a);
+		CHECK(tiles && tiles->size() == 2);
+		if (!tiles || tiles->size() != 2) return;
+		glm::ivec4 rightRect = atlas.tileRect((*tiles)[1]);
+
+		// the right caster moves inside the right view
+		casters[1] = make_caster({ 6.0f, 0.0f, -5.0f }, 3);
+		atlas.update(lights, casters);
+		CHECK(atlas.dirtyViews().size() == 1);
+		CHECK(atlas.dirtyViews().size() == 1 && atlas.dirtyViews()[0].rect == rightRect);
+
+		// a caster crossing the border is in both views
+		casters[1] = make_caster({ 0.0f, 0.0f, -5.0f }, 4);
+		atlas.update(lights, casters);
+		CHECK(atlas.dirtyViews().size() == 2);
+		for (const ShadowAtlas::dirty_view& view : atlas.dirtyViews()) {
+			CHECK(view.casters.back() == 1);
+		}
+
+		// moving the camera of a view dirties it without any caster changing
+		lights[0].viewProj[0] = glm::ortho(-11.0f, -1.0f, -5.0f, 5.0f, 0.0f, 20.0f);
+		atlas.update(lights, casters);
+		CHECK(atlas.dirtyViews().size() == 1);
+	}
+
+	void overflow()
+	{
+		// four tiles, the first light takes two of them
+		ShadowAtlas atlas(512, 256);
+		CHECK(atlas.tileCount() == 4);
+
+		ShadowAtlas::light_views b = two_views(light_b);
+		b.count = 3;
+		std::vector<ShadowAtlas::light_views> lights = { two_views(light_a), b };
+		std::vector<ShadowAtlas::caster> casters = { make_caster({ -5.0f, 0.0f, -5.0f }, 1) };
+
+		atlas.update(lights, casters);
+		CHECK(atlas.tiles(light_a) != nullptr);
+		CHECK(atlas.tiles(light_b) == nullptr);
+		CHECK(atlas.viewCount() == 2);
+		CHECK(atlas.dirtyViews().size() == 2);
+
+		// the second light gets its tiles once the first one is gone
+		lights.erase(lights.begin());
+		atlas.update(lights, casters);
+		CHECK(atlas.tiles(light_a) == nullptr);
+		CHECK(atlas.tiles(light_b) != nullptr && atlas.tiles(light_b)->size() == 3);
+		CHECK(atlas.viewCount() == 3);
+	}
+
+	void view_count_change()
+	{
+		// a spot light turned into a directional light with four cascades
+		ShadowAtlas atlas(512, 256);
+		std::vector<ShadowAtlas::light_views> lights = { one_view(light_a), one_view(light_b) };
+		std::vector<ShadowAtlas::caster> casters = { make_caster({ -5.0f, 0.0f, -5.0f }, 1) };
+		atlas.update(lights, casters);
+		CHECK(atlas.tiles(light_a) && atlas.tiles(light_a)->size() == 1);
+
+		lights[0] = two_views(light_a);
+		lights[0].count = 3;
+		atlas.update(lights, casters);
+		CHECK(atlas.tiles(light_a) && atlas.tiles(light_a)->size() == 3);
+		CHECK(atlas.viewCount() == 4);
+		CHECK(atlas.dirtyViews().size() == 3);
+
+		// the tiles of both lights don't overlap
+		const std::vector<unsigned int>* ta = atlas.tiles(light_a);
+		const std::vector<unsigned int>* tb = atlas.tiles(light_b);
+		CHECK(ta && tb);
+		if (ta && tb) {
+			for (unsigned int i : *ta) {
+				CHECK(i != (*tb)[0]);
+			}
+		}
+
+		// one view more than there are tiles left
+		lights[0].count = 4;
+		atlas.update(lights, casters);
+		CHECK(atlas.tiles(light_a) == nullptr);
+		CHECK(atlas.tiles(light_b) != nullptr);
+		CHECK(atlas.viewCount() == 1);
+
+		// and back to a single view
+		lights[0] = one_view(light_a);
+		atlas.update(lights, casters);
+		CHECK(atlas.tiles(light_a) && atlas.tiles(light_a)->size() == 1);
+		CHECK(atlas.viewCount() == 2);
+	}
+}
+
+int main()
+{
+	static_casters();
+	moving_caster();
+	overflow();
+	view_count_change();
+
+	return check::failures();
+}
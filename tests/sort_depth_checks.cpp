@@ -0,0 +1,90 @@
+#include "check.hpp"
+
+#include "util/sort_depth.hpp"
+
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+	const float nearPlane = 0.1f, farPlane = 100.0f;
+	const unsigned int buckets = 8;
+
+	struct job
+	{
+		int priority;
+		unsigned int depth;
+		float viewDepth;
+	};
+
+	// same order as the render queues: priority first, then the depth key
+	std::vector<job> sorted_jobs(const std::vector<float>& viewDepths, int priority, bool transparent)
+	{
+		std::vector<job> jobs;
+		for (float d : viewDepths) {
+			jobs.push_back({ priority, sort_depth(d, nearPlane, farPlane, buckets, transparent), d });
+		}
+
+		std::stable_sort(jobs.begin(), jobs.end(), [](const job& a, const job& b) {
+			return std::tie(a.priority, a.depth) < std::tie(b.priority, b.depth);
+		});
+		return jobs;
+	}
+
+	// shuffled, all within the clip range
+	const std::vector<float> viewDepths = { 25.0f, 0.2f, 99.0f, 3.0f, 0.1f, 60.0f, 1.0f, 0.5f, 10.0f, 100.0f, 1.01f, 45.0f };
+
+	void opaque()
+	{
+		std::vector<job> jobs = sorted_jobs(viewDepths, 0, false);
+
+		// front to back by bucket
+		for (std::size_t i = 1; i < jobs.size(); ++i) {
+			CHECK(jobs[i - 1].viewDepth <= jobs[i].viewDepth || jobs[i - 1].depth == jobs[i].depth);
+			CHECK(jobs[i].depth < buckets);
+		}
+
+		CHECK(jobs.front().depth == 0);
+		CHECK(jobs.back().depth == buckets - 1);
+		CHECK(sort_depth(0.5f, nearPlane, farPlane, buckets, false) < sort_depth(50.0f, nearPlane, farPlane, buckets, false));
+
+		// outside the clip range
+		CHECK(sort_depth(0.01f, nearPlane, farPlane, buckets, false) == 0);
+		CHECK(sort_depth(-5.0f, nearPlane, farPlane, buckets, false) == 0);
+		CHECK(sort_depth(1000.0f, nearPlane, farPlane, buckets, false) == buckets - 1);
+		CHECK(sort_depth(1000.0f, nearPlane, farPlane, 0, false) == 0);
+
+		// priority comes first
+		job nearLate{ 1, sort_depth(0.2f, nearPlane, farPlane, buckets, false), 0.2f };
+		job farEarly{ 0, sort_depth(90.0f, nearPlane, farPlane, buckets, false), 90.0f };
+		CHECK(std::tie(farEarly.priority, farEarly.depth) < std::tie(nearLate.priority, nearLate.depth));
+	}
+
+	void transparent()
+	{
+		std::vector<job> jobs = sorted_jobs(viewDepths, 0, true);
+
+		// strictly back to front, no two distinct depths share a key
+		for (std::size_t i = 1; i < jobs.size(); ++i) {
+			CHECK(jobs[i - 1].viewDepth > jobs[i].viewDepth);
+			CHECK(jobs[i - 1].depth < jobs[i].depth);
+		}
+
+		CHECK(sort_depth(farPlane, nearPlane, farPlane, buckets, true) == 0);
+		CHECK(sort_depth(nearPlane, nearPlane, farPlane, buckets, true) == sort_depth_max);
+		CHECK(sort_depth(1000.0f, nearPlane, farPlane, buckets, true) == 0);
+		CHECK(sort_depth(0.01f, nearPlane, farPlane, buckets, true) == sort_depth_max);
+
+		// close objects in front of each other
+		CHECK(sort_depth(1.0f, nearPlane, farPlane, buckets, true) > sort_depth(1.001f, nearPlane, farPlane, buckets, true));
+	}
+}
+
+int main()
+{
+	opaque();
+	transparent();
+
+	return check::failures();
+}
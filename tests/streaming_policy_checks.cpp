@@ -0,0 +1,161 @@
+#include "check.hpp"
+
+#include "graphics/texture/StreamingPolicy.hpp"
+
+#include <vector>
+
+namespace
+{
+	using texture_id = StreamingPolicy::texture_id;
+
+	bool has_change(const std::vector<StreamingPolicy::change>& changes, texture_id id, std::size_t level)
+	{
+		for (auto& c : changes) {
+			if (c.id == id && c.level == level)
+				return true;
+		}
+		return false;
+	}
+
+	void budget_grants()
+	{
+		// 5 bytes pinned each, the next finer level costs 16
+		StreamingPolicy policy(10 + 16, 60);
+		texture_id a = policy.add({ 64, 16, 4, 1 }, 2);
+		texture_id b = policy.add({ 64, 16, 4, 1 }, 2);
+
+		// a misses two levels and b one, only one level fits
+		policy.request(a, 0);
+		policy.request(b, 1);
+		const auto& changes = policy.update();
+
+		CHECK(policy.targetLevel(a) == 1);
+		CHECK(policy.targetLevel(b) == 2);
+		CHECK(changes.size() == 1 && has_change(changes, a, 1));
+		CHECK(policy.targetBytes() == 26 && policy.targetBytes() <= policy.budget());
+		CHECK(policy.requestedBytes() == 85 + 21);
+
+		// nothing is resident before the load has finished
+		CHECK(policy.residentLevel(a) == 2);
+		CHECK(policy.residentBytes() == 10);
+
+		policy.setResidentLevel(a, 1);
+		CHECK(policy.residentBytes() == 26);
+
+		// the same requests again: no new changes
+		policy.request(a, 0);
+		policy.request(b, 1);
+		CHECK(policy.update().empty());
+
+		// finer requests during a frame win
+		policy.setBudget(1000);
+		policy.request(b, 2);
+		policy.request(b, 0);
+		policy.request(a, 0);
+		policy.update();
+		CHECK(policy.targetLevel(a) == 0 && policy.targetLevel(b) == 0);
+	}
+
+	void pinned_levels()
+	{
+		// the pinned levels alone are over budget
+		StreamingPolicy policy(4, 1);
+		texture_id a = policy.add({ 64, 16, 4, 1 }, 2);
+		texture_id b = policy.add({ 64, 16, 4, 1 }, 1);
+
+		for (int frame = 0; frame < 5; ++frame) {
+			policy.request(a, 0);
+			policy.request(b, 0);
+			const auto& changes = policy.update();
+
+			CHECK(changes.empty());
+			CHECK(policy.targetLevel(a) == 2 && policy.targetLevel(b) == 1);
+		}
+
+		// resident levels never go past the pinned one
+		policy.setResidentLevel(a, 3);
+		CHECK(policy.residentLevel(a) == 2);
+
+		// pinned levels beyond the last one are clamped
+		texture_id c = policy.add({ 64, 16 }, 5);
+		CHECK(policy.residentLevel(c) == 1);
+	}
+
+	void eviction_order()
+	{
+		// 4 bytes pinned each, room for two level 0s
+		StreamingPolicy policy(12 + 32, 2);
+		texture_id c = policy.add({ 16, 4 }, 1);
+		texture_id a = policy.add({ 16, 4 }, 1);
+		texture_id b = policy.add({ 16, 4 }, 1);
+
+		// frame 0
+		policy.request(a, 0);
+		policy.request(b, 0);
+		auto changes = policy.update();
+		CHECK(changes.size() == 2 && has_change(changes, a, 0) && has_change(changes, b, 0));
+		policy.setResidentLevel(a, 0);
+		policy.setResidentLevel(b, 0);
+
+		// frame 1: a is used more recently than b
+		policy.request(a, 0);
+		CHECK(policy.update().empty());
+
+		// frames 2 to 4: neither is requested any more, but both stay resident while nothing else needs the memory
+		for (int frame = 2; frame <= 4; ++frame) {
+			CHECK(policy.update().empty());
+		}
+		CHECK(policy.targetLevel(a) == 0 && policy.targetLevel(b) == 0);
+
+		// frame 5: c needs the memory of one of them, the least recently used one goes
+		policy.request(c, 0);
+		changes = policy.update();
+
+		CHECK(changes.size() == 2);
+		if (changes.size() == 2) {
+			// evictions come first, they free the memory for the loads
+			CHECK(changes[0].id == b && changes[0].level == 1);
+			CHECK(changes[1].id == c && changes[1].level == 0);
+		}
+		CHECK(policy.targetLevel(a) == 0);
+	}
+
+	void load_order()
+	{
+		StreamingPolicy policy(1000, 60);
+		texture_id a = policy.add({ 64, 16, 4, 1 }, 3);
+		texture_id b = policy.add({ 64, 16, 4, 1 }, 3);
+
+		// loads missing more levels first
+		policy.request(a, 2);
+		policy.request(b, 0);
+		const auto& changes = policy.update();
+
+		CHECK(changes.size() == 2);
+		if (changes.size() == 2) {
+			CHECK(changes[0].id == b && changes[0].level == 0);
+			CHECK(changes[1].id == a && changes[1].level == 2);
+		}
+	}
+
+	void required_levels()
+	{
+		CHECK(StreamingPolicy::requiredLevel(0.0f) == 0);
+		CHECK(StreamingPolicy::requiredLevel(0.5f) == 0);
+		CHECK(StreamingPolicy::requiredLevel(1.0f) == 0);
+		CHECK(StreamingPolicy::requiredLevel(2.0f) == 1);
+		CHECK(StreamingPolicy::requiredLevel(3.0f) == 1);
+		CHECK(StreamingPolicy::requiredLevel(4.0f) == 2);
+	}
+}
+
+int main()
+{
+	budget_grants();
+	pinned_levels();
+	eviction_order();
+	load_order();
+	required_levels();
+
+	return check::failures();
+}
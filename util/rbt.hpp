@@ -36,6 +36,9 @@ struct rbt_info
 	unsigned int width;
 	unsigned int height;
 	rbt_params params;
+	// number of mip levels in the data stream, finest first, each preceded by its size in bytes (std::size_t)
+	// 0 in older files: the stream is only the base level, mipmaps are generated when loading
+	unsigned int levels;
 };
 
 #endif // RBT_HPP
\ No newline at end of file
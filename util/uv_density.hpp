@@ -0,0 +1,38 @@
+#ifndef UV_DENSITY_HPP
+#define UV_DENSITY_HPP
+
+#include <cmath>
+#include <cstddef>
+
+// UV units per unit of object space, averaged over the area of a triangle list
+// (a texture of size s is stretched over 1 / (density * s) units per texel). 0 if there is no area to measure.
+// P and U only need x, y (and z) members, so this works for both the engine's and assimp's vector types.
+template<typename P, typename U, typename I>
+float compute_uv_density(const P* positions, const U* uvs, const I* indices, std::size_t indexCount)
+{
+	double posArea = 0.0, uvArea = 0.0;
+
+	for (std::size_t i = 0; i + 2 < indexCount; i += 3) {
+		const P& p0 = positions[indices[i]];
+		const P& p1 = positions[indices[i + 1]];
+		const P& p2 = positions[indices[i + 2]];
+
+		double ax = p1.x - p0.x, ay = p1.y - p0.y, az = p1.z - p0.z;
+		double bx = p2.x - p0.x, by = p2.y - p0.y, bz = p2.z - p0.z;
+		double cx = ay * bz - az * by, cy = az * bx - ax * bz, cz = ax * by - ay * bx;
+		posArea += 0.5 * std::sqrt(cx * cx + cy * cy + cz * cz);
+
+		const U& t0 = uvs[indices[i]];
+		const U& t1 = uvs[indices[i + 1]];
+		const U& t2 = uvs[indices[i + 2]];
+
+		uvArea += 0.5 * std::abs((t1.x - t0.x) * (t2.y - t0.y) - (t2.x - t0.x) * (t1.y - t0.y));
+	}
+
+	if (posArea <= 0.0 || uvArea <= 0.0)
+		return 0.0f;
+
+	return float(std::sqrt(uvArea / posArea));
+}
+
+#endif // UV_DENSITY_HPP